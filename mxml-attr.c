@@ -41,8 +41,8 @@ void mxmlElementClearAttr(mxml_node_t *node, const char *name)
         if (!strcmp(attr->name, name))
         {
             // 删除此属性...
-            _mxml_strfree(attr->name);
-            _mxml_strfree(attr->value);
+            _mxml_node_namefree(node, attr->name);
+            _mxml_node_strfree(node, attr->value);
 
             i--;
             if (i > 0)
@@ -51,7 +51,12 @@ void mxmlElementClearAttr(mxml_node_t *node, const char *name)
             node->value.element.num_attrs--;
 
             if (node->value.element.num_attrs == 0)
-                free(node->value.element.attrs);
+            {
+                if (!node->doc || !node->doc->arena)
+                    free(node->value.element.attrs);
+
+                node->value.element.attrs = NULL;
+            }
             return;
         }
     }
@@ -93,6 +98,34 @@ const char * mxmlElementGetAttr(mxml_node_t *node, const char *name)
 }
 
 
+//
+// 'mxmlElementGetAttrAtom（）' - 通过原子获取属性的值。
+//
+// 此函数从元素`node`中获取属性原子`name`的值。`name`必须是@link mxmlGetAtom@返回的原子。对于使用@link mxmlOptionsSetInternNames@加载的节点，只比较指针而不比较字符串。如果节点不是元素或指定的属性不存在，则返回`NULL`。
+
+const char * mxmlElementGetAttrAtom(mxml_node_t *node, const char *name)
+{
+    size_t i; // 循环变量
+    _mxml_attr_t *attr; // 当前属性
+
+    MXML_DEBUG("mxmlElementGetAttrAtom（node = %p，name = \"%s\"）\n", node, name ? name : "(null)");
+
+    // 范围检查输入...
+    if (!node || node->type != MXML_TYPE_ELEMENT || !name)
+        return NULL;
+
+    // 查找属性...
+    for (i = node->value.element.num_attrs, attr = node->value.element.attrs; i > 0; i--, attr++)
+    {
+        if (_mxml_node_nameeq(node, attr->name, name))
+            return attr->value;
+    }
+
+    // 未找到属性，因此返回NULL...
+    return NULL;
+}
+
+
 //
 // 'mxmlElementGetAttrByIndex（）' - 按索引获取属性。
 //
@@ -147,7 +180,7 @@ void mxmlElementSetAttr(mxml_node_t *node, const char *name, const char *value)
 
     if (value)
     {
-        if ((valuec = _mxml_strcopy(value)) == NULL)
+        if ((valuec = _mxml_node_strcopy(node, value)) == NULL)
             return;
     }
     else
@@ -156,7 +189,7 @@ void mxmlElementSetAttr(mxml_node_t *node, const char *name, const char *value)
     }
 
     if (!mxml_set_attr(node, name, valuec))
-        _mxml_strfree(valuec);
+        _mxml_node_strfree(node, valuec);
 }
 
 
@@ -182,10 +215,10 @@ void mxmlElementSetAttrf(mxml_node_t *node, const char *name, const char *format
     vsnprintf(buffer, sizeof(buffer), format, ap);
     va_end(ap);
 
-    if ((value = _mxml_strcopy(buffer)) != NULL)
+    if ((value = _mxml_node_strcopy(node, buffer)) != NULL)
     {
         if (!mxml_set_attr(node, name, value))
-            _mxml_strfree(value);
+            _mxml_node_strfree(node, value);
     }
 }
 
@@ -199,6 +232,7 @@ mxml_set_attr(mxml_node_t *node, const char *name, char *value) // I - 元素节
 {
     int i; // 循环变量
     _mxml_attr_t *attr; // 新属性
+    size_t num_attrs = node->value.element.num_attrs; // 属性数量
 
     // 查找属性...
     for (i = node->value.element.num_attrs, attr = node->value.element.attrs; i > 0; i--, attr++)
@@ -206,7 +240,7 @@ mxml_set_attr(mxml_node_t *node, const char *name, char *value) // I - 元素节
         if (!strcmp(attr->name, name))
         {
             // 根据需要释放旧值...
-            _mxml_strfree(attr->value);
+            _mxml_node_strfree(node, attr->value);
             attr->value = value;
 
             return true;
@@ -214,13 +248,31 @@ mxml_set_attr(mxml_node_t *node, const char *name, char *value) // I - 元素节
     }
 
     // 添加新属性...
-    if ((attr = realloc(node->value.element.attrs, (node->value.element.num_attrs + 1) * sizeof(_mxml_attr_t))) == NULL)
-        return false;
+    if (node->doc && node->doc->arena)
+    {
+        // 内存池中的数组无法扩展，按2的幂分配容量，数量为0或达到容量时复制到新数组...
+        if (num_attrs == 0 || (num_attrs >= 4 && !(num_attrs & (num_attrs - 1))))
+        {
+            if ((attr = _mxml_doc_alloc(node->doc, (num_attrs ? 2 * num_attrs : 4) * sizeof(_mxml_attr_t))) == NULL)
+                return false;
+
+            if (num_attrs)
+                memcpy(attr, node->value.element.attrs, num_attrs * sizeof(_mxml_attr_t));
+
+            node->value.element.attrs = attr;
+        }
+    }
+    else
+    {
+        if ((attr = realloc(node->value.element.attrs, (num_attrs + 1) * sizeof(_mxml_attr_t))) == NULL)
+            return false;
+
+        node->value.element.attrs = attr;
+    }
 
-    node->value.element.attrs = attr;
-    attr += node->value.element.num_attrs;
+    attr = node->value.element.attrs + num_attrs;
 
-    if ((attr->name = _mxml_strcopy(name)) == NULL)
+    if ((attr->name = _mxml_node_namecopy(node, name)) == NULL)
         return false;
 
     attr->value = value;
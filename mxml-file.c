@@ -11,758 +11,2621 @@
 #  include <unistd.h>
 #endif // !_WIN32
 #include "mxml-private.h"
+#include <fcntl.h>
+#ifdef HAVE_SYS_MMAN_H
+#  include <sys/mman.h>
+#  include <sys/stat.h>
+#endif // HAVE_SYS_MMAN_H
+#ifdef HAVE_PTHREAD_H
+#  include <pthread.h>
+#endif // HAVE_PTHREAD_H
+#ifndef O_BINARY
+#  define O_BINARY 0
+#endif // !O_BINARY
+// 定义`MXML_NO_SIMD`（`configure --disable-simd`）使用逐字节扫描，定义`MXML_NO_AVX2`只使用SSE2，
+// 以便在支持AVX2的CPU上测试其他实现...
+#if !defined(MXML_NO_SIMD) && (defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2))
+#  include <emmintrin.h>
+#  define MXML_SCAN_SSE2	1	// 使用SSE2扫描普通字符
+#  if !defined(MXML_NO_AVX2) && defined(__GNUC__) && (defined(__AVX2__) || __GNUC__ >= 5 || defined(__clang__))
+#    include <immintrin.h>
+#    define MXML_SCAN_AVX2	1	// 使用AVX2扫描普通字符（运行时检测CPU）
+#  endif // !MXML_NO_AVX2 && __GNUC__
+#endif // !MXML_NO_SIMD && (__SSE2__ || _M_X64 || _M_IX86_FP)
+#define MXML_PART_MIN		262144	// 并行加载时每段数据的最小字节数
+#define MXML_PART_NODES		1024	// 并行保存时每段的最大子节点数
+#define MXML_WRITEV_MIN		4096	// 引用（而不复制）的字符串的最小字节数
 
 
 //
 // 本地类型...
 //
 
-typedef enum _mxml_encoding_e        // 字符编码
-{
-  _MXML_ENCODING_UTF8,            // UTF-8
-  _MXML_ENCODING_UTF16BE,        // UTF-16大端
-  _MXML_ENCODING_UTF16LE        // UTF-16小端
-} _mxml_encoding_t;
-
 typedef struct _mxml_stringbuf_s    // 字符串缓冲区
 {
   char        *buffer,        // 缓冲区
         *bufptr;        // 指向缓冲区的指针
   size_t    bufsize;        // 缓冲区大小
   bool        bufalloc;        // 是否分配缓冲区？
+  size_t	overflow;		// 固定大小的缓冲区放不下的字节数
 } _mxml_stringbuf_t;
 
+typedef struct _mxml_load_s		// 可恢复的加载状态
+{
+  bool			started,	// 是否已经开始加载？
+			final,		// 是否是最后一段数据？
+			error;		// 是否遇到错误？
+  mxml_node_t		*first,		// 添加的第一个节点
+			*parent;	// 当前父节点
+  int			line;		// 当前行号
+  size_t		depth,		// 打开的元素数
+			keep_depth;	// 加载整个元素的投影元素的深度或0
+  bool			whitespace;	// 是否遇到空白字符？
+  mxml_type_t		type;		// 当前节点类型
+} _mxml_load_t;
+
+typedef struct _mxml_part_s		// 并行加载的一段数据
+{
+  mxml_options_t	options;	// 选项（错误回调函数只记录错误）
+  _mxml_global_t	*global;	// 调用者的全局数据（字符串回调函数）
+  const char		*start;		// 数据的开头
+  size_t		bytes;		// 数据的字节数
+  mxml_node_t		*top,		// 根元素的副本
+			*ret;		// 加载的结果
+  bool			error;		// 是否遇到错误？
+#ifdef HAVE_PTHREAD_H
+  bool			started;	// 是否在线程中加载？
+  pthread_t		thread;		// 加载的线程
+#endif // HAVE_PTHREAD_H
+} _mxml_part_t;
+
+#ifdef HAVE_PTHREAD_H
+typedef struct _mxml_save_part_s	// 并行保存的一段子节点
+{
+  _mxml_stringbuf_t	sb;		// 写入的数据
+  int			col;		// 写入之后的列数，错误时为`-1`
+  bool			done;		// 是否已经写入？
+} _mxml_save_part_t;
+
+typedef struct _mxml_save_s		// 并行保存的状态
+{
+  mxml_options_t	*options;	// 选项
+  mxml_node_t		*parent,	// 子节点并行写入的元素
+			*next;		// 下一段的第一个子节点，`NULL`表示已经全部分配
+  int			depth;		// 子节点的缩进级别
+  size_t		run,		// 每段的最小子节点数
+			window,		// 同时写入的最大段数
+			assigned,	// 已经分配给线程的段数
+			written;	// 已经输出的段数
+  _mxml_save_part_t	*parts;		// 正在写入的段（循环使用）
+  bool			error;		// 是否遇到错误？
+  pthread_mutex_t	mutex;		// 互斥锁
+  pthread_cond_t	cond;		// 段完成或输出时的条件变量
+} _mxml_save_t;
+#endif // HAVE_PTHREAD_H
+
+typedef enum _mxml_project_e		// 元素与投影路径的匹配结果
+{
+  _MXML_PROJECT_NONE,			// 不在任何路径上，跳过元素
+  _MXML_PROJECT_PATH,			// 路径上的祖先元素，只加载路径上的子元素
+  _MXML_PROJECT_ALL			// 与路径匹配，加载整个元素
+} _mxml_project_t;
+
+typedef struct _mxml_records_s		// 逐个记录加载的状态
+{
+  mxml_options_t	*options;	// 调用者的选项或`NULL`
+  const char		*name;		// 记录元素的名称或`NULL`
+  mxml_record_cb_t	record_cb;	// 记录回调函数
+  void			*record_cbdata;	// 记录回调数据
+  bool			arena,		// 记录是否使用内存池？
+			intern,		// 是否驻留元素和属性名称？
+			error;		// 是否遇到错误？
+  size_t		depth;		// 打开的元素数
+  mxml_node_t		*record,	// 当前记录或`NULL`
+			*last,		// 最后一个记录或`NULL`
+			*stopped;	// 停止加载的记录或`NULL`
+  _mxml_doc_t		*doc,		// 当前记录的文档（内存池）或`NULL`
+			*olddoc;	// 记录之外的节点所属的文档
+} _mxml_records_t;
+
+typedef enum _mxml_scan_e		// 推送解析器的标记扫描状态
+{
+  _MXML_SCAN_TEXT,			// 字符数据
+  _MXML_SCAN_MARKUP,			// "<"之后，尚未确定标记类型
+  _MXML_SCAN_ELEMENT,			// 元素的开/闭标签
+  _MXML_SCAN_COMMENT,			// 注释
+  _MXML_SCAN_CDATA,			// CDATA
+  _MXML_SCAN_DIRECTIVE,			// 处理指令
+  _MXML_SCAN_DECLARATION		// 声明
+} _mxml_scan_t;
+
+struct _mxml_parser_s			// 推送解析器
+{
+  mxml_node_t		*top;		// 顶级节点
+  mxml_options_t	*options;	// 选项
+  _mxml_doc_t		*doc;		// 加载的节点所属的文档或`NULL`
+  _mxml_load_t		ld;		// 加载状态
+  _mxml_encoding_t	encoding;	// 字符编码
+  unsigned char		*buffer;	// 尚未加载的数据
+  size_t		bufused,	// 缓冲区中的字节数
+			bufsize,	// 缓冲区大小
+			scanned,	// 已扫描的字节数
+			complete;	// 最后一个完整标记之前的字节数
+  _mxml_scan_t		state;		// 扫描状态
+  int			quote,		// 元素中的引号字符或0
+			prev;		// 元素中的上一个字符
+  char			markup[8];	// 标记的前缀
+  size_t		markuplen;	// 标记的长度
+};
+
+struct _mxml_context_s			// 可重复使用的加载上下文
+{
+  mxml_options_t	*options,	// 选项
+			*defoptions;	// 默认选项或`NULL`
+  _mxml_doc_t		*doc;		// 加载的节点所属的文档（内存池）或`NULL`
+  size_t		num_heaps;	// 空闲的令牌缓冲区数量
+  char			*heaps[3];	// 空闲的令牌缓冲区
+  size_t		heapsizes[3];	// 令牌缓冲区的大小
+};
+
+typedef struct _mxml_token_s		// 令牌缓冲区
+{
+  char			*buffer,	// 令牌的开头
+			*bufptr,	// 令牌中的当前位置
+			*heap;		// 分配的缓冲区
+  size_t		bufsize;	// 分配的缓冲区大小
+  _mxml_read_t		*r;		// 原位解码时的输入缓冲区，否则为`NULL`
+  mxml_context_t	*context;	// 释放时收回缓冲区的加载上下文或`NULL`
+} _mxml_token_t;
+
 
 //
-// 宏用于检测不良的XML字符...
+// 宏...
 //
 
-#define mxml_bad_char(ch) ((ch) < ' ' && (ch) != '\n' && (ch) != '\r' && (ch) != '\t')
+// 节点是标记（元素、注释、声明或处理指令）而不是数据吗？
+#define mxml_is_markup(node) ((node)->type == MXML_TYPE_COMMENT || (node)->type == MXML_TYPE_DECLARATION || (node)->type == MXML_TYPE_DIRECTIVE || (node)->type == MXML_TYPE_ELEMENT)
 
 
 //
 // 本地函数...
 //
 
-static bool        mxml_add_char(mxml_options_t *options, int ch, char **ptr, char **buffer, size_t *bufsize);
-static int        mxml_get_entity(mxml_options_t *options, mxml_io_cb_t io_cb, void *io_cbdata, _mxml_encoding_t *encoding, mxml_node_t *parent, int *line);
-static int        mxml_getc(mxml_options_t *options, mxml_io_cb_t io_cb, void *io_cbdata, _mxml_encoding_t *encoding);
-static inline int    mxml_isspace(int ch)
-            {
-              return (ch == ' ' || ch == '\t' || ch == '\r' || ch == '\n');
-            }
-static mxml_node_t    *mxml_load_data(mxml_node_t *top, mxml_options_t *options, mxml_io_cb_t io_cb, void *io_cbdata);
-static int        mxml_parse_element(mxml_options_t *options, mxml_io_cb_t io_cb, void *io_cbdata, mxml_node_t *node, _mxml_encoding_t *encoding, int *line);
+static bool        mxml_add_char(mxml_options_t *options, _mxml_token_t *tok, int ch);
+static bool        mxml_add_run(mxml_options_t *options, _mxml_token_t *tok, _mxml_read_t *r, int d1, int d2, int d3);
+static mxml_node_t    *mxml_context_load(mxml_context_t *context, mxml_node_t *top, _mxml_read_t *r);
+static bool        mxml_lazy_skip(mxml_options_t *options, _mxml_read_t *r, mxml_node_t *node, int *line);
+static mxml_node_t    *mxml_load_data(mxml_node_t *top, mxml_options_t *options, _mxml_read_t *r, _mxml_load_t *ld);
+static mxml_node_t    *mxml_load_doc(mxml_node_t *top, mxml_options_t *options, _mxml_read_t *r, char *buf, size_t len);
+static _mxml_doc_t    *mxml_load_newdoc(mxml_options_t *options, char *buf, size_t len);
+static void        *mxml_load_part(_mxml_part_t *part);
+static void        mxml_load_part_error(bool *error, const char *message);
+static const char    *mxml_load_root(const char *s, const char *end, const char **name, size_t *namelen);
+static const char    *mxml_load_split(const char *s, const char *end, const char *name, size_t namelen);
+static mxml_node_t    *mxml_parser_load(mxml_parser_t *parser);
+static void        mxml_parser_scan(mxml_parser_t *parser);
+static int        mxml_parse_element(mxml_options_t *options, _mxml_read_t *r, mxml_node_t *node, _mxml_token_t *name, _mxml_token_t *value, int *line);
+static _mxml_project_t mxml_project(mxml_options_t *options, mxml_node_t *top, mxml_node_t *parent, const char *name);
+static bool        mxml_project_match(const _mxml_step_t *steps, size_t num_steps, mxml_node_t *top, mxml_node_t *parent, const char *name);
 static size_t        mxml_read_cb_fd(int *fd, void *buffer, size_t bytes);
 static size_t        mxml_read_cb_file(FILE *fp, void *buffer, size_t bytes);
-static size_t        mxml_read_cb_string(_mxml_stringbuf_t *sb, void *buffer, size_t bytes);
+static bool        mxml_read_bom(mxml_options_t *options, _mxml_read_t *r);
+static size_t        mxml_read_fill(_mxml_read_t *r, size_t bytes);
+static void        mxml_read_free(_mxml_read_t *r);
+static bool        mxml_read_init(_mxml_read_t *r, mxml_options_t *options, mxml_io_cb_t io_cb, void *io_cbdata);
+static bool        mxml_read_init_map(_mxml_read_t *r, int fd);
+static bool        mxml_read_init_utf16(mxml_options_t *options, _mxml_read_t *r, _mxml_encoding_t encoding);
+static void        mxml_records_error(_mxml_records_t *rec, const char *message);
+static bool        mxml_records_sax(_mxml_records_t *rec, mxml_node_t *node, mxml_sax_event_t event);
+#ifdef HAVE_PTHREAD_H
+static bool        mxml_save_part(_mxml_save_t *save);
+static void        *mxml_save_thread(_mxml_save_t *save);
+#endif // HAVE_PTHREAD_H
+static bool        mxml_sax_event(mxml_options_t *options, mxml_node_t *node, mxml_sax_event_t event);
+static mxml_node_t    *mxml_sax_keep(mxml_node_t *node);
+static mxml_node_t    *mxml_sax_release(mxml_node_t *node);
+static size_t        mxml_scan(const unsigned char *s, const unsigned char *end, int d1, int d2, int d3);
+#ifdef MXML_SCAN_AVX2
+static size_t        mxml_scan_avx2(const unsigned char *s, const unsigned char *end, int d1, int d2, int d3);
+#endif // MXML_SCAN_AVX2
+#ifdef MXML_SCAN_SSE2
+static size_t        mxml_scan_sse2(const unsigned char *s, const unsigned char *end, int d1, int d2, int d3);
+#endif // MXML_SCAN_SSE2
+static unsigned char    *mxml_skip(mxml_options_t *options, _mxml_read_t *r, const char *name, bool intag, bool children, int *line);
+static bool        mxml_skip_fill(_mxml_read_t *r, unsigned char **ptr, size_t bytes, int *line);
 static double        mxml_strtod(mxml_options_t *options, const char *buffer, char **bufptr);
-static size_t        mxml_io_cb_fd(int *fd, void *buffer, size_t bytes);
-static size_t        mxml_io_cb_file(FILE *fp, void *buffer, size_t bytes);
+static bool        mxml_token_end(mxml_options_t *options, _mxml_token_t *tok);
+static void        mxml_token_free(_mxml_token_t *tok);
+static bool        mxml_token_grow(mxml_options_t *options, _mxml_token_t *tok, size_t bytes);
+static bool        mxml_token_init(mxml_options_t *options, mxml_context_t *context, _mxml_token_t *tok);
+static bool        mxml_token_spill(mxml_options_t *options, _mxml_token_t *tok);
+static void        mxml_token_start(_mxml_token_t *tok, _mxml_read_t *r, int ch);
 static size_t        mxml_io_cb_string(_mxml_stringbuf_t *sb, void *buffer, size_t bytes);
-static int        mxml_write_node(mxml_node_t *node, mxml_options_t *options, mxml_io_cb_t io_cb, void *io_cbdata, int col);
-static int        mxml_write_string(const char *s, mxml_io_cb_t io_cb, void *io_cbdata, bool use_entities, int col);
-static int        mxml_write_ws(mxml_node_t *node, mxml_options_t *options, mxml_io_cb_t io_cb, void *io_cbdata, mxml_ws_t ws, int col);
+static bool        mxml_write_all(mxml_node_t *node, mxml_options_t *options, mxml_io_cb_t io_cb, void *io_cbdata, bool newline);
+static bool        mxml_write_data(_mxml_write_t *w, const char *s, size_t bytes);
+static bool        mxml_write_inline(mxml_node_t *node, mxml_indent_t indent);
+static int        mxml_write_node(mxml_node_t *node, mxml_node_t *last, mxml_options_t *options, _mxml_write_t *w, int depth, int col);
+#ifdef HAVE_PTHREAD_H
+static int        mxml_write_parts(_mxml_save_t *save, _mxml_write_t *w, int col);
+#endif // HAVE_PTHREAD_H
+static size_t        mxml_write_scan(const char *s, const char *end, bool use_entities, bool columns);
+static int        mxml_write_ws(mxml_node_t *node, mxml_options_t *options, _mxml_write_t *w, mxml_ws_t ws, int col);
 
 
 //
-// 'mxmlLoadFd（）' - 将文件描述符加载到XML节点树中。
+// 'mxmlContextDelete（）' - 释放加载上下文。
 //
-// 此函数将文件描述符`fd`加载到XML节点树中。指定文件中的节点将添加到指定节点`top`中 - 如果为`NULL`，则XML文件必须是格式良好的，以文件开头的单个父处理指令节点（例如`<?xml version =“1.0”？>）。
+// 此函数释放加载上下文`context`缓存的令牌缓冲区和内存池。使用上下文加载的节点树仍然有效，内存池在
+// 删除最后一个节点时释放。
 //
-// 加载选项通过`options`参数提供。如果为`NULL`，所有值将加载到`MXML_TYPE_TEXT`节点中。在加载XML数据时，请使用@link mxmlOptionsNew@函数创建选项。
 
-mxml_node_t *                // O - 第一个节点，如果无法读取文件，则为`NULL`。
-mxmlLoadFd(
-    mxml_node_t    *top,        // I - 顶级节点
-    mxml_options_t *options,    // I - 选项
-    int            fd)            // I - 要读取的文件描述符
+void
+mxmlContextDelete(
+    mxml_context_t *context)		// I - 加载上下文
 {
-  // 范围检查输入...
-  if (fd < 0)
-    return (NULL);
-
-  // 读取XML数据...
-  return (mxml_load_data(top, options, (mxml_io_cb_t)mxml_read_cb_fd, &fd));
-}
-
+  if (!context)
+    return;
 
-//
-// 'mxmlLoadFile（）' - 将文件加载到XML节点树中。
-//
-// 此函数将`FILE`指针`fp`加载到XML节点树中。指定文件中的节点将添加到指定节点`top`中 - 如果为`NULL`，则XML文件必须是格式良好的，以文件开头的单个父处理指令节点（例如`<?xml version =“1.0”？>）。
-//
-// 加载选项通过`options`参数提供。如果为`NULL`，所有值将加载到`MXML_TYPE_TEXT`节点中。在加载XML数据时，请使用@link mxmlOptionsNew@函数创建选项。
-
-mxml_node_t *                // O - 第一个节点，如果无法读取文件，则为`NULL`。
-mxmlLoadFile(
-    mxml_node_t    *top,        // I - 顶级节点
-    mxml_options_t *options,    // I - 选项
-    FILE           *fp)        // I - 要读取的文件
-{
-  // 范围检查输入...
-  if (!fp)
-    return (NULL);
+  mxmlContextReset(context);
+  mxmlOptionsDelete(context->defoptions);
 
-  // 读取XML数据...
-  return (mxml_load_data(top, options, (mxml_io_cb_t)mxml_read_cb_file, fp));
+  free(context);
 }
 
 
 //
-// 'mxmlLoadFilename（）' - 将文件加载到XML节点树中。
+// 'mxmlContextLoadBuffer（）' - 使用加载上下文加载缓冲区中的XML数据。
 //
-// 此函数将命名文件`filename`加载到XML节点树中。指定文件中的节点将添加到指定节点`top`中 - 如果为`NULL`，则XML文件必须是格式良好的，以文件开头的单个父处理指令节点（例如`<?xml version =“1.0”？>）。
+// 此函数与@link mxmlContextLoadString@相同，但是从缓冲区`buffer`中加载`bytes`字节的数据，数据不需要
+// 以空字符结尾，也不会被修改。
 //
-// 加载选项通过`options`参数提供。如果为`NULL`，所有值将加载到`MXML_TYPE_TEXT`节点中。在加载XML数据时，请使用@link mxmlOptionsNew@函数创建选项。
 
-mxml_node_t *                // O - 第一个节点，如果无法读取文件，则为`NULL`。
-mxmlLoadFilename(
-    mxml_node_t    *top,        // I - 顶级节点
-    mxml_options_t *options,    // I - 选项
-    const char     *filename)    // I - 要读取的文件
+mxml_node_t *				// O - 第一个节点或`NULL`（如果数据有错误）
+mxmlContextLoadBuffer(
+    mxml_context_t *context,		// I - 加载上下文
+    mxml_node_t    *top,		// I - 顶级节点
+    const void     *buffer,		// I - 数据
+    size_t         bytes)		// I - 数据的字节数
 {
-  FILE        *fp;            // 文件指针
-  mxml_node_t    *ret;            // 节点
+  _mxml_read_t	r;			// 输入缓冲区
+  mxml_node_t	*ret;			// 第一个节点
 
 
   // 范围检查输入...
-  if (!filename)
+  if (!context || !buffer)
     return (NULL);
 
-  // 打开文件...
-  if ((fp = fopen(filename, "r")) == NULL)
-    return (NULL);
+  // 直接从缓冲区中读取XML数据，无需复制...
+  _mxml_read_init_string(&r, (const char *)buffer, bytes);
 
-  // 读取XML数据...
-  ret = mxml_load_data(top, options, (mxml_io_cb_t)mxml_read_cb_file, fp);
+  ret = mxml_context_load(context, top, &r);
 
-  // 关闭文件并返回...
-  fclose(fp);
+  // 释放UTF-16数据转换后的缓冲区（如果有）...
+  mxml_read_free(&r);
 
   return (ret);
 }
 
 
 //
-// 'mxmlLoadIO（）' - 使用读取回调加载XML节点树。
-//
-// 此函数使用读取回调函数加载数据到XML节点树中。指定文件中的节点将添加到指定节点`top`中 - 如果为`NULL`，则XML文件必须是格式良好的，以文件开头的单个父处理指令节点（例如`<?xml version =“1.0”？>）。
-//
-// 加载选项通过`options`参数提供。如果为`NULL`，所有值将加载到`MXML_TYPE_TEXT`节点中。在加载XML数据时，请使用@link mxmlOptionsNew@函数创建选项。
+// 'mxmlContextLoadString（）' - 使用加载上下文将字符串加载到XML节点树中。
 //
-// 读取回调函数`io_cb`将被调用以从源中读取一定数量的字节。回调数据指针`io_cbdata`将与指向缓冲区和要读取的最大字节数的指针一起传递给读取回调函数，例如：
+// 此函数与@link mxmlLoadString@相同，但是使用加载上下文`context`的选项、令牌缓冲区和内存池，适合
+// 重复加载大量较小的文档。节点总是从上下文的内存池中分配（与@link mxmlOptionsSetArena@相同），
+// 并且只有在删除之前加载的所有节点之后才会重复使用内存池的内存：
 //
 // ```c
-// size_t my_io_cb(void *cbdata, void *buffer, size_t bytes)
+// mxml_context_t *context = mxmlContextNew(options);
+//
+// while ((message = read_message()) != NULL)
 // {
-//   ... 将最多“bytes”字节复制到缓冲区中 ...
-//   ... 返回“读取”的字节数，或错误时返回0 ...
+//   mxml_node_t *xml = mxmlContextLoadString(context, NULL, message);
+//
+//   ... 处理消息 ...
+//
+//   mxmlDelete(xml);
 // }
+//
+// mxmlContextDelete(context);
 // ```
+//
+// 删除节点树之后，加载较小的文档时除了扩展令牌缓冲区或内存池之外不分配内存。如果之前的节点树仍然
+// 存在，它保留之前的内存池，上下文为之后的文档创建新的内存池。使用上下文加载时不延迟加载元素的内容，
+// 临时SAX模式使用自己的内存池。
+//
 
-mxml_node_t *                // O - 第一个节点，如果无法读取文件，则为`NULL`。
-mxmlLoadIO(
-    mxml_node_t    *top,        // I - 顶级节点
-    mxml_options_t *options,    // I - 选项
-    mxml_io_cb_t   io_cb,        // I - 读取回调函数
-    void           *io_cbdata)    // I - 读取回调数据
+mxml_node_t *				// O - 第一个节点或`NULL`（如果数据有错误）
+mxmlContextLoadString(
+    mxml_context_t *context,		// I - 加载上下文
+    mxml_node_t    *top,		// I - 顶级节点
+    const char     *s)			// I - 要加载的字符串
 {
   // 范围检查输入...
-  if (!io_cb)
+  if (!context || !s)
     return (NULL);
 
-  // 读取XML数据...
-  return (mxml_load_data(top, options, io_cb, io_cbdata));
+  return (mxmlContextLoadBuffer(context, top, s, strlen(s)));
 }
 
 
 //
-// 'mxmlLoadString（）' - 将字符串加载到XML节点树中。
+// 'mxmlContextNew（）' - 创建可重复使用的加载上下文。
 //
-// 此函数将字符串加载到XML节点树中。指定文件中的节点将添加到指定节点`top`中 - 如果为`NULL`，则XML文件必须是格式良好的，以文件开头的单个父处理指令节点（例如`<?xml version =“1.0”？>）。
+// 此函数创建一个加载上下文，在多次加载之间保留令牌缓冲区和节点的内存池。使用
+// @link mxmlContextLoadString@或@link mxmlContextLoadBuffer@函数加载文档，然后使用
+// @link mxmlContextDelete@函数释放上下文。一个上下文每次只能在一个线程中使用。
+//
+// 加载选项通过`options`参数提供，并且在释放上下文之前必须保持有效。如果为`NULL`，所有值将加载到
+// `MXML_TYPE_TEXT`节点中。
 //
-// 加载选项通过`options`参数提供。如果为`NULL`，所有值将加载到`MXML_TYPE_TEXT`节点中。在加载XML数据时，请使用@link mxmlOptionsNew@函数创建选项。
 
-mxml_node_t *                // O - 第一个节点或`NULL`（如果字符串有错误）。
-mxmlLoadString(
-    mxml_node_t    *top,        // I - 顶级节点
-    mxml_options_t *options,    // I - 选项
-    const char     *s)            // I - 要加载的字符串
+mxml_context_t *			// O - 加载上下文或`NULL`（如果内存不足）
+mxmlContextNew(mxml_options_t *options)	// I - 选项或`NULL`表示默认选项
 {
-  _mxml_stringbuf_t    sb;        // 字符串缓冲区
+  mxml_context_t *context;		// 加载上下文
 
 
-  // 范围检查输入...
-  if (!s)
+  if ((context = (mxml_context_t *)calloc(1, sizeof(mxml_context_t))) == NULL)
     return (NULL);
 
-  // 设置字符串缓冲区...
-  sb.buffer   = (char *)s;
-  sb.bufptr   = (char *)s;
-  sb.bufsize  = strlen(s);
-  sb.bufalloc = false;
+  if (!options && (options = context->defoptions = mxmlOptionsNew()) == NULL)
+  {
+    free(context);
+    return (NULL);
+  }
 
-  // 读取XML数据...
-  return (mxml_load_data(top, options, (mxml_io_cb_t)mxml_read_cb_string, &sb));
+  context->options = options;
+
+  return (context);
 }
 
 
 //
-// 'mxmlSaveAllocString（）' - 将XML树保存到分配的字符串中。
-//
-// 此函数将XML树`node`保存到分配的字符串中。使用`free`（或使用@link mxmlSetStringCallbacks@设置的字符串释放回调）释放字符串。
+// 'mxmlContextReset（）' - 释放加载上下文缓存的内存。
 //
-// 如果节点生成空字符串或无法分配字符串，则返回`NULL`。
+// 此函数释放加载上下文`context`保留的令牌缓冲区和内存池，例如在加载了一个较大的文档之后。上下文
+// 仍然可以继续使用，之后的加载重新分配需要的内存。使用上下文加载的节点树仍然有效。
 //
-// 保存选项通过`options`参数提供。如果为`NULL`，XML输出将在列72处换行，不添加额外的空格。请使用@link mxmlOptionsNew@函数创建保存XML数据的选项。
 
-char *                    // O - 分配的字符串或`NULL`
-mxmlSaveAllocString(
-    mxml_node_t    *node,        // I - 要写入的节点
-    mxml_options_t *options)    // I - 选项
+void
+mxmlContextReset(
+    mxml_context_t *context)		// I - 加载上下文
 {
-  _mxml_stringbuf_t    sb;        // 字符串缓冲区
-
-
-  // 设置字符串缓冲区
-  if ((sb.buffer = malloc(1024)) == NULL)
-    return (NULL);
-
-  sb.bufptr   = sb.buffer;
-  sb.bufsize  = 1024;
-  sb.bufalloc = true;
-
-  // 写入顶级节点...
-  if (mxml_write_node(node, options, (mxml_io_cb_t)mxml_io_cb_string, &sb, 0) < 0)
-  {
-    free(sb.buffer);
-    return (NULL);
-  }
+  if (!context)
+    return;
 
-  // 以空字符结尾...
-  *(sb.bufptr) = '\0';
+  while (context->num_heaps > 0)
+    free(context->heaps[-- context->num_heaps]);
 
-  // 返回分配的字符串...
-  return (sb.buffer);
+  _mxml_doc_release(context->doc);
+  context->doc = NULL;
 }
 
 
 //
-// 'mxmlSaveFd（）' - 将XML树保存到文件描述符中。
+// 'mxmlElementExpand（）' - 加载元素延迟的内容并检查是否有错误。
 //
-// 此函数将XML树`node`保存到文件描述符中。
+// 此函数加载使用@link mxmlOptionsSetLazyDepth@延迟的元素`node`的内容。`descend`为`MXML_DESCEND_ALL`时
+// 同时加载所有后代元素延迟的内容，例如在加载文档之后立即检查整个文档。
+//
+// 访问函数在第一次访问时自动加载延迟的内容，但是无法返回错误：内容中有错误（例如未定义的实体、重复
+// 的属性或不匹配的闭合标签）时元素没有子节点，错误只报告给加载文档时设置的错误回调函数，之后保存
+// 节点树会失败。此函数对这样的元素返回`false`。
 //
-// 保存选项通过`options`参数提供。如果为`NULL`，XML输出将在列72处换行，不添加额外的空格。请使用@link mxmlOptionsNew@函数创建保存XML数据的选项。
 
-bool                    // O - `true`表示成功，`false`表示错误。
-mxmlSaveFd(mxml_node_t    *node,    // I - 要写入的节点
-           mxml_options_t *options,    // I - 选项
-           int            fd)        // I - 要写入的文件描述符
+bool					// O - `true`表示所有的内容都已加载，`false`表示内容中有错误
+mxmlElementExpand(
+    mxml_node_t    *node,		// I - 元素
+    mxml_descend_t descend)		// I - 是否加载后代元素的内容 - `MXML_DESCEND_ALL`或`MXML_DESCEND_NONE`
 {
-  int    col;            // 最终列
+  mxml_node_t	*current;		// 当前节点
+  bool		ret = true;		// 返回值
 
 
-  // 写入节点...
-  if ((col = mxml_write_node(node, options, (mxml_io_cb_t)mxml_io_cb_fd, &fd, 0)) < 0)
+  // 范围检查输入...
+  if (!node || node->type != MXML_TYPE_ELEMENT)
     return (false);
 
-  // 确保文件以换行符结束...
-  if (col > 0)
+  // 遍历节点树时加载延迟的内容，出错的元素保留延迟的内容...
+  for (current = node; current; current = descend == MXML_DESCEND_ALL ? mxmlWalkNext(current, node, MXML_DESCEND_ALL) : NULL)
   {
-    if (write(fd, "\n", 1) < 0)
-      return (false);
+    MXML_EXPAND(current);
+
+    if (current->type == MXML_TYPE_ELEMENT && current->value.element.lazy)
+      ret = false;
   }
 
-  return (true);
+  return (ret);
 }
 
 
 //
-// 'mxmlSaveFile（）' - 将XML树保存到文件中。
+// 'mxmlLoadBufferInSitu()' - 原位解析可修改的缓冲区。
 //
-// 此函数将XML树`node`保存到stdio `FILE`中。
+// 此函数将缓冲区`buf`中的`len`字节XML数据加载到XML节点树中。与@link mxmlLoadString@不同，元素名称、属性名称和值以及文本等字符串直接指向缓冲区，而不是复制到新分配的内存中：解析时在缓冲区中原位解码实体并添加空字符。因此缓冲区的内容会被修改，并且在删除节点树之前必须保持有效。UTF-16数据以及解码后比原始数据更长的字符串（例如通过实体回调）仍然会被复制。
 //
-// 保存选项通过`options`参数提供。如果为`NULL`，XML输出将在列72处换行，不添加额外的空格。请使用@link mxmlOptionsNew@函数创建保存XML数据的选项。
+// 指定缓冲区中的节点将添加到指定节点`top`中 - 如果为`NULL`，则XML数据必须是格式良好的，以单个父处理指令节点开头（例如`<?xml version =“1.0”？>）。
+//
+// 加载选项通过`options`参数提供。如果为`NULL`，所有值将加载到`MXML_TYPE_TEXT`节点中。在加载XML数据时，请使用@link mxmlOptionsNew@函数创建选项。
 
-bool                    // O - `true`表示成功，`false`表示错误。
-mxmlSaveFile(
-    mxml_node_t    *node,        // I - 要写入的节点
+mxml_node_t *                // O - 第一个节点或`NULL`（如果数据有错误）。
+mxmlLoadBufferInSitu(
+    mxml_node_t    *top,        // I - 顶级节点
     mxml_options_t *options,    // I - 选项
-    FILE           *fp)        // I - 要写入的文件
+    char           *buf,        // I - 要加载的缓冲区，会被修改
+    size_t         len)         // I - 缓冲区的长度（字节）
 {
-  int    col;            // 最终列
+  _mxml_read_t    r;            // 输入缓冲区
+  mxml_node_t     *ret;         // 第一个节点
 
 
-  // 写入节点...
-  if ((col = mxml_write_node(node, options, (mxml_io_cb_t)mxml_io_cb_file, fp, 0)) < 0)
-    return (false);
+  // 范围检查输入...
+  if (!buf)
+    return (NULL);
 
-  // 确保文件以换行符结束...
-  if (col > 0)
-  {
-    if (putc('\n', fp) < 0)
-      return (false);
-  }
+  // 读取XML数据，节点属于引用缓冲区的文档，不会复制或释放缓冲区中的字符串...
+  _mxml_read_init_string(&r, buf, len);
+  r.insitu = true;
 
-  return (true);
+  ret = mxml_load_doc(top, options, &r, buf, len);
+
+  // 释放UTF-16数据转换后的缓冲区（如果有）...
+  mxml_read_free(&r);
+
+  return (ret);
 }
 
 
 //
-// 'mxmlSaveFilename（）' - 将XML树保存到文件中。
+// 'mxmlLoadFd（）' - 将文件描述符加载到XML节点树中。
 //
-// 此函数将XML树`node`保存到命名文件中。
+// 此函数将文件描述符`fd`加载到XML节点树中。指定文件中的节点将添加到指定节点`top`中 - 如果为`NULL`，则XML文件必须是格式良好的，以文件开头的单个父处理指令节点（例如`<?xml version =“1.0”？>）。
 //
-// 保存选项通过`options`参数提供。如果为`NULL`，XML输出将在列72处换行，不添加额外的空格。请使用@link mxmlOptionsNew@函数创建保存XML数据的选项。
+// 加载选项通过`options`参数提供。如果为`NULL`，所有值将加载到`MXML_TYPE_TEXT`节点中。在加载XML数据时，请使用@link mxmlOptionsNew@函数创建选项。
+//
+// 如果文件描述符引用的是常规文件，则直接从文件的内存映射中解析数据；否则（例如管道和套接字）使用缓冲读取。
+// 缓冲读取每次最多读取@link mxmlOptionsSetBufferSize@设置的字节数（默认64k字节）。加载在数据结尾之前
+// 停止时（出错或者SAX回调函数停止加载），可定位的文件的位置退回到加载停止的位置，而管道和套接字中已经
+// 预读的数据会丢失。需要继续从管道或套接字读取时，请使用@link mxmlOptionsSetReadSize@限制预读。
 
-bool                    // O - `true`表示成功，`false`表示错误。
-mxmlSaveFilename(
-    mxml_node_t    *node,        // I - 要写入的节点
+mxml_node_t *                // O - 第一个节点，如果无法读取文件，则为`NULL`。
+mxmlLoadFd(
+    mxml_node_t    *top,        // I - 顶级节点
     mxml_options_t *options,    // I - 选项
-    const char     *filename)    // I - 要写入的文件
+    int            fd)            // I - 要读取的文件描述符
 {
-  bool        ret = true;    // 返回值
-  FILE        *fp;            // 文件指针
-  int        col;            // 最终列
+  _mxml_read_t	r;			// 输入缓冲区
+  mxml_node_t	*ret;			// 第一个节点
 
 
-  // 打开文件...
-  if ((fp = fopen(filename, "w")) == NULL)
-    return (false);
+  // 范围检查输入...
+  if (fd < 0)
+    return (NULL);
 
-  // 写入节点...
-  if ((col = mxml_write_node(node, options, (mxml_io_cb_t)mxml_io_cb_file, fp, 0)) < 0)
+  // 读取XML数据...
+  if (mxml_read_init_map(&r, fd))
   {
-    ret = false;
+    // 直接从映射中解析，然后将文件位置设置到已使用数据的末尾...
+    ret = mxml_load_doc(top, options, &r, NULL, 0);
+
+    lseek(fd, (off_t)(r.bufptr - r.buffer), SEEK_SET);
   }
-  else if (col > 0)
+  else if (mxml_read_init(&r, options, (mxml_io_cb_t)mxml_read_cb_fd, &fd))
   {
-    // 确保文件以换行符结束...
-    if (putc('\n', fp) < 0)
-      ret = false;
+    ret = mxml_load_doc(top, options, &r, NULL, 0);
+
+#ifndef _WIN32
+    // 退回未使用的预读数据（仅对可定位的文件有效）...
+    if (r.bufptr < r.bufend)
+      lseek(fd, -(off_t)(r.bufend - r.bufptr), SEEK_CUR);
+#endif // !_WIN32
+  }
+  else
+  {
+    return (NULL);
   }
 
-  fclose(fp);
+  mxml_read_free(&r);
 
   return (ret);
 }
 
 
 //
-// 'mxmlSaveIO（）' - 使用回调保存XML树。
+// 'mxmlLoadFile（）' - 将文件加载到XML节点树中。
 //
-// 此函数使用写回调函数`io_cb`保存XML树`node`。回调数据指针`io_cbdata`与缓冲区指针和要写入的字节数一起传递给写回调函数，例如：
+// 此函数将`FILE`指针`fp`加载到XML节点树中。指定文件中的节点将添加到指定节点`top`中 - 如果为`NULL`，则XML文件必须是格式良好的，以文件开头的单个父处理指令节点（例如`<?xml version =“1.0”？>）。
 //
-// ```c
-// size_t my_io_cb(void *cbdata, const void *buffer, size_t bytes)
-// {
-//   ... 将字节从缓冲区写入输出 ...
-//   ... 返回写入/复制的字节数，错误时返回0 ...
-// }
-// ```
+// 加载选项通过`options`参数提供。如果为`NULL`，所有值将加载到`MXML_TYPE_TEXT`节点中。在加载XML数据时，请使用@link mxmlOptionsNew@函数创建选项。
 //
-// 保存选项通过`options`参数提供。如果为`NULL`，XML输出将在列72处换行，不添加额外的空格。请使用@link mxmlOptionsNew@函数创建保存XML数据的选项。
+// 数据每次最多读取@link mxmlOptionsSetBufferSize@设置的字节数（默认64k字节）。加载在数据结尾之前停止时
+// （出错或者SAX回调函数停止加载），可定位的文件的位置退回到加载停止的位置，而管道等无法定位的文件中已经
+// 预读的数据会丢失。需要继续从这样的文件读取时，请使用@link mxmlOptionsSetReadSize@限制预读。
 
-bool                    // O - `true`表示成功，`false`表示错误。
-mxmlSaveIO(
-    mxml_node_t    *node,        // I - 要写入的节点
+mxml_node_t *                // O - 第一个节点，如果无法读取文件，则为`NULL`。
+mxmlLoadFile(
+    mxml_node_t    *top,        // I - 顶级节点
     mxml_options_t *options,    // I - 选项
-    mxml_io_cb_t   io_cb,        // I - 写回调函数
-    void           *io_cbdata)    // I - 写回调数据
+    FILE           *fp)        // I - 要读取的文件
 {
-  int    col;            // 最终列
+  _mxml_read_t	r;			// 输入缓冲区
+  mxml_node_t	*ret;			// 第一个节点
 
 
   // 范围检查输入...
-  if (!node || !io_cb)
-    return (false);
+  if (!fp)
+    return (NULL);
 
-  // 写入节点...
-  if ((col = mxml_write_node(node, options, io_cb, io_cbdata, 0)) < 0)
-    return (false);
+  // 读取XML数据...
+  if (!mxml_read_init(&r, options, (mxml_io_cb_t)mxml_read_cb_file, fp))
+    return (NULL);
 
-  if (col > 0)
-  {
-    // 确保文件以换行符结束...
-    if ((io_cb)(io_cbdata, "\n", 1) != 1)
-      return (false);
-  }
+  ret = mxml_load_doc(top, options, &r, NULL, 0);
 
-  return (true);
+  // 退回未使用的预读数据（仅对可定位的文件有效）...
+  if (r.bufptr < r.bufend && !fseek(fp, -(long)(r.bufend - r.bufptr), SEEK_CUR))
+    clearerr(fp);
+
+  mxml_read_free(&r);
+
+  return (ret);
 }
 
 
 //
-// 'mxmlSaveString（）' - 将XML节点树保存到字符串中。
+// 'mxmlLoadFilename（）' - 将文件加载到XML节点树中。
 //
-// 此函数将XML树`node`保存到固定大小的字符串缓冲区中。
+// 此函数将命名文件`filename`加载到XML节点树中。指定文件中的节点将添加到指定节点`top`中 - 如果为`NULL`，则XML文件必须是格式良好的，以文件开头的单个父处理指令节点（例如`<?xml version =“1.0”？>）。
 //
-// 保存选项通过`options`参数提供。如果为`NULL`，XML输出将在列72处换行，不添加额外的空格。请使用@link mxmlOptionsNew@函数创建保存XML数据的选项。
+// 加载选项通过`options`参数提供。如果为`NULL`，所有值将加载到`MXML_TYPE_TEXT`节点中。在加载XML数据时，请使用@link mxmlOptionsNew@函数创建选项。
+//
+// 常规文件会被映射到内存中并直接解析；其他文件使用缓冲读取。
 
-size_t                    // O - 字符串的大小
-mxmlSaveString(
-    mxml_node_t    *node,        // I - 要写入的节点
+mxml_node_t *                // O - 第一个节点，如果无法读取文件，则为`NULL`。
+mxmlLoadFilename(
+    mxml_node_t    *top,        // I - 顶级节点
     mxml_options_t *options,    // I - 选项
-    char           *buffer,    // I - 字符串缓冲区
-    size_t         bufsize)    // I - 字符串缓冲区的大小
+    const char     *filename)    // I - 要读取的文件
 {
-  _mxml_stringbuf_t    sb;        // 字符串缓冲区
+  int        fd;            // 文件描述符
+  _mxml_read_t    r;            // 输入缓冲区
+  mxml_node_t    *ret;            // 节点
 
 
-  // 设置字符串缓冲区...
-  sb.buffer   = buffer;
-  sb.bufptr   = buffer;
-  sb.bufsize  = bufsize;
-  sb.bufalloc = false;
+  // 范围检查输入...
+  if (!filename)
+    return (NULL);
 
-  // 写入节点...
-  if (mxml_write_node(node, options, (mxml_io_cb_t)mxml_io_cb_string, &sb, 0) < 0)
-    return (false);
+  // 打开文件...
+  if ((fd = open(filename, O_RDONLY | O_BINARY)) < 0)
+    return (NULL);
 
-  // 以空字符结尾...
-  if (sb.bufptr < (sb.buffer + sb.bufsize))
-    *(sb.bufptr) = '\0';
+  // 读取XML数据...
+  if (mxml_read_init_map(&r, fd) || mxml_read_init(&r, options, (mxml_io_cb_t)mxml_read_cb_fd, &fd))
+  {
+    ret = mxml_load_doc(top, options, &r, NULL, 0);
+    mxml_read_free(&r);
+  }
+  else
+  {
+    ret = NULL;
+  }
+
+  // 关闭文件并返回...
+  close(fd);
 
-  // 返回字符数...
-  return ((size_t)(sb.bufptr - sb.buffer));
+  return (ret);
 }
 
 
 //
-// 'mxml_add_char（）' - 将字符添加到缓冲区中，根据需要进行扩展。
+// 'mxmlLoadFilenameParallel（）' - 使用多个线程将文件加载到XML节点树中。
+//
+// 此函数与@link mxmlLoadFilename@相同，但是对于由根元素和大量同级记录元素组成的较大的常规文件，将根
+// 元素的内容在顶级记录之间拆分为多段，使用最多`nthreads`个线程（包括调用者的线程）并行加载，然后按照
+// 顺序将加载的节点添加到根元素中。`nthreads`为0时使用在线的处理器数量。
 //
+// 拆分位置是推测的：第一个记录元素的闭合标签之后紧跟另一个元素的开始标签的位置。每段数据必须加载
+// 为完整的元素序列并且没有任何错误，否则（例如拆分位置位于注释、CDATA或嵌套的同名元素中）丢弃已经
+// 加载的节点并使用@link mxmlLoadFilename@重新加载文件，因此加载的节点树和报告的错误与串行加载相同。
+// 无法映射到内存中的文件、UTF-16文件、使用SAX回调函数的选项、没有线程支持的平台以及较小的文件总是
+// 串行加载。
+//
+// 类型、实体和自定义数据回调函数可能在其他线程中并发调用，并且必须是线程安全的；类型回调函数接收的
+// 父节点可能是根元素的副本（具有相同的名称和属性，但是没有父节点）。
 
-static bool                // O  - `true`表示成功，`false`表示错误
-mxml_add_char(mxml_options_t *options,    // I  - 选项
-              int            ch,        // I  - 要添加的字符
-              char           **bufptr,    // IO - 缓冲区中的当前位置
-              char           **buffer,    // IO - 当前缓冲区
-              size_t         *bufsize)    // IO - 当前缓冲区大小
+mxml_node_t *				// O - 第一个节点，如果无法读取文件，则为`NULL`。
+mxmlLoadFilenameParallel(
+    mxml_node_t    *top,		// I - 顶级节点
+    mxml_options_t *options,		// I - 选项
+    const char     *filename,		// I - 要读取的文件
+    int            nthreads)		// I - 线程数，0表示处理器的数量
 {
-  char    *newbuffer;        // 新缓冲区值
+#if defined(HAVE_PTHREAD_H) && defined(HAVE_SYS_MMAN_H)
+  int		fd;			// 文件描述符
+  _mxml_read_t	r,			// 文件的内存映射
+		pr;			// 根元素之前的数据
+  mxml_options_t *defoptions = NULL,	// 没有指定选项时的默认选项
+		*partoptions;		// 数据段的选项
+  _mxml_part_t	*parts = NULL;		// 数据段
+  size_t	i,			// 循环变量
+		attr,			// 属性的索引
+		count,			// 数据段的数量
+		bytes,			// 根元素内容的字节数
+		namelen,		// 根元素名称的长度
+		recordlen;		// 记录元素名称的长度
+  const char	*data,			// 文件的开头
+		*end,			// 文件的结尾
+		*body,			// 根元素内容的开头
+		*bodyend,		// 根元素的闭合标签
+		*ptr,			// 当前位置
+		*target,		// 拆分的目标位置
+		*name,			// 根元素名称
+		*record,		// 第一个记录元素的名称
+		*attrname,		// 属性名称
+		*attrvalue;		// 属性值
+  char		*prolog = NULL;		// 根元素之前的数据和根元素的空内容
+  mxml_node_t	*ret = NULL,		// 第一个节点
+		*mark,			// 加载之前顶级节点的最后一个子节点
+		*root,			// 根元素
+		*node;			// 当前节点
+  bool		ok = false;		// 是否成功并行加载？
+
+
+  // 范围检查输入...
+  if (!filename)
+    return (NULL);
+
+  if (nthreads <= 0)
+    nthreads = (int)sysconf(_SC_NPROCESSORS_ONLN);
+
+  // 没有选项时顶级节点中的值被忽略，使用默认选项的数据段无法得到相同的结果，延迟的内容需要整个文件的映射，
+  // 投影路径从根元素开始匹配...
+  if (nthreads < 2 || (options && (options->sax_cb || options->lazy_depth > 0 || options->num_paths > 0)) || (!options && top))
+    return (mxmlLoadFilename(top, options, filename));
 
+  // 将文件映射到内存中...
+  if ((fd = open(filename, O_RDONLY | O_BINARY)) < 0)
+    return (NULL);
 
-  if (*bufptr >= (*buffer + *bufsize - 4))
+  if (!mxml_read_init_map(&r, fd))
   {
-    // 增加缓冲区的大小...
-    if (*bufsize < 1024)
-      (*bufsize) *= 2;
-    else
-      (*bufsize) += 1024;
+    close(fd);
+    return (mxmlLoadFilename(top, options, filename));
+  }
+
+  close(fd);
+
+  data = (const char *)r.bufptr;
+  end  = (const char *)r.bufend;
+
+  // 查找根元素的开始标签和文件结尾的闭合标签（之后只能有空白字符）...
+  if ((body = mxml_load_root(data, end, &name, &namelen)) == NULL || *body == '\357' || *body == '\376' || *body == '\377')
+    goto serial;
+
+  for (ptr = end; ptr > body && MXML_ISSPACE(ptr[-1]); ptr --);
+
+  if (ptr <= body || ptr[-1] != '>')
+    goto serial;
+
+  for (ptr --; ptr > body && MXML_ISSPACE(ptr[-1]); ptr --);
+
+  if ((size_t)(ptr - body) < (namelen + 2) || memcmp(ptr - namelen - 2, "</", 2) || memcmp(ptr - namelen, name, namelen))
+    goto serial;
+
+  bodyend = ptr - namelen - 2;
+
+  // 使用第一个记录元素的名称查找拆分位置...
+  for (ptr = body; ptr < bodyend && MXML_ISSPACE(*ptr); ptr ++);
 
-    if ((newbuffer = realloc(*buffer, *bufsize)) == NULL)
+  if (ptr >= bodyend || *ptr != '<' || ptr[1] == '/' || ptr[1] == '!' || ptr[1] == '?')
+    goto serial;
+
+  for (record = ++ ptr; ptr < bodyend && !MXML_ISSPACE(*ptr) && *ptr != '/' && *ptr != '>'; ptr ++);
+
+  if ((recordlen = (size_t)(ptr - record)) == 0)
+    goto serial;
+
+  bytes = (size_t)(bodyend - body);
+  count = (size_t)nthreads;
+
+  if ((bytes / count) < MXML_PART_MIN)
+    count = bytes / MXML_PART_MIN;
+
+  if (count < 2 || (parts = calloc(count, sizeof(_mxml_part_t))) == NULL)
+    goto serial;
+
+  if ((partoptions = options) == NULL && (partoptions = defoptions = mxmlOptionsNew()) == NULL)
+    goto serial;
+
+  for (i = 0, ptr = body; i < count; i ++)
+  {
+    parts[i].options              = *partoptions;
+    parts[i].options.error_cb     = (mxml_error_cb_t)mxml_load_part_error;
+    parts[i].options.error_cbdata = &parts[i].error;
+    parts[i].global               = _mxml_global();
+    parts[i].start                = ptr;
+
+    if ((target = body + (i + 1) * (bytes / count)) < ptr)
+      target = ptr;
+
+    if (i == (count - 1) || (ptr = mxml_load_split(target, bodyend, record, recordlen)) == NULL)
     {
-      _mxml_error(options, "无法将字符串缓冲区扩展到%lu字节。", (unsigned long)*bufsize);
+      // 最后一段包括根元素的闭合标签...
+      for (ptr = bodyend; *ptr != '>'; ptr ++);
 
-      return (false);
+      parts[i].bytes = (size_t)(ptr + 1 - parts[i].start);
+      count          = i + 1;
+      break;
     }
 
-    *bufptr = newbuffer + (*bufptr - *buffer);
-    *buffer = newbuffer;
+    parts[i].bytes = (size_t)(ptr - parts[i].start);
   }
 
-  if (ch < 0x80)
-  {
-    // 单字节ASCII...
-    *(*bufptr)++ = ch;
-  }
-  else if (ch < 0x800)
+  if (count < 2)
+    goto serial;
+
+  // 加载根元素之前的数据，为根元素添加空的内容...
+  if ((prolog = malloc((size_t)(body - data) + namelen + 4)) == NULL)
+    goto serial;
+
+  memcpy(prolog, data, (size_t)(body - data));
+  snprintf(prolog + (body - data), namelen + 4, "</%.*s>", (int)namelen, name);
+
+  mark = top ? top->last_child : NULL;
+
+  _mxml_read_init_string(&pr, prolog, strlen(prolog));
+  ret = mxml_load_doc(top, &parts[0].options, &pr, NULL, 0);
+  mxml_read_free(&pr);
+
+  if (!ret || parts[0].error)
+    goto cleanup;
+
+  for (root = top ? top : ret; root->last_child; root = root->last_child);
+
+  if (root == top || root->type != MXML_TYPE_ELEMENT || strlen(root->value.element.name) != namelen || strncmp(root->value.element.name, name, namelen))
+    goto cleanup;
+
+  // 在根元素的副本中并行加载每段数据...
+  for (i = 0; i < count; i ++)
   {
-    // 两字节UTF-8...
-    *(*bufptr)++ = 0xc0 | (ch >> 6);
-    *(*bufptr)++ = 0x80 | (ch & 0x3f);
+    if ((parts[i].top = mxmlNewElement(/*parent*/NULL, root->value.element.name)) == NULL)
+      goto cleanup;
+
+    for (attr = 0; (attrvalue = mxmlElementGetAttrByIndex(root, attr, &attrname)) != NULL; attr ++)
+      mxmlElementSetAttr(parts[i].top, attrname, attrvalue);
   }
-  else if (ch < 0x10000)
+
+  for (i = 1; i < count; i ++)
+    parts[i].started = !pthread_create(&parts[i].thread, NULL, (void *(*)(void *))mxml_load_part, parts + i);
+
+  for (i = 0; i < count; i ++)
   {
-    // 三字节UTF-8...
-    *(*bufptr)++ = 0xe0 | (ch >> 12);
-    *(*bufptr)++ = 0x80 | ((ch >> 6) & 0x3f);
-    *(*bufptr)++ = 0x80 | (ch & 0x3f);
+    if (parts[i].started)
+      pthread_join(parts[i].thread, NULL);
+    else
+      mxml_load_part(parts + i);
   }
-  else
+
+  // 每段数据必须是完整的元素序列，最后一段必须关闭根元素...
+  for (i = 0, ok = true; i < count; i ++)
   {
-    // 四字节UTF-8...
-    *(*bufptr)++ = 0xf0 | (ch >> 18);
-    *(*bufptr)++ = 0x80 | ((ch >> 12) & 0x3f);
-    *(*bufptr)++ = 0x80 | ((ch >> 6) & 0x3f);
-    *(*bufptr)++ = 0x80 | (ch & 0x3f);
+    if (parts[i].error || !parts[i].ret || (i < (count - 1)) != (parts[i].ret == parts[i].top))
+      ok = false;
   }
 
-  return (true);
-}
+  if (ok)
+  {
+    // 按照顺序将加载的节点移到根元素中...
+    for (i = 0; i < count; i ++)
+    {
+      if ((node = parts[i].top->child) == NULL)
+        continue;
 
+      for (; node; node = node->next)
+        node->parent = root;
 
-//
-// 'mxml_get_entity（）' - 获取与实体对应的字符...
-//
+      if (root->last_child)
+        root->last_child->next = parts[i].top->child;
+      else
+        root->child = parts[i].top->child;
 
-static int                // O  - 字符值或错误时为`EOF`
-mxml_get_entity(
-    mxml_options_t   *options,        // I  - 选项
-    mxml_io_cb_t     io_cb,        // I  - 读取回调函数
-    void             *io_cbdata,    // I  - 读取回调数据
-    _mxml_encoding_t *encoding,    // IO - 字符编码
-    mxml_node_t      *parent,        // I  - 父节点
-    int              *line)        // IO - 当前行号
-{
-  int    ch;            // 当前字符
-  char    entity[64],        // 实体字符串
-    *entptr;        // 实体指针
+      parts[i].top->child->prev = root->last_child;
+      root->last_child          = parts[i].top->last_child;
+      parts[i].top->child       = NULL;
+      parts[i].top->last_child  = NULL;
+    }
+  }
 
+  // 释放并行加载的数据，如果失败则删除已经加载的节点...
+  cleanup:
 
-  // 读取HTML字符实体，格式为“&NAME;”，“&#NUMBER;”或“&#xHEX”...
-  entptr = entity;
+  for (i = 0; i < count; i ++)
+    mxmlDelete(parts[i].top);
 
-  while ((ch = mxml_getc(options, io_cb, io_cbdata, encoding)) != EOF)
+  if (!ok && ret)
   {
-    if (ch > 126 || (!isalnum(ch) && ch != '#'))
-    {
-      break;
-    }
-    else if (entptr < (entity + sizeof(entity) - 1))
+    if (top)
     {
-      *entptr++ = ch;
+      while ((node = mark ? mark->next : top->child) != NULL)
+        mxmlDelete(node);
     }
     else
     {
-      _mxml_error(options, "父节点<%s>下的实体名称过长，位于第%d行。", mxmlGetElement(parent), *line);
-      break;
+      mxmlDelete(ret);
     }
   }
 
-  *entptr = '\0';
-
-  if (ch != ';')
-  {
-    _mxml_error(options, "父节点<%s>下的字符实体“%s”未终止，位于第%d行。", entity, mxmlGetElement(parent), *line);
+  serial:
 
-    if (ch == '\n')
-      (*line)++;
+  free(prolog);
+  free(parts);
+  mxmlOptionsDelete(defoptions);
+  mxml_read_free(&r);
 
-    return (EOF);
-  }
+  if (!ok)
+    ret = mxmlLoadFilename(top, options, filename);
 
-  if ((ch = _mxml_entity_value(options, entity)) < 0)
-  {
-    _mxml_error(options, "父节点<%s>下的实体“&%s;”不受支持，位于第%d行。", entity, mxmlGetElement(parent), *line);
-    return (EOF);
-  }
+  return (ret);
 
-  if (mxml_bad_char(ch))
-  {
-    _mxml_error(options, "父节点<%s>下的控制字符0x%02x不符合XML标准，位于第%d行。", ch, mxmlGetElement(parent), *line);
-    return (EOF);
-  }
+#else
+  (void)nthreads;
 
-  return (ch);
+  return (mxmlLoadFilename(top, options, filename));
+#endif // HAVE_PTHREAD_H && HAVE_SYS_MMAN_H
 }
 
 
-
 //
-// 'mxml_getc()' - 从文件描述符中读取一个字符。
+// 'mxmlLoadIO（）' - 使用读取回调加载XML节点树。
+//
+// 此函数使用读取回调函数加载数据到XML节点树中。指定文件中的节点将添加到指定节点`top`中 - 如果为`NULL`，则XML文件必须是格式良好的，以文件开头的单个父处理指令节点（例如`<?xml version =“1.0”？>）。
+//
+// 加载选项通过`options`参数提供。如果为`NULL`，所有值将加载到`MXML_TYPE_TEXT`节点中。在加载XML数据时，请使用@link mxmlOptionsNew@函数创建选项。
+//
+// 读取回调函数`io_cb`将被调用以从源中读取一定数量的字节。回调数据指针`io_cbdata`将与指向缓冲区和要读取的最大字节数的指针一起传递给读取回调函数，例如：
+//
+// ```c
+// size_t my_io_cb(void *cbdata, void *buffer, size_t bytes)
+// {
+//   ... 将最多“bytes”字节复制到缓冲区中 ...
+//   ... 返回“读取”的字节数，或错误时返回0 ...
+// }
+// ```
 //
+// 读取回调函数每次被请求最多@link mxmlOptionsSetBufferSize@设置的字节数（默认64k字节）。加载在数据
+// 结尾之前停止时（出错或者SAX回调函数停止加载），已经读取但没有使用的数据会丢失。如果需要在加载之后
+// 继续从同一个来源读取，请使用@link mxmlOptionsSetReadSize@限制每次请求的字节数。
 
-static int				// O  - 字符或 `EOF`
-mxml_getc(mxml_options_t   *options,	// I  - 选项
-          mxml_io_cb_t     io_cb,	// I  - 读取回调函数
-          void             *io_cbdata,	// I  - 读取回调数据
-          _mxml_encoding_t *encoding)	// IO - 编码
+mxml_node_t *                // O - 第一个节点，如果无法读取文件，则为`NULL`。
+mxmlLoadIO(
+    mxml_node_t    *top,        // I - 顶级节点
+    mxml_options_t *options,    // I - 选项
+    mxml_io_cb_t   io_cb,        // I - 读取回调函数
+    void           *io_cbdata)    // I - 读取回调数据
 {
-  int		ch;			// 当前字符
-  unsigned char	buffer[4];		// 读取缓冲区
-
+  _mxml_read_t	r;			// 输入缓冲区
+  mxml_node_t	*ret;			// 第一个节点
 
-  // 获取下一个字符...
-  read_first_byte:
 
-  if ((io_cb)(io_cbdata, buffer, 1) != 1)
-    return (EOF);
+  // 范围检查输入...
+  if (!io_cb)
+    return (NULL);
 
-  ch = buffer[0];
+  // 读取XML数据...
+  if (!mxml_read_init(&r, options, io_cb, io_cbdata))
+    return (NULL);
 
-  switch (*encoding)
-  {
-    case _MXML_ENCODING_UTF8 :
-        // 获取到一个 UTF-8 字符；将 UTF-8 转换为 Unicode 并返回...
-	if (!(ch & 0x80))
-	{
-	  // ASCII
-	  break;
-        }
-	else if (ch == 0xfe)
-	{
-	  // UTF-16 大端字节顺序标记（BOM）？
-	  if ((io_cb)(io_cbdata, buffer + 1, 1) != 1)
-	    return (EOF);
+  ret = mxml_load_doc(top, options, &r, NULL, 0);
 
-	  if (buffer[1] != 0xff)
-	    return (EOF);
+  mxml_read_free(&r);
 
-          // 是的，切换到 UTF-16 大端字节顺序并尝试重新读取...
-	  *encoding = _MXML_ENCODING_UTF16BE;
+  return (ret);
+}
 
-	  goto read_first_byte;
-	}
-	else if (ch == 0xff)
-	{
-	  // UTF-16 小端字节顺序标记（BOM）？
-	  if ((io_cb)(io_cbdata, buffer + 1, 1) != 1)
-	    return (EOF);
 
-	  if (buffer[1] != 0xfe)
-	    return (EOF);
+//
+// 'mxmlLoadRecords（）' - 逐个加载记录元素。
+//
+// 此函数使用读取回调函数`io_cb`加载XML数据，但是不构建整个节点树：每个名为`name`的元素（`name`为
+// `NULL`时为根元素的每个子元素）在闭合标签之后从节点树中移除，作为独立的节点树传递给记录回调函数
+// `record_cb`，然后被删除。记录之外的节点（根元素、包装元素以及它们之间的文本等）在读取之后立即
+// 释放，因此根元素和包装元素不会积累子节点，使用的内存只取决于最大的单个记录，而不是整个文件。
+//
+// 记录回调函数接收回调数据指针和记录元素，返回`true`继续加载，返回`false`停止加载。如果需要在回调
+// 函数返回之后继续使用记录，请使用@link mxmlRetain@保留记录，并在不再需要时使用@link mxmlRelease@
+// 释放记录。记录中的同名元素属于外层的记录。
+//
+// 加载选项通过`options`参数提供，其中的SAX回调函数被忽略。启用内存池时，每个记录中的节点从该记录
+// 自己的内存池中分配，删除记录时一次性释放。
 
-          // 是的，切换到 UTF-16 小端字节顺序并尝试重新读取...
-	  *encoding = _MXML_ENCODING_UTF16LE;
+bool					// O - `true`表示成功，`false`表示出错
+mxmlLoadRecords(
+    mxml_options_t   *options,		// I - 选项
+    mxml_io_cb_t     io_cb,		// I - 读取回调函数
+    void             *io_cbdata,	// I - 读取回调数据
+    const char       *name,		// I - 记录元素的名称或`NULL`表示根元素的每个子元素
+    mxml_record_cb_t record_cb,		// I - 记录回调函数
+    void             *record_cbdata)	// I - 记录回调数据
+{
+  mxml_options_t	*defoptions,	// 默认选项
+			recoptions;	// 加载记录的选项
+  _mxml_records_t	rec;		// 逐个记录加载的状态
+  _mxml_read_t		r;		// 输入缓冲区
+  mxml_node_t		*node;		// 加载器返回的节点
 
-	  goto read_first_byte;
-	}
-	else if ((ch & 0xe0) == 0xc0)
-	{
-	  // 两字节值...
-	  if ((io_cb)(io_cbdata, buffer + 1, 1) != 1)
-	    return (EOF);
 
-	  if ((buffer[1] & 0xc0) != 0x80)
-	    return (EOF);
+  // 范围检查输入...
+  if (!io_cb || !record_cb)
+    return (false);
 
-	  ch = ((ch & 0x1f) << 6) | (buffer[1] & 0x3f);
+  // 使用调用者的选项，但是由SAX回调函数处理节点，记录之外的节点不使用内存池...
+  if (options)
+  {
+    recoptions = *options;
+  }
+  else if ((defoptions = mxmlOptionsNew()) != NULL)
+  {
+    recoptions = *defoptions;
+    mxmlOptionsDelete(defoptions);
+  }
+  else
+  {
+    return (false);
+  }
 
-	  if (ch < 0x80)
-	  {
-	    _mxml_error(options, "字符 0x%04x 的 UTF-8 序列无效。", ch);
-	    return (EOF);
-	  }
-	}
-	else if ((ch & 0xf0) == 0xe0)
-	{
-	  // 三字节值...
-	  if ((io_cb)(io_cbdata, buffer + 1, 2) != 2)
-	    return (EOF);
+  memset(&rec, 0, sizeof(rec));
 
-	  if ((buffer[1] & 0xc0) != 0x80 || (buffer[2] & 0xc0) != 0x80)
-	    return (EOF);
+  rec.options       = options;
+  rec.name          = name;
+  rec.record_cb     = record_cb;
+  rec.record_cbdata = record_cbdata;
+  rec.arena         = recoptions.arena;
+  rec.intern        = recoptions.intern;
 
-	  ch = ((ch & 0x0f) << 12) | ((buffer[1] & 0x3f) << 6) | (buffer[2] & 0x3f);
+  recoptions.arena         = false;
+  recoptions.sax_cb        = (mxml_sax_cb_t)mxml_records_sax;
+  recoptions.sax_cbdata    = &rec;
+  recoptions.sax_transient = false;
+  recoptions.error_cb      = (mxml_error_cb_t)mxml_records_error;
+  recoptions.error_cbdata  = &rec;
 
-	  if (ch < 0x800)
-	  {
-	    _mxml_error(options, "字符 0x%04x 的 UTF-8 序列无效。", ch);
-	    return (EOF);
-	  }
+  // 读取XML数据，SAX回调函数不保留记录之外的节点...
+  if (!mxml_read_init(&r, &recoptions, io_cb, io_cbdata))
+    return (false);
 
-          // 忽略字节顺序标记（BOM）...
-	  if (ch == 0xfeff)
-	    goto read_first_byte;
-	}
-	else if ((ch & 0xf8) == 0xf0)
-	{
-	  // 四字节值...
-	  if ((io_cb)(io_cbdata, buffer + 1, 3) != 3)
-	    return (EOF);
+  node = mxml_load_doc(/*top*/NULL, &recoptions, &r, NULL, 0);
+  mxml_read_free(&r);
 
-	  if ((buffer[1] & 0xc0) != 0x80 || (buffer[2] & 0xc0) != 0x80 || (buffer[3] & 0xc0) != 0x80)
-	    return (EOF);
+  // 释放加载器保留的第一个节点（<?xml ...?>），根元素本身是记录时它属于调用者...
+  if (node && node != rec.last)
+    mxmlRelease(node);
 
-	  ch = ((ch & 0x07) << 18) | ((buffer[1] & 0x3f) << 12) | ((buffer[2] & 0x3f) << 6) | (buffer[3] & 0x3f);
+  // 出错时未完成的记录已经被删除，恢复之前正在加载的文档并释放它的内存池...
+  if (rec.doc)
+  {
+    _mxml_global()->doc = rec.olddoc;
+    _mxml_doc_release(rec.doc);
+  }
 
-	  if (ch < 0x10000)
-	  {
-	    _mxml_error(options, "字符 0x%04x 的 UTF-8 序列无效。", ch);
-	    return (EOF);
-	  }
-	}
-	else
-	{
-	  return (EOF);
-	}
-	break;
+  if (rec.stopped)
+    mxmlRelease(rec.stopped);
 
-    case _MXML_ENCODING_UTF16BE :
-        // 读取 UTF-16 大端字符...
-	if ((io_cb)(io_cbdata, buffer + 1, 1) != 1)
-	  return (EOF);
+  return (!rec.error);
+}
 
-	ch = (ch << 8) | buffer[1];
 
-        if (ch >= 0xd800 && ch <= 0xdbff)
-	{
-	  // 多字节 UTF-16 字符...
-          int lch;			// 低位
+//
+// 'mxmlLoadString（）' - 将字符串加载到XML节点树中。
+//
+// 此函数将字符串加载到XML节点树中。指定文件中的节点将添加到指定节点`top`中 - 如果为`NULL`，则XML文件必须是格式良好的，以文件开头的单个父处理指令节点（例如`<?xml version =“1.0”？>）。
+//
+// 加载选项通过`options`参数提供。如果为`NULL`，所有值将加载到`MXML_TYPE_TEXT`节点中。在加载XML数据时，请使用@link mxmlOptionsNew@函数创建选项。
 
-	  if ((io_cb)(io_cbdata, buffer + 2, 2) != 2)
-	    return (EOF);
+mxml_node_t *                // O - 第一个节点或`NULL`（如果字符串有错误）。
+mxmlLoadString(
+    mxml_node_t    *top,        // I - 顶级节点
+    mxml_options_t *options,    // I - 选项
+    const char     *s)            // I - 要加载的字符串
+{
+  _mxml_read_t    r;            // 输入缓冲区
+  mxml_node_t     *ret;         // 第一个节点
 
-	  lch = (buffer[2] << 8) | buffer[3];
 
-          if (lch < 0xdc00 || lch >= 0xdfff)
-	    return (EOF);
+  // 范围检查输入...
+  if (!s)
+    return (NULL);
 
-          ch = (((ch & 0x3ff) << 10) | (lch & 0x3ff)) + 0x10000;
-	}
-	break;
+  // 直接从字符串中读取XML数据，无需复制...
+  _mxml_read_init_string(&r, s, strlen(s));
 
-    case _MXML_ENCODING_UTF16LE :
-        // 读取 UTF-16 小端字符...
-	if ((io_cb)(io_cbdata, buffer + 1, 1) != 1)
-	  return (EOF);
+  ret = mxml_load_doc(top, options, &r, NULL, 0);
 
-	ch |= buffer[1] << 8;
+  // 释放UTF-16数据转换后的缓冲区（如果有）...
+  mxml_read_free(&r);
 
-        if (ch >= 0xd800 && ch <= 0xdbff)
-	{
-	  // 多字节 UTF-16 字符...
-          int lch;			// 低位
+  return (ret);
+}
 
-	  if ((io_cb)(io_cbdata, buffer + 2, 2) != 2)
-	    return (EOF);
 
-	  lch = (buffer[3] << 8) | buffer[2];
+//
+// 'mxmlParserDelete（）' - 释放推送解析器。
+//
+// 此函数释放推送解析器`parser`使用的内存。如果没有调用@link mxmlParserFinish@，已经加载的节点也会被删除。
+//
 
-          if (lch < 0xdc00 || lch >= 0xdfff)
-	    return (EOF);
+void
+mxmlParserDelete(mxml_parser_t *parser)	// I - 推送解析器
+{
+  if (!parser)
+    return;
 
-          ch = (((ch & 0x3ff) << 10) | (lch & 0x3ff)) + 0x10000;
-	}
-	break;
-  }
+  if (!parser->ld.final && !parser->ld.error && (!parser->options || !parser->options->sax_cb))
+    mxmlDelete(parser->ld.first);
 
-  if (mxml_bad_char(ch))
-  {
-    _mxml_error(options, "XML 标准不允许使用的控制字符 0x%02x。", ch);
-    return (EOF);
-  }
+  _mxml_doc_release(parser->doc);
 
-  return (ch);
+  free(parser->buffer);
+  free(parser);
 }
 
 
 //
-// 'mxml_load_data()' - 将数据加载到 XML 节点树中。
+// 'mxmlParserFeed（）' - 向推送解析器提供更多的XML数据。
+//
+// 此函数将`bytes`字节的数据`data`提供给推送解析器`parser`。数据可以在任意位置拆分，包括多字节UTF-8序列、标签和实体的中间：解析器保存不完整的标记，并在提供更多数据后继续加载。每个完整的标记以及之前的字符数据会立即加载到节点树中，或者在设置了SAX回调时立即产生SAX事件。
+//
+// 如果数据有错误，则返回`false`，之后的调用也会失败。
 //
 
-static mxml_node_t *			// O - 第一个节点，如果无法读取 XML，则为 `NULL`。
-mxml_load_data(
-    mxml_node_t     *top,		// I - 顶级节点
-    mxml_options_t  *options,		// I - 选项
-    mxml_io_cb_t    io_cb,		// I - 读取回调函数
-    void            *io_cbdata)		// I - 读取回调数据
+bool					// O - `true`表示成功，`false`表示错误
+mxmlParserFeed(mxml_parser_t *parser,	// I - 推送解析器
+               const void    *data,	// I - 数据
+               size_t        bytes)	// I - 数据的字节数
 {
-  mxml_node_t	*node = NULL,		// 当前节点
-		*first = NULL,		// 添加的第一个节点
-		*parent = NULL;		// 当前父节点
-  int		line = 1,		// 当前行号
-		ch;			// 文件中的字符
-  bool		whitespace = false;	// 是否遇到空白字符？
-  char		*buffer,		// 字符串缓冲区
-		*bufptr;		// 缓冲区指针
-  size_t	bufsize;		// 缓冲区大小
-  mxml_type_t	type;			// 当前节点类型
-  _mxml_encoding_t encoding = _MXML_ENCODING_UTF8;
-					// 字符编码
-  static const char * const types[] =	// 类型字符串...
+  // 范围检查输入...
+  if (!parser || (!data && bytes) || parser->ld.error || parser->ld.final)
+    return (false);
+
+  // 将数据添加到缓冲区中...
+  if (bytes > (parser->bufsize - parser->bufused))
+  {
+    size_t		bufsize;	// 新的缓冲区大小
+    unsigned char	*buffer;	// 新的缓冲区
+
+    bufsize = parser->bufsize ? 2 * parser->bufsize : 1024;
+    if (bufsize < (parser->bufused + bytes))
+      bufsize = parser->bufused + bytes;
+
+    if ((buffer = realloc(parser->buffer, bufsize)) == NULL)
+    {
+      _mxml_error(parser->options, "无法分配推送解析器的缓冲区。");
+      parser->ld.error = true;
+      return (false);
+    }
+
+    parser->buffer  = buffer;
+    parser->bufsize = bufsize;
+  }
+
+  if (bytes)
+    memcpy(parser->buffer + parser->bufused, data, bytes);
+
+  parser->bufused += bytes;
+
+  // 查找完整的标记并加载它们...
+  mxml_parser_scan(parser);
+
+  if (parser->complete > 0)
+    mxml_parser_load(parser);
+
+  return (!parser->ld.error);
+}
+
+
+//
+// 'mxmlParserFinish（）' - 完成推送解析器的加载。
+//
+// 此函数加载推送解析器`parser`中剩余的数据并检查文档是否完整，然后返回与@link mxmlLoadString@相同的节点。之后仍需要使用@link mxmlParserDelete@释放解析器。
+//
+
+mxml_node_t *				// O - 第一个节点或`NULL`（如果数据有错误）
+mxmlParserFinish(mxml_parser_t *parser)	// I - 推送解析器
+{
+  // 范围检查输入...
+  if (!parser || parser->ld.error || parser->ld.final)
+    return (NULL);
+
+  // 加载剩余的所有数据...
+  parser->ld.final  = true;
+  parser->complete = parser->bufused;
+
+  if (!parser->ld.started && !parser->complete)
+    return (NULL);
+
+  return (mxml_parser_load(parser));
+}
+
+
+//
+// 'mxmlParserNew（）' - 创建推送解析器。
+//
+// 此函数创建一个推送解析器，用于加载分块到达的XML数据，例如从非阻塞套接字读取的数据。使用@link mxmlParserFeed@函数提供数据，使用@link mxmlParserFinish@函数完成加载，然后使用@link mxmlParserDelete@函数释放解析器。
+//
+// 节点将添加到指定节点`top`中 - 如果为`NULL`，则XML数据必须是格式良好的，以单个父处理指令节点开头（例如`<?xml version =“1.0”？>）。
+//
+// 加载选项通过`options`参数提供，并且在释放解析器之前必须保持有效。如果为`NULL`，所有值将加载到`MXML_TYPE_TEXT`节点中。
+//
+
+mxml_parser_t *				// O - 推送解析器或`NULL`（如果内存不足）
+mxmlParserNew(mxml_node_t    *top,	// I - 顶级节点
+              mxml_options_t *options)	// I - 选项
+{
+  mxml_parser_t	*parser;		// 推送解析器
+
+
+  if ((parser = (mxml_parser_t *)calloc(1, sizeof(mxml_parser_t))) == NULL)
+    return (NULL);
+
+  parser->top      = top;
+  parser->options  = options;
+  parser->encoding = _MXML_ENCODING_UTF8;
+  parser->state    = _MXML_SCAN_TEXT;
+
+  if (options && (options->arena || options->intern || (options->sax_cb && options->sax_transient)))
+  {
+    // 节点属于同一个文档...
+    if ((parser->doc = mxml_load_newdoc(options, NULL, 0)) == NULL)
+    {
+      free(parser);
+      return (NULL);
+    }
+  }
+
+  return (parser);
+}
+
+
+//
+// 'mxmlSaveAllocString（）' - 将XML树保存到分配的字符串中。
+//
+// 此函数将XML树`node`保存到分配的字符串中。使用`free`（或使用@link mxmlSetStringCallbacks@设置的字符串释放回调）释放字符串。
+//
+// 如果节点生成空字符串或无法分配字符串，则返回`NULL`。
+//
+// 保存选项通过`options`参数提供。如果为`NULL`，XML输出将在列72处换行，不添加额外的空格。请使用@link mxmlOptionsNew@函数创建保存XML数据的选项。
+
+char *                    // O - 分配的字符串或`NULL`
+mxmlSaveAllocString(
+    mxml_node_t    *node,        // I - 要写入的节点
+    mxml_options_t *options)    // I - 选项
+{
+  return (mxmlSaveAllocStringReserve(node, options, 0));
+}
+
+
+//
+// 'mxmlSaveAllocStringReserve（）' - 将XML树保存到预先分配了指定容量的字符串中。
+//
+// 此函数与@link mxmlSaveAllocString@相同，但是预先为字符串分配`bytes`字节（包括结尾的空字符），
+// 保存大小已知或可以估计的较大节点树（例如包含较大的Base64数据的元素）时可以避免扩展缓冲区。输出
+// 超过预留的容量时缓冲区仍然会自动扩展。`bytes`为0时使用默认的初始容量。
+//
+
+char *					// O - 分配的字符串或`NULL`
+mxmlSaveAllocStringReserve(
+    mxml_node_t    *node,		// I - 要写入的节点
+    mxml_options_t *options,		// I - 选项
+    size_t         bytes)		// I - 预先分配的字节数或0表示默认值
+{
+  _mxml_stringbuf_t    sb;        // 字符串缓冲区
+
+
+  // 设置字符串缓冲区
+  if (bytes < 1024)
+    bytes = 1024;
+
+  if ((sb.buffer = malloc(bytes)) == NULL)
+    return (NULL);
+
+  sb.bufptr   = sb.buffer;
+  sb.bufsize  = bytes;
+  sb.bufalloc = true;
+  sb.overflow = 0;
+
+  // 写入顶级节点...
+  if (!mxml_write_all(node, options, (mxml_io_cb_t)mxml_io_cb_string, &sb, /*newline*/false))
+  {
+    free(sb.buffer);
+    return (NULL);
+  }
+
+  // 以空字符结尾...
+  *(sb.bufptr) = '\0';
+
+  // 返回分配的字符串...
+  return (sb.buffer);
+}
+
+
+//
+// 'mxmlSaveFd（）' - 将XML树保存到文件描述符中。
+//
+// 此函数将XML树`node`保存到文件描述符中。
+//
+// 在支持`writev`的平台上，节点中不需要转义的较长的字符串（例如较大的文本和CDATA）不复制到输出缓冲区，
+// 而是与缓冲的标记一起使用`writev`直接从节点中写入。
+//
+// 保存选项通过`options`参数提供。如果为`NULL`，XML输出将在列72处换行，不添加额外的空格。请使用@link mxmlOptionsNew@函数创建保存XML数据的选项。
+
+bool                    // O - `true`表示成功，`false`表示错误。
+mxmlSaveFd(mxml_node_t    *node,    // I - 要写入的节点
+           mxml_options_t *options,    // I - 选项
+           int            fd)        // I - 要写入的文件描述符
+{
+  // 写入节点并确保文件以换行符结束...
+  return (mxml_write_all(node, options, (mxml_io_cb_t)_mxml_io_cb_fd, &fd, /*newline*/true));
+}
+
+
+//
+// 'mxmlSaveFile（）' - 将XML树保存到文件中。
+//
+// 此函数将XML树`node`保存到stdio `FILE`中。
+//
+// 保存选项通过`options`参数提供。如果为`NULL`，XML输出将在列72处换行，不添加额外的空格。请使用@link mxmlOptionsNew@函数创建保存XML数据的选项。
+
+bool                    // O - `true`表示成功，`false`表示错误。
+mxmlSaveFile(
+    mxml_node_t    *node,        // I - 要写入的节点
+    mxml_options_t *options,    // I - 选项
+    FILE           *fp)        // I - 要写入的文件
+{
+  // 写入节点并确保文件以换行符结束...
+  return (mxml_write_all(node, options, (mxml_io_cb_t)_mxml_io_cb_file, fp, /*newline*/true));
+}
+
+
+//
+// 'mxmlSaveFilename（）' - 将XML树保存到文件中。
+//
+// 此函数将XML树`node`保存到命名文件中。
+//
+// 保存选项通过`options`参数提供。如果为`NULL`，XML输出将在列72处换行，不添加额外的空格。请使用@link mxmlOptionsNew@函数创建保存XML数据的选项。
+
+bool                    // O - `true`表示成功，`false`表示错误。
+mxmlSaveFilename(
+    mxml_node_t    *node,        // I - 要写入的节点
+    mxml_options_t *options,    // I - 选项
+    const char     *filename)    // I - 要写入的文件
+{
+  bool        ret;            // 返回值
+  FILE        *fp;            // 文件指针
+
+
+  // 打开文件...
+  if ((fp = fopen(filename, "w")) == NULL)
+    return (false);
+
+  // 写入节点并确保文件以换行符结束...
+  ret = mxml_write_all(node, options, (mxml_io_cb_t)_mxml_io_cb_file, fp, /*newline*/true);
+
+  if (fclose(fp))
+    ret = false;
+
+  return (ret);
+}
+
+
+//
+// 'mxmlSaveIO（）' - 使用回调保存XML树。
+//
+// 此函数使用写回调函数`io_cb`保存XML树`node`。回调数据指针`io_cbdata`与缓冲区指针和要写入的字节数一起传递给写回调函数，例如：
+//
+// ```c
+// size_t my_io_cb(void *cbdata, const void *buffer, size_t bytes)
+// {
+//   ... 将字节从缓冲区写入输出 ...
+//   ... 返回写入/复制的字节数，错误时返回0 ...
+// }
+// ```
+//
+// 输出先收集到@link mxmlOptionsSetBufferSize@设置的大小的缓冲区中，写回调函数每次接收一个缓冲区的
+// 数据（较大的字符串直接传递）。写回调函数可以只写入部分数据，剩余的数据会再次传递。
+//
+// 保存选项通过`options`参数提供。如果为`NULL`，XML输出将在列72处换行，不添加额外的空格。请使用@link mxmlOptionsNew@函数创建保存XML数据的选项。
+
+bool                    // O - `true`表示成功，`false`表示错误。
+mxmlSaveIO(
+    mxml_node_t    *node,        // I - 要写入的节点
+    mxml_options_t *options,    // I - 选项
+    mxml_io_cb_t   io_cb,        // I - 写回调函数
+    void           *io_cbdata)    // I - 写回调数据
+{
+  // 范围检查输入...
+  if (!node || !io_cb)
+    return (false);
+
+  // 写入节点并确保文件以换行符结束...
+  return (mxml_write_all(node, options, io_cb, io_cbdata, /*newline*/true));
+}
+
+
+//
+// 'mxmlSaveMeasure（）' - 计算保存XML树需要的字节数。
+//
+// 此函数使用与@link mxmlSaveString@相同的代码遍历XML树`node`，包括实体转义、换行和空白字符回调，
+// 但是不写入任何数据，返回保存的字符串的字节数（不包括结尾的空字符）。使用至少“返回值+1”字节的
+// 缓冲区调用@link mxmlSaveString@可以保存完整的XML树。
+//
+// 空白字符回调和自定义数据的保存回调在计算和保存时都会调用，对于相同的节点必须返回相同的字符串。
+//
+// 保存选项通过`options`参数提供。如果为`NULL`，XML输出将在列72处换行，不添加额外的空格。
+//
+
+size_t					// O - 输出的字节数或0（如果出错）
+mxmlSaveMeasure(
+    mxml_node_t    *node,		// I - 要写入的节点
+    mxml_options_t *options)		// I - 选项
+{
+  return (mxmlSaveString(node, options, NULL, 0));
+}
+
+
+//
+// 'mxmlSaveParallel（）' - 使用多个线程保存XML树。
+//
+// 此函数与@link mxmlSaveIO@相同，但是将根元素（或者从顶级节点开始子节点最多的元素）的子节点分为多段，
+// 使用最多`nthreads`个线程（包括调用者的线程）写入各自的缓冲区，然后按照文档的顺序传递给写回调函数。
+// 写回调函数只在调用者的线程中调用。`nthreads`为0时使用在线的处理器数量。
+//
+// 每段只从元素、注释、声明或处理指令之后的子节点开始。换行边距不大于0时这里的列状态是确定的；缩进时
+// 每个子节点都从新的一行开始，换行之后的列数也是确定的，因此输出与@link mxmlSaveIO@完全相同。换行
+// 边距大于0并且不缩进时，段开头的列数取决于之前的所有输出，空白回调函数的输出也无法预先确定，因此这些
+// 选项、包含延迟加载的内容的节点树以及没有线程支持的平台总是串行保存。
+//
+// 自定义数据的保存回调函数可能在其他线程中并发调用，并且必须是线程安全的。
+//
+
+bool					// O - `true`表示成功，`false`表示错误
+mxmlSaveParallel(
+    mxml_node_t    *node,		// I - 要写入的节点
+    mxml_options_t *options,		// I - 选项
+    mxml_io_cb_t   io_cb,		// I - 写回调函数
+    void           *io_cbdata,		// I - 写回调数据
+    int            nthreads)		// I - 线程数，0表示处理器的数量
+{
+#ifdef HAVE_PTHREAD_H
+  _mxml_save_t	save;			// 并行保存的状态
+  _mxml_write_t	w;			// 输出缓冲区
+  pthread_t	*threads = NULL;	// 写入的线程
+  bool		*started = NULL;	// 是否创建了线程？
+  mxml_indent_t	indent = options ? options->indent : MXML_INDENT_NONE;
+					// 缩进方式
+  mxml_node_t	*current,		// 当前元素
+		*next,			// 子节点最多的子元素
+		*child,			// 当前子节点
+		*grandchild;		// 子元素的子节点
+  size_t	i,			// 循环变量
+		children,		// 子节点数
+		nextchildren,		// 子元素的子节点数
+		limit,			// 计算的最大子节点数
+		count;			// 拆分的元素的子节点数
+  int		depth,			// 子节点的缩进级别
+		col;			// 当前列
+  bool		parallel = false,	// 是否并行保存？
+		ret = false;		// 返回值
+
+
+  // 范围检查输入...
+  if (!node || !io_cb)
+    return (false);
+
+  if (nthreads <= 0)
+    nthreads = (int)sysconf(_SC_NPROCESSORS_ONLN);
+
+  // 不缩进时换行边距和空白回调函数使段开头的列数无法确定，延迟的内容需要在调用者的线程中加载...
+  if (nthreads < 2 || (options && indent == MXML_INDENT_NONE && (options->wrap > 0 || options->ws_cb)) || (node->doc && node->doc->lazy))
+    return (mxmlSaveIO(node, options, io_cb, io_cbdata));
+
+  // 从顶级节点开始，只要子节点不够多就进入子节点最多的子元素；内容保持在一行的元素中没有缩进，不能拆分。
+  // 子节点只计算到足够分段为止...
+  memset(&save, 0, sizeof(save));
+
+  limit = (size_t)(8 * nthreads) * MXML_PART_NODES;
+
+  for (current = node, depth = 0, count = 0; current; current = next)
+  {
+    if (current->type == MXML_TYPE_ELEMENT)
+    {
+      if (indent != MXML_INDENT_NONE && mxml_write_inline(current, indent))
+        break;
+
+      save.parent = current;
+      save.depth  = ++ depth;
+    }
+
+    for (child = current->child, children = 0; child && children < limit; child = child->next)
+      children ++;
+
+    if (current == save.parent)
+      count = children;
+
+    if (current == save.parent && children >= (size_t)(2 * nthreads))
+      break;
+
+    for (child = current->child, next = NULL; child; child = child->next)
+    {
+      if (child->type != MXML_TYPE_ELEMENT)
+        continue;
+
+      for (grandchild = child->child, nextchildren = 0; grandchild && nextchildren < limit; grandchild = grandchild->next)
+        nextchildren ++;
+
+      if (nextchildren > children)
+      {
+        next     = child;
+        children = nextchildren;
+      }
+    }
+  }
+
+  if (!save.parent || count < 2 || (save.parent->doc && save.parent->doc->lazy))
+    return (mxmlSaveIO(node, options, io_cb, io_cbdata));
+
+  // 将子节点分为大约`nthreads`的8倍的段，每段最多大约`MXML_PART_NODES`个子节点...
+  if ((save.run = count / (size_t)(8 * nthreads)) < 1)
+    save.run = 1;
+
+  save.next = save.parent->child;
+
+  // 分配缓冲区并创建线程...
+  save.options = options;
+  save.window  = 2 * (size_t)nthreads;
+
+  if ((save.parts = calloc(save.window, sizeof(_mxml_save_part_t))) == NULL || (threads = calloc((size_t)nthreads - 1, sizeof(pthread_t))) == NULL || (started = calloc((size_t)nthreads - 1, sizeof(bool))) == NULL)
+    goto serial;
+
+  for (i = 0; i < save.window; i ++)
+  {
+    if ((save.parts[i].sb.buffer = malloc(MXML_BUFSIZE)) == NULL)
+      goto serial;
+
+    save.parts[i].sb.bufsize  = MXML_BUFSIZE;
+    save.parts[i].sb.bufalloc = true;
+  }
+
+  parallel = true;
+
+  pthread_mutex_init(&save.mutex, NULL);
+  pthread_cond_init(&save.cond, NULL);
+
+  for (i = 0; i < (size_t)nthreads - 1; i ++)
+    started[i] = !pthread_create(threads + i, NULL, (void *(*)(void *))mxml_save_thread, &save);
+
+  // 写入节点并确保文件以换行符结束，到达拆分的元素时按照顺序写入各段...
+  if (_mxml_write_init(&w, options, io_cb, io_cbdata))
+  {
+    w.save = &save;
+    col    = mxml_write_node(node, node, options, &w, /*depth*/0, 0);
+
+    if (col > 0)
+      col = _mxml_write_string("\n", &w, /*use_entities*/false, col);
+
+    ret = col >= 0 && _mxml_write_flush(&w);
+
+    _mxml_write_free(&w);
+  }
+
+  // 停止线程...
+  pthread_mutex_lock(&save.mutex);
+  save.error = true;
+  pthread_cond_broadcast(&save.cond);
+  pthread_mutex_unlock(&save.mutex);
+
+  for (i = 0; i < (size_t)nthreads - 1; i ++)
+  {
+    if (started[i])
+      pthread_join(threads[i], NULL);
+  }
+
+  pthread_cond_destroy(&save.cond);
+  pthread_mutex_destroy(&save.mutex);
+
+  // 释放内存，如果无法并行保存则串行保存...
+  serial:
+
+  if (save.parts)
+  {
+    for (i = 0; i < save.window; i ++)
+      free(save.parts[i].sb.buffer);
+
+    free(save.parts);
+  }
+
+  free(threads);
+  free(started);
+
+  if (!parallel)
+    ret = mxmlSaveIO(node, options, io_cb, io_cbdata);
+
+  return (ret);
+
+#else
+  (void)nthreads;
+
+  return (mxmlSaveIO(node, options, io_cb, io_cbdata));
+#endif // HAVE_PTHREAD_H
+}
+
+
+//
+// 'mxmlSaveString（）' - 将XML节点树保存到字符串中。
+//
+// 此函数将XML树`node`保存到固定大小的字符串缓冲区中。与`snprintf`相同，返回值是完整的输出的字节数
+// （不包括结尾的空字符）。如果返回值大于或等于`bufsize`，输出被截断，使用至少“返回值+1”字节的
+// 缓冲区再次保存即可得到完整的输出。`bufsize`为0时`buffer`可以为`NULL`，只计算输出的大小（与
+// @link mxmlSaveMeasure@相同）。
+//
+// 保存选项通过`options`参数提供。如果为`NULL`，XML输出将在列72处换行，不添加额外的空格。请使用@link mxmlOptionsNew@函数创建保存XML数据的选项。
+
+size_t                    // O - 输出的字节数或0（如果出错）
+mxmlSaveString(
+    mxml_node_t    *node,        // I - 要写入的节点
+    mxml_options_t *options,    // I - 选项
+    char           *buffer,    // I - 字符串缓冲区
+    size_t         bufsize)    // I - 字符串缓冲区的大小
+{
+  _mxml_stringbuf_t    sb;        // 字符串缓冲区
+
+
+  // 设置字符串缓冲区...
+  sb.buffer   = buffer;
+  sb.bufptr   = buffer;
+  sb.bufsize  = bufsize;
+  sb.bufalloc = false;
+  sb.overflow = 0;
+
+  // 写入节点...
+  if (!mxml_write_all(node, options, (mxml_io_cb_t)mxml_io_cb_string, &sb, /*newline*/false))
+    return (false);
+
+  // 以空字符结尾...
+  if (sb.bufsize > 0)
+    *(sb.bufptr) = '\0';
+
+  // 返回完整的输出的字符数...
+  return ((size_t)(sb.bufptr - sb.buffer) + sb.overflow);
+}
+
+
+//
+// '_mxml_node_expand()' - 加载元素延迟的内容。
+//
+// 内容使用加载文档时的选项加载，其中更深的元素的内容再次延迟。出错时元素没有子节点，并且保留延迟的内容
+// 作为错误标记，以后的访问不再重新加载，@link mxmlElementExpand@返回`false`。
+//
+
+void
+_mxml_node_expand(mxml_node_t *node)	// I - 元素
+{
+  _mxml_lazy_t		*lazy = node->value.element.lazy;
+					// 延迟的内容
+  _mxml_doc_t		*doc = node->doc,
+					// 所属文档
+			*olddoc;	// 之前正在加载的文档
+  _mxml_global_t	*global = _mxml_global();
+					// 全局数据
+  _mxml_read_t		r;		// 输入缓冲区
+  bool			ret;		// 是否加载成功？
+
+
+  if (lazy->error)
+    return;
+
+  // 首先清除延迟的内容，添加子节点时不会再次加载...
+  node->value.element.lazy = NULL;
+
+  _mxml_read_init_string(&r, doc->source + lazy->start, lazy->end - lazy->start);
+  r.insitu = doc->insitu_start != NULL;
+  r.line   = lazy->line;
+  r.lazy   = true;
+
+  olddoc      = global->doc;
+  global->doc = doc;
+
+  ret = mxml_load_data(node, doc->lazy, &r, /*ld*/NULL) != NULL;
+
+  global->doc = olddoc;
+
+  mxml_read_free(&r);
+
+  if (!ret)
+  {
+    // 删除部分加载的内容并标记错误...
+    while (node->child)
+      mxmlDelete(node->child);
+
+    lazy->error              = true;
+    node->value.element.lazy = lazy;
+  }
+  else if (!doc->arena)
+  {
+    free(lazy);
+  }
+}
+
+
+//
+// '_mxml_get_entity（）' - 获取与实体对应的字符...
+//
+
+int					// O  - 字符值或错误时为`EOF`
+_mxml_get_entity(
+    mxml_options_t   *options,        // I  - 选项
+    _mxml_read_t     *r,        // IO - 输入缓冲区
+    mxml_node_t      *parent,        // I  - 父节点
+    int              *line)        // IO - 当前行号
+{
+  int    ch;            // 当前字符
+  char    entity[64],        // 实体字符串
+    *entptr;        // 实体指针
+
+
+  // 读取HTML字符实体，格式为“&NAME;”，“&#NUMBER;”或“&#xHEX”...
+  entptr = entity;
+
+  while ((ch = _mxml_getc(options, r)) != EOF)
+  {
+    if (ch > 126 || (!isalnum(ch) && ch != '#'))
+    {
+      break;
+    }
+    else if (entptr < (entity + sizeof(entity) - 1))
+    {
+      *entptr++ = ch;
+    }
+    else
+    {
+      _mxml_error(options, "父节点<%s>下的实体名称过长，位于第%d行。", mxmlGetElement(parent), *line);
+      break;
+    }
+  }
+
+  *entptr = '\0';
+
+  if (ch != ';')
+  {
+    _mxml_error(options, "父节点<%s>下的字符实体“%s”未终止，位于第%d行。", entity, mxmlGetElement(parent), *line);
+
+    if (ch == '\n')
+      (*line)++;
+
+    return (EOF);
+  }
+
+  if ((ch = _mxml_entity_value(options, entity)) < 0)
+  {
+    _mxml_error(options, "父节点<%s>下的实体“&%s;”不受支持，位于第%d行。", entity, mxmlGetElement(parent), *line);
+    return (EOF);
+  }
+
+  if (MXML_BAD_CHAR(ch))
+  {
+    _mxml_error(options, "父节点<%s>下的控制字符0x%02x不符合XML标准，位于第%d行。", ch, mxmlGetElement(parent), *line);
+    return (EOF);
+  }
+
+  return (ch);
+}
+
+
+//
+// '_mxml_getc()' - 从输入缓冲区中读取一个字符。
+//
+
+int					// O  - 字符或 `EOF`
+_mxml_getc(mxml_options_t *options,	// I  - 选项
+           _mxml_read_t   *r)		// IO - 输入缓冲区
+{
+  int		ch;			// 当前字符
+  unsigned char	*bufptr;		// 指向多字节序列的指针
+
+
+  // 获取下一个字符，UTF-16数据在读取时已经转换为UTF-8...
+  read_first_byte:
+
+  if (r->bufptr >= r->bufend && !mxml_read_fill(r, 1))
+    return (EOF);
+
+  ch = *(r->bufptr)++;
+
+  // 获取到一个 UTF-8 字符；将 UTF-8 转换为 Unicode 并返回...
+  if (!(ch & 0x80))
+  {
+    // ASCII
+  }
+  else if ((ch & 0xe0) == 0xc0)
+  {
+    // 两字节值...
+    if (r->bufptr >= r->bufend && mxml_read_fill(r, 1) < 1)
+      return (EOF);
+
+    bufptr    = r->bufptr;
+    r->bufptr += 1;
+
+    if ((bufptr[0] & 0xc0) != 0x80)
+      return (EOF);
+
+    ch = ((ch & 0x1f) << 6) | (bufptr[0] & 0x3f);
+
+    if (ch < 0x80)
+    {
+      _mxml_error(options, "字符 0x%04x 的 UTF-8 序列无效。", ch);
+      return (EOF);
+    }
+  }
+  else if ((ch & 0xf0) == 0xe0)
+  {
+    // 三字节值...
+    if ((r->bufend - r->bufptr) < 2 && mxml_read_fill(r, 2) < 2)
+      return (EOF);
+
+    bufptr    = r->bufptr;
+    r->bufptr += 2;
+
+    if ((bufptr[0] & 0xc0) != 0x80 || (bufptr[1] & 0xc0) != 0x80)
+      return (EOF);
+
+    ch = ((ch & 0x0f) << 12) | ((bufptr[0] & 0x3f) << 6) | (bufptr[1] & 0x3f);
+
+    if (ch < 0x800)
+    {
+      _mxml_error(options, "字符 0x%04x 的 UTF-8 序列无效。", ch);
+      return (EOF);
+    }
+
+    // 忽略字节顺序标记（BOM）...
+    if (ch == 0xfeff)
+      goto read_first_byte;
+  }
+  else if ((ch & 0xf8) == 0xf0)
+  {
+    // 四字节值...
+    if ((r->bufend - r->bufptr) < 3 && mxml_read_fill(r, 3) < 3)
+      return (EOF);
+
+    bufptr    = r->bufptr;
+    r->bufptr += 3;
+
+    if ((bufptr[0] & 0xc0) != 0x80 || (bufptr[1] & 0xc0) != 0x80 || (bufptr[2] & 0xc0) != 0x80)
+      return (EOF);
+
+    ch = ((ch & 0x07) << 18) | ((bufptr[0] & 0x3f) << 12) | ((bufptr[1] & 0x3f) << 6) | (bufptr[2] & 0x3f);
+
+    if (ch < 0x10000)
+    {
+      _mxml_error(options, "字符 0x%04x 的 UTF-8 序列无效。", ch);
+      return (EOF);
+    }
+  }
+  else
+  {
+    // 无效的首字节，包括数据中间的UTF-16字节顺序标记...
+    return (EOF);
+  }
+
+  if (MXML_BAD_CHAR(ch))
+  {
+    _mxml_error(options, "XML 标准不允许使用的控制字符 0x%02x。", ch);
+    return (EOF);
+  }
+
+  return (ch);
+}
+
+
+//
+// '_mxml_io_cb_fd()' - 将字节写入文件描述符。
+//
+
+size_t					// O - 写入的字节数
+_mxml_io_cb_fd(int    *fd,		// I - 文件描述符
+               void   *buffer,		// I - 缓冲区
+               size_t bytes)		// I - 要写入的字节数
+{
+#if _WIN32
+  int		wbytes;			// 写入的字节数
+
+
+  wbytes = write(*fd, buffer, bytes);
+
+#else
+  ssize_t	wbytes;			// 写入的字节数
+
+
+  while ((wbytes = write(*fd, buffer, bytes)) < 0)
+  {
+    if (errno != EINTR && errno != EAGAIN)
+      break;
+  }
+#endif // _WIN32
+
+  if (wbytes < 0)
+    return (0);
+  else
+    return ((size_t)wbytes);
+}
+
+
+//
+// '_mxml_io_cb_file()' - 将字节写入文件指针。
+//
+
+size_t					// O - 写入的字节数
+_mxml_io_cb_file(FILE   *fp,		// I - 文件指针
+                 void   *buffer,	// I - 缓冲区
+                 size_t bytes)		// I - 要写入的字节数
+{
+  return (fwrite(buffer, 1, bytes, fp));
+}
+
+
+//
+// '_mxml_put_utf8()' - 将字符编码为UTF-8。
+//
+
+char *					// O - 编码后的位置
+_mxml_put_utf8(char *s,			// I - 输出位置，至少4个字节
+               int  ch)			// I - 字符
+{
+  if (ch < 0x80)
+  {
+    // 单字节ASCII...
+    *s++ = ch;
+  }
+  else if (ch < 0x800)
+  {
+    // 两字节UTF-8...
+    *s++ = 0xc0 | (ch >> 6);
+    *s++ = 0x80 | (ch & 0x3f);
+  }
+  else if (ch < 0x10000)
+  {
+    // 三字节UTF-8...
+    *s++ = 0xe0 | (ch >> 12);
+    *s++ = 0x80 | ((ch >> 6) & 0x3f);
+    *s++ = 0x80 | (ch & 0x3f);
+  }
+  else
+  {
+    // 四字节UTF-8...
+    *s++ = 0xf0 | (ch >> 18);
+    *s++ = 0x80 | ((ch >> 12) & 0x3f);
+    *s++ = 0x80 | ((ch >> 6) & 0x3f);
+    *s++ = 0x80 | (ch & 0x3f);
+  }
+
+  return (s);
+}
+
+
+//
+// '_mxml_read_init_string()' - 为内存中的数据初始化输入缓冲区。
+//
+
+void
+_mxml_read_init_string(_mxml_read_t *r,	// I - 输入缓冲区
+                       const char   *s,	// I - 数据
+                       size_t       bytes)// I - 数据的字节数
+{
+  r->io_cb     = NULL;
+  r->io_cbdata = NULL;
+  r->encoding  = _MXML_ENCODING_UTF8;
+  r->buffer    = (unsigned char *)s;
+  r->bufptr    = r->buffer;
+  r->bufend    = r->buffer + bytes;
+  r->bufsize   = bytes;
+  r->readsize  = 0;
+  r->bufalloc  = false;
+  r->bufmap    = false;
+  r->insitu    = false;
+  r->raw       = NULL;
+  r->line      = 1;
+  r->lazy      = false;
+  r->context   = NULL;
+}
+
+
+//
+// '_mxml_scan_utf8()' - 查找第一个不是普通字符的字节，包括有效的多字节UTF-8字符。
+//
+// 与@link mxml_scan@相同，但是也跳过@link _mxml_getc@接受的多字节字符。无效的序列、不完整的序列和
+// 字节顺序标记（U+FEFF）仍然由@link _mxml_getc@处理。
+//
+
+size_t					// O - 普通字符的字节数
+_mxml_scan_utf8(const unsigned char *s,	// I - 开始位置
+                const unsigned char *end,// I - 数据的结尾
+                int                 d1,	// I - 第一个终止字符
+                int                 d2,	// I - 第二个终止字符
+                int                 d3)	// I - 第三个终止字符
+{
+  const unsigned char	*ptr = s,	// 当前位置
+			*start;		// 多字节字符的开头
+
+
+  for (;;)
+  {
+    // 一次跳过16或32个ASCII字符...
+    ptr   += mxml_scan(ptr, end, d1, d2, d3);
+    start = ptr;
+
+    // 逐个验证多字节字符...
+    while (ptr < end && *ptr >= 0xc2)
+    {
+      if (*ptr < 0xe0)
+      {
+        if ((end - ptr) < 2 || (ptr[1] & 0xc0) != 0x80)
+          break;
+
+        ptr += 2;
+      }
+      else if (*ptr < 0xf0)
+      {
+        // 拒绝过长的编码和字节顺序标记（EF BB BF）...
+        if ((end - ptr) < 3 || (ptr[1] & 0xc0) != 0x80 || (ptr[2] & 0xc0) != 0x80 || (ptr[0] == 0xe0 && ptr[1] < 0xa0) || (ptr[0] == 0xef && ptr[1] == 0xbb && ptr[2] == 0xbf))
+          break;
+
+        ptr += 3;
+      }
+      else if (*ptr < 0xf8)
+      {
+        if ((end - ptr) < 4 || (ptr[1] & 0xc0) != 0x80 || (ptr[2] & 0xc0) != 0x80 || (ptr[3] & 0xc0) != 0x80 || (ptr[0] == 0xf0 && ptr[1] < 0x90))
+          break;
+
+        ptr += 4;
+      }
+      else
+      {
+        break;
+      }
+    }
+
+    if (ptr == start)
+      return ((size_t)(ptr - s));
+  }
+}
+
+
+//
+// '_mxml_utf16_convert()' - 将UTF-16数据转换为UTF-8。
+//
+// 转换尽可能多的完整字符，在数据结尾的不完整字符、无效的代理对或输出缓冲区已满时停止。支持时使用
+// SSE2一次转换8个ASCII代码单元。
+//
+
+size_t					// O  - 输出的字节数
+_mxml_utf16_convert(
+    unsigned char    *dst,		// I  - 输出缓冲区
+    size_t           dstsize,		// I  - 输出缓冲区的大小
+    unsigned char    **src,		// IO - UTF-16数据中的当前位置
+    unsigned char    *srcend,		// I  - UTF-16数据的结尾
+    _mxml_encoding_t encoding)		// I  - UTF-16字节顺序
+{
+  unsigned char	*dstptr = dst,		// 输出位置
+		*dstend = dst + dstsize,// 输出缓冲区的结尾
+		*srcptr = *src;		// UTF-16数据中的当前位置
+  int		ch,			// 当前字符
+		lch;			// 代理对的低位
+#ifdef MXML_SCAN_SSE2
+  __m128i	data;			// 当前的8个代码单元
+  int		scalar = 0;		// 重新尝试SSE2之前逐个转换的代码单元数
+#endif // MXML_SCAN_SSE2
+
+
+  while ((srcend - srcptr) >= 2 && (dstend - dstptr) >= 4)
+  {
+#ifdef MXML_SCAN_SSE2
+    if (scalar > 0)
+    {
+      scalar --;
+    }
+    else if ((srcend - srcptr) >= 16 && (dstend - dstptr) >= 8)
+    {
+      data = _mm_loadu_si128((const __m128i *)srcptr);
+
+      if (encoding == _MXML_ENCODING_UTF16BE)
+        data = _mm_or_si128(_mm_slli_epi16(data, 8), _mm_srli_epi16(data, 8));
+
+      if (_mm_movemask_epi8(_mm_cmpeq_epi16(_mm_and_si128(data, _mm_set1_epi16((short)0xff80)), _mm_setzero_si128())) == 0xffff)
+      {
+        // 8个ASCII字符...
+        _mm_storel_epi64((__m128i *)dstptr, _mm_packus_epi16(data, data));
+        srcptr += 16;
+        dstptr += 8;
+        continue;
+      }
+
+      // 不是纯ASCII，逐个转换这8个代码单元...
+      scalar = 7;
+    }
+#endif // MXML_SCAN_SSE2
+
+    if (encoding == _MXML_ENCODING_UTF16BE)
+      ch = (srcptr[0] << 8) | srcptr[1];
+    else
+      ch = (srcptr[1] << 8) | srcptr[0];
+
+    if (ch < 0x80)
+    {
+      // 单字节ASCII...
+      *dstptr++ = (unsigned char)ch;
+      srcptr += 2;
+      continue;
+    }
+    else if (ch < 0x800)
+    {
+      // 两字节UTF-8...
+      *dstptr++ = (unsigned char)(0xc0 | (ch >> 6));
+      *dstptr++ = (unsigned char)(0x80 | (ch & 0x3f));
+      srcptr += 2;
+      continue;
+    }
+    else if (ch >= 0xd800 && ch <= 0xdbff)
+    {
+      // 代理对...
+      if ((srcend - srcptr) < 4)
+        break;
+
+      if (encoding == _MXML_ENCODING_UTF16BE)
+        lch = (srcptr[2] << 8) | srcptr[3];
+      else
+        lch = (srcptr[3] << 8) | srcptr[2];
+
+      if (lch < 0xdc00 || lch > 0xdfff)
+        break;
+
+      ch     = (((ch & 0x3ff) << 10) | (lch & 0x3ff)) + 0x10000;
+      srcptr += 4;
+    }
+    else
+    {
+      srcptr += 2;
+    }
+
+    dstptr = (unsigned char *)_mxml_put_utf8((char *)dstptr, ch);
+  }
+
+  *src = srcptr;
+
+  return ((size_t)(dstptr - dst));
+}
+
+
+//
+// '_mxml_write_flush()' - 写入输出缓冲区中的数据。
+//
+// 写入回调函数可以只写入部分数据，返回0表示错误。
+//
+
+bool					// O - `true`表示成功，`false`表示错误
+_mxml_write_flush(_mxml_write_t *w)	// I - 输出缓冲区
+{
+  char		*ptr;			// 缓冲区中的当前位置
+  size_t	wbytes;			// 写入的字节数
+
+
+#ifdef MXML_WRITEV
+  if (w->num_iov > 0)
+  {
+    // 使用`writev`写入引用的字符串和缓冲的数据...
+    struct iovec *iov = w->iov;		// 当前数据段
+    int		num_iov;		// 剩余的数据段数
+    ssize_t	vbytes;			// 写入的字节数
+
+    if (w->bufptr > w->bufstart)
+    {
+      w->iov[w->num_iov].iov_base = w->bufstart;
+      w->iov[w->num_iov].iov_len  = (size_t)(w->bufptr - w->bufstart);
+      w->num_iov ++;
+    }
+
+    for (num_iov = w->num_iov; num_iov > 0;)
+    {
+      if ((vbytes = writev(w->fd, iov, num_iov)) < 0)
+      {
+        if (errno != EINTR && errno != EAGAIN)
+          break;
+
+        continue;
+      }
+      else if (vbytes == 0)
+      {
+        break;
+      }
+
+      // 跳过已经写入的数据段...
+      for (; num_iov > 0 && (size_t)vbytes >= iov->iov_len; vbytes -= (ssize_t)iov->iov_len, iov ++, num_iov --);
+
+      if (num_iov > 0)
+      {
+        iov->iov_base = (char *)iov->iov_base + vbytes;
+        iov->iov_len  -= (size_t)vbytes;
+      }
+    }
+
+    w->num_iov  = 0;
+    w->bufptr   = w->buffer;
+    w->bufstart = w->buffer;
+
+    return (num_iov == 0);
+  }
+
+  w->bufstart = w->buffer;
+#endif // MXML_WRITEV
+
+  for (ptr = w->buffer; ptr < w->bufptr; ptr += wbytes)
+  {
+    if ((wbytes = (w->io_cb)(w->io_cbdata, ptr, (size_t)(w->bufptr - ptr))) == 0 || wbytes > (size_t)(w->bufptr - ptr))
+    {
+      // 丢弃缓冲的数据...
+      w->bufptr = w->buffer;
+      return (false);
+    }
+  }
+
+  w->bufptr = w->buffer;
+
+  return (true);
+}
+
+
+//
+// '_mxml_write_free()' - 释放输出缓冲区。
+//
+
+void
+_mxml_write_free(_mxml_write_t *w)	// I - 输出缓冲区
+{
+  if (w->bufalloc)
+    free(w->buffer);
+}
+
+
+//
+// '_mxml_write_indent()' - 换行并写入指定级别的缩进。
+//
+// 换行符和缩进从预先生成的字符串中一次写入。如果输出已经在行首，则只写入缩进。
+//
+
+int					// O - 新的列数，错误时为 `-1`
+_mxml_write_indent(
+    mxml_options_t *options,		// I - 选项
+    _mxml_write_t  *w,			// I - 输出缓冲区
+    int            depth,		// I - 缩进级别
+    int            col)			// I - 当前列数
+{
+  static const char spaces[] = "\n                                                                ";
+					// 换行符和缩进的空格
+  static const char tabs[] = "\n\t\t\t\t\t\t\t\t\t\t\t\t\t\t\t\t";
+					// 换行符和缩进的制表符
+  const char	*s;			// 换行符和缩进字符串
+  size_t	bytes,			// 剩余的缩进字节数
+		chunk,			// 每次写入的缩进字节数
+		max;			// 缩进字符串的长度
+
+
+  if (col < 0)
+    return (-1);
+
+  if (options->indent_width > 0)
+  {
+    s     = spaces;
+    max   = sizeof(spaces) - 2;
+    bytes = (size_t)depth * (size_t)options->indent_width;
+  }
+  else
+  {
+    s     = tabs;
+    max   = sizeof(tabs) - 2;
+    bytes = (size_t)depth;
+  }
+
+  // 写入换行符（如果需要）和第一段缩进...
+  chunk = bytes < max ? bytes : max;
+
+  if (col > 0 ? !mxml_write_data(w, s, chunk + 1) : (chunk > 0 && !mxml_write_data(w, s + 1, chunk)))
+    return (-1);
+
+  // 写入剩余的缩进...
+  for (bytes -= chunk; bytes > 0; bytes -= chunk)
+  {
+    chunk = bytes < max ? bytes : max;
+
+    if (!mxml_write_data(w, s + 1, chunk))
+      return (-1);
+  }
+
+  if (!w->columns)
+    return (depth > 0 ? 1 : 0);
+  else if (options->indent_width > 0)
+    return (depth * options->indent_width);
+  else
+    return (depth * MXML_TAB);
+}
+
+
+//
+// '_mxml_write_init()' - 初始化输出缓冲区。
+//
+// 保存到文件和使用写入回调函数时使用选项中的I/O缓冲区大小，保存到字符串时使用本地缓冲区。
+//
+
+bool					// O - `true`表示成功，`false`表示错误
+_mxml_write_init(
+    _mxml_write_t  *w,			// I - 输出缓冲区
+    mxml_options_t *options,		// I - 选项
+    mxml_io_cb_t   io_cb,		// I - 写入回调函数
+    void           *io_cbdata)		// I - 写入回调数据
+{
+  size_t	bufsize;		// 缓冲区大小
+
+
+  if (io_cb == (mxml_io_cb_t)mxml_io_cb_string)
+    bufsize = sizeof(w->local);
+  else
+    bufsize = options && options->bufsize ? options->bufsize : MXML_BUFSIZE;
+
+  w->io_cb     = io_cb;
+  w->io_cbdata = io_cbdata;
+  w->columns   = options && options->wrap > 0;
+  w->save      = NULL;
+#ifdef MXML_WRITEV
+  w->borrow    = false;
+  w->fd        = -1;
+  w->num_iov   = 0;
+#endif // MXML_WRITEV
+
+  if (bufsize <= sizeof(w->local))
+  {
+    w->buffer   = w->local;
+    w->bufalloc = false;
+  }
+  else if ((w->buffer = malloc(bufsize)) != NULL)
+  {
+    w->bufalloc = true;
+  }
+  else
+  {
+    _mxml_error(options, "无法分配%lu字节的输出缓冲区。", (unsigned long)bufsize);
+    return (false);
+  }
+
+  w->bufptr = w->buffer;
+  w->bufend = w->buffer + bufsize;
+#ifdef MXML_WRITEV
+  w->bufstart = w->buffer;
+#endif // MXML_WRITEV
+
+  return (true);
+}
+
+
+//
+// '_mxml_write_nstring()' - 写入字符串的前`bytes`个字节，根据需要转义 & 和 <。
+//
+// 不需要特殊处理的字符一次写入。不跟踪列数时（换行边距不大于0），返回的列数只表示输出是否在行首
+// （0表示在行首，1表示不在行首）。
+//
+
+int					// O - 新的列数，错误时为 `-1`
+_mxml_write_nstring(
+    const char      *s,			// I - 要写入的字符串
+    size_t          bytes,		// I - 字节数
+    _mxml_write_t   *w,			// I - 输出缓冲区
+    bool            use_entities,	// I - 是否转义特殊字符？
+    int             col)		// I - 当前列数
+{
+  const char	*ptr,			// 字符串指针
+		*end,			// 字符串的结尾
+		*ent;			// 实体，如果有的话
+  size_t	fraglen;		// 片段的长度
+
+
+  MXML_DEBUG("_mxml_write_nstring(w=%p, s=\"%.*s\", use_entities=%s, col=%d)\n", w, (int)bytes, s, use_entities ? "true" : "false", col);
+
+  if (col < 0)
+    return (-1);
+
+  for (ptr = s, end = s + bytes; ptr < end; ptr ++)
+  {
+    if ((fraglen = mxml_write_scan(ptr, end, use_entities, w->columns)) > 0)
+    {
+      // 写入当前片段，所有普通字符占据 1 列
+      if (!mxml_write_data(w, ptr, fraglen))
+        return (-1);
+
+      if (w->columns)
+        col += (int)fraglen;
+
+      if ((ptr += fraglen) >= end)
+        break;
+    }
+
+    if (use_entities && (ent = _mxml_entity_string(*ptr)) != NULL)
+    {
+      // 写入实体
+      if (!mxml_write_data(w, ent, strlen(ent)))
+        return (-1);
+
+      col ++;
+    }
+    else
+    {
+      if (!mxml_write_data(w, ptr, 1))
+        return (-1);
+
+      if (*ptr == '\r' || *ptr == '\n')
+      {
+	// CR 或 LF 重置列数
+	col = 0;
+      }
+      else if (*ptr == '\t')
+      {
+	// Tab 缩进列数
+	col = col - (col % MXML_TAB) + MXML_TAB;
+      }
+      else
+      {
+	// 所有其他控制字符占据 1 列
+	col ++;
+      }
+    }
+  }
+
+  if (!w->columns && end > s)
+  {
+    // 只记录输出是否在行首...
+    col = (end[-1] == '\r' || end[-1] == '\n') ? 0 : 1;
+  }
+
+  return (col);
+}
+
+
+//
+// '_mxml_write_string()' - 写入字符串，根据需要转义 & 和 <。
+//
+
+int					// O - 新的列数，错误时为 `-1`
+_mxml_write_string(
+    const char      *s,			// I - 要写入的字符串
+    _mxml_write_t   *w,			// I - 输出缓冲区
+    bool            use_entities,	// I - 是否转义特殊字符？
+    int             col)		// I - 当前列数
+{
+  return (_mxml_write_nstring(s, strlen(s), w, use_entities, col));
+}
+
+
+//
+// 'mxml_add_char()' - 将字符添加到令牌中，根据需要进行扩展。
+//
+
+static bool				// O  - `true`表示成功，`false`表示错误
+mxml_add_char(mxml_options_t *options,	// I  - 选项
+              _mxml_token_t  *tok,	// IO - 令牌
+              int            ch)	// I  - 要添加的字符
+{
+  if (tok->r)
+  {
+    // 原位解码：写入位置不能超过读取位置...
+    size_t bytes = ch < 0x80 ? 1 : ch < 0x800 ? 2 : ch < 0x10000 ? 3 : 4;
+
+    if ((tok->bufptr + bytes) > (char *)tok->r->bufptr && !mxml_token_spill(options, tok))
+      return (false);
+  }
+  else if (tok->bufptr >= (tok->buffer + tok->bufsize - 4) && !mxml_token_grow(options, tok, tok->bufsize + 1))
+  {
+    return (false);
+  }
+
+  tok->bufptr = _mxml_put_utf8(tok->bufptr, ch);
+
+  return (true);
+}
+
+
+//
+// 'mxml_add_run()' - 将输入缓冲区中连续的普通字符一次添加到令牌中。
+//
+// 普通字符是除了终止字符`d1`、`d2`和`d3`之外的可打印ASCII字符和有效的多字节UTF-8字符，遇到控制
+// 字符（包括换行符）、字节顺序标记、无效的UTF-8序列或缓冲区的结尾时停止，剩下的字符仍然使用
+// @link _mxml_getc@逐个读取。
+//
+
+static bool				// O  - `true`表示成功，`false`表示错误
+mxml_add_run(mxml_options_t *options,	// I  - 选项
+             _mxml_token_t  *tok,	// IO - 令牌
+             _mxml_read_t   *r,		// IO - 输入缓冲区
+             int            d1,		// I  - 第一个终止字符
+             int            d2,		// I  - 第二个终止字符
+             int            d3)		// I  - 第三个终止字符
+{
+  size_t	bytes,			// 普通字符的字节数
+		used;			// 令牌的长度
+
+
+  if ((bytes = _mxml_scan_utf8(r->bufptr, r->bufend, d1, d2, d3)) == 0)
+    return (true);
+
+  if (tok->r)
+  {
+    // 原位解码：令牌在读取位置之前，只有之前解码的实体使数据变短时才需要移动...
+    if (tok->bufptr != (char *)r->bufptr)
+      memmove(tok->bufptr, r->bufptr, bytes);
+  }
+  else
+  {
+    used = (size_t)(tok->bufptr - tok->buffer);
+
+    if ((used + bytes + 5) > tok->bufsize && !mxml_token_grow(options, tok, used + bytes + 5))
+      return (false);
+
+    memcpy(tok->bufptr, r->bufptr, bytes);
+  }
+
+  tok->bufptr += bytes;
+  r->bufptr   += bytes;
+
+  return (true);
+}
+
+
+//
+// 'mxml_context_load()' - 使用加载上下文加载数据。
+//
+
+static mxml_node_t *			// O - 第一个节点或`NULL`（如果数据有错误）
+mxml_context_load(
+    mxml_context_t *context,		// I - 加载上下文
+    mxml_node_t    *top,		// I - 顶级节点
+    _mxml_read_t   *r)			// I - 输入缓冲区
+{
+  mxml_options_t  *options = context->options;
+					// 选项
+  _mxml_global_t  *global;		// 全局数据
+  _mxml_doc_t     *olddoc;		// 之前正在加载的文档
+  mxml_node_t     *ret;			// 第一个节点
+
+
+  // 令牌缓冲区从上下文中获取，释放时还给上下文...
+  r->context = context;
+
+  // 临时SAX模式的节点从后进先出的临时内存池中分配...
+  if (options->sax_cb && options->sax_transient)
+    return (mxml_load_doc(top, options, r, NULL, 0));
+
+  // 之前加载的节点都已删除时清空并重复使用内存池，否则节点树保留之前的文档...
+  if (context->doc && context->doc->ref_count > 1)
+  {
+    _mxml_doc_release(context->doc);
+    context->doc = NULL;
+  }
+
+  if (context->doc)
+  {
+    _mxml_doc_pop(context->doc, NULL);
+  }
+  else if ((context->doc = _mxml_doc_new(true)) == NULL)
+  {
+    _mxml_error(options, "无法分配加载上下文的内存池。");
+    return (NULL);
+  }
+
+  context->doc->intern = options->intern;
+
+  global      = _mxml_global();
+  olddoc      = global->doc;
+  global->doc = context->doc;
+
+  ret = mxml_load_data(top, options, r, NULL);
+
+  global->doc = olddoc;
+
+  return (ret);
+}
+
+
+//
+// 'mxml_lazy_skip()' - 跳过元素的内容并记录它在数据中的位置。
+//
+// 只检查标记的嵌套以找到元素的闭合标签，内容中的其他错误在加载内容时报告。
+//
+
+static bool				// O  - `true`表示成功，`false`表示错误
+mxml_lazy_skip(
+    mxml_options_t *options,		// I  - 选项
+    _mxml_read_t   *r,			// IO - 输入缓冲区
+    mxml_node_t    *node,		// I  - 元素
+    int            *line)		// IO - 当前行号
+{
+  _mxml_doc_t	*doc = node->doc;	// 所属文档
+  unsigned char	*start = r->bufptr,	// 内容的开头
+		*close;			// 闭合标签的开头
+  int		startline = *line;	// 内容开头的行号
+  _mxml_lazy_t	*lazy;			// 延迟的内容
+
+
+  // 查找元素的闭合标签，内存中的数据不会移动...
+  if ((close = mxml_skip(options, r, node->value.element.name, false, false, line)) == NULL)
+    return (false);
+
+  // 记录非空的内容...
+  if (close > start)
+  {
+    if (doc->arena)
+      lazy = _mxml_doc_alloc(doc, sizeof(_mxml_lazy_t));
+    else
+      lazy = malloc(sizeof(_mxml_lazy_t));
+
+    if (!lazy)
+    {
+      _mxml_error(options, "无法为元素 <%s> 分配内存，在第 %d 行。", node->value.element.name, startline);
+      return (false);
+    }
+
+    if (!doc->source)
+      doc->source = (const char *)r->buffer;
+
+    lazy->start = (size_t)((const char *)start - doc->source);
+    lazy->end   = (size_t)((const char *)close - doc->source) + 2;
+    lazy->line  = startline;
+    lazy->error = false;
+
+    node->value.element.lazy = lazy;
+  }
+
+  return (true);
+}
+
+
+//
+// 'mxml_load_data()' - 将数据加载到 XML 节点树中。
+//
+// 当`ld`不为`NULL`时，从之前保存的状态继续加载。如果不是最后一段数据，在数据结尾保存状态并返回，
+// 而不检查文档是否完整。
+//
+
+static mxml_node_t *			// O - 第一个节点，如果无法读取 XML，则为 `NULL`。
+mxml_load_data(
+    mxml_node_t     *top,		// I - 顶级节点
+    mxml_options_t  *options,		// I - 选项
+    _mxml_read_t    *r,			// I - 输入缓冲区
+    _mxml_load_t    *ld)		// IO - 可恢复的加载状态或`NULL`
+{
+  mxml_node_t	*node = NULL,		// 当前节点
+		*first = NULL,		// 添加的第一个节点
+		*parent = NULL;		// 当前父节点
+  int		line = r->line,	// 当前行号
+		ch;			// 文件中的字符
+  size_t	depth = 0,		// 打开的元素数
+		lazy_depth = 0,		// 延迟加载内容的元素深度或0
+		keep_depth = 0;		// 加载整个元素的投影元素的深度或0
+  bool		whitespace = false,	// 是否遇到空白字符？
+		projecting = options && options->num_paths > 0 && !ld,
+					// 是否只加载投影路径上的元素？
+		prefix = false,		// 是否是注释/CDATA/处理指令的前缀？
+		text_runs = options && options->text_runs;
+					// 文本节点是否包含整段字符数据？
+  _mxml_token_t	tok,			// 当前令牌
+		name,			// 属性名
+		value;			// 属性值
+  mxml_type_t	type;			// 当前节点类型
+  _mxml_doc_t	*doc;			// 正在加载的文档
+  _mxml_project_t project;		// 元素与投影路径的匹配结果
+  static const char * const types[] =	// 类型字符串...
 		{
 		  "MXML_TYPE_CDATA",	// CDATA
 		  "MXML_TYPE_COMMENT",	// 注释
@@ -777,964 +2640,2717 @@ mxml_load_data(
 		};
 
 
-  // 从文件中读取元素和其他节点...
-  if ((buffer = malloc(64)) == NULL)
-  {
-    _mxml_error(options, "无法分配字符串缓冲区。");
-    return (NULL);
-  }
+  // UTF-16数据在读取时转换为UTF-8...
+  if ((!ld || !ld->started) && !mxml_read_bom(options, r))
+  {
+    if (ld)
+      ld->error = true;
+
+    return (NULL);
+  }
+
+  // 只有内存中的UTF-8数据可以延迟加载元素的内容...
+  if (options && options->lazy_depth > 0 && !options->sax_cb && !ld && !r->io_cb && !r->raw && (doc = _mxml_global()->doc) != NULL && doc->lazy)
+    lazy_depth = (size_t)options->lazy_depth;
+
+  // 从文件中读取元素和其他节点...
+  if (!mxml_token_init(options, r->context, &tok))
+    return (NULL);
+
+  if (!mxml_token_init(options, r->context, &name) || !mxml_token_init(options, r->context, &value))
+  {
+    mxml_token_free(&tok);
+    mxml_token_free(&name);
+    return (NULL);
+  }
+
+  mxml_token_start(&tok, r, EOF);
+
+  if (ld && ld->started)
+  {
+    // 恢复之前保存的状态...
+    parent     = ld->parent;
+    first      = ld->first;
+    line       = ld->line;
+    depth      = ld->depth;
+    keep_depth = ld->keep_depth;
+    whitespace = ld->whitespace;
+    type       = ld->type;
+
+    if ((ch = _mxml_getc(options, r)) == EOF)
+      goto end_of_data;
+  }
+  else
+  {
+    parent     = top;
+    first      = NULL;
+
+    if (options && options->type_cb && parent)
+      type = (options->type_cb)(options->type_cbdata, parent);
+    else if (options && !options->type_cb)
+      type = options->type_value;
+    else
+      type = MXML_TYPE_IGNORE;
+
+    if ((ch = _mxml_getc(options, r)) == EOF)
+    {
+      mxml_token_free(&tok);
+      mxml_token_free(&name);
+      mxml_token_free(&value);
+      return (NULL);
+    }
+    else if (ch != '<' && !top)
+    {
+      mxml_token_free(&tok);
+      mxml_token_free(&name);
+      mxml_token_free(&value);
+      _mxml_error(options, "XML 不以 '<' 开头（遇到 '%c'）。", ch);
+
+      if (ld)
+        ld->error = true;
+
+      return (NULL);
+    }
+  }
+
+  do
+  {
+    if ((ch == '<' || (MXML_ISSPACE(ch) && type != MXML_TYPE_OPAQUE && type != MXML_TYPE_CUSTOM && (type != MXML_TYPE_TEXT || !text_runs))) && tok.bufptr > tok.buffer)
+    {
+      // 添加一个新的值节点...
+      if (!mxml_token_end(options, &tok))
+        goto error;
+
+      switch (type)
+      {
+	case MXML_TYPE_INTEGER :
+            node = mxmlNewInteger(parent, strtol(tok.buffer, &tok.bufptr, 0));
+	    break;
+
+	case MXML_TYPE_OPAQUE :
+            node = mxmlNewOpaque(parent, tok.buffer);
+	    break;
+
+	case MXML_TYPE_REAL :
+            node = mxmlNewReal(parent, mxml_strtod(options, tok.buffer, &tok.bufptr));
+	    break;
+
+	case MXML_TYPE_TEXT :
+            node = mxmlNewText(parent, whitespace, tok.buffer);
+	    break;
+
+	case MXML_TYPE_CUSTOM :
+	    if (options && options->custload_cb)
+	    {
+	      // 使用回调函数填充自定义数据...
+              node = mxmlNewCustom(parent, /*data*/NULL, /*free_cb*/NULL, /*free_cbdata*/NULL);
+
+	      if (!(options->custload_cb)(options->cust_cbdata, node, tok.buffer))
+	      {
+	        _mxml_error(options, "父节点 <%s> 中的自定义值 '%s' 无效，在第 %d 行。", parent ? parent->value.element.name : "null", tok.buffer, line);
+		mxmlDelete(node);
+		node = NULL;
+	      }
+	      break;
+	    }
+
+        default : // 忽略...
+	    node = NULL;
+	    break;
+      }
+
+      if (*tok.bufptr)
+      {
+        // 整数/实数值无效...
+        _mxml_error(options, "父节点 <%s> 中的 %s 值 '%s' 无效，在第 %d 行。", parent ? parent->value.element.name : "null", type == MXML_TYPE_INTEGER ? "整数" : "实数", tok.buffer, line);
+	break;
+      }
+
+      MXML_DEBUG("mxml_load_data: node=%p(%s), parent=%p\n", node, tok.buffer, parent);
+
+      mxml_token_start(&tok, r, EOF);
+      whitespace = MXML_ISSPACE(ch) && type == MXML_TYPE_TEXT;
+
+      if (!node && type != MXML_TYPE_IGNORE)
+      {
+        // 打印错误并返回...
+	_mxml_error(options, "无法将类型为 %s 的值节点添加到父节点 <%s> 中，在第 %d 行。", types[type], parent ? parent->value.element.name : "null", line);
+	goto error;
+      }
+
+      if (options && options->sax_cb)
+      {
+        if (!mxml_sax_event(options, node, MXML_SAX_EVENT_DATA))
+          goto error;
+
+        node = mxml_sax_release(node);
+      }
+
+      if (!first && node)
+        first = node;
+    }
+    else if (MXML_ISSPACE(ch) && type == MXML_TYPE_TEXT && !text_runs)
+    {
+      whitespace = true;
+    }
+
+    if (ch == '\n')
+      line ++;
+
+    // 如果有元素并且存在空白字符，则添加一个孤立的空白节点...
+    if (ch == '<' && whitespace && type == MXML_TYPE_TEXT)
+    {
+      if (parent)
+      {
+	node = mxmlNewText(parent, whitespace, "");
+
+	if (options && options->sax_cb)
+	{
+	  if (!mxml_sax_event(options, node, MXML_SAX_EVENT_DATA))
+	    goto error;
+
+	  node = mxml_sax_release(node);
+	}
+
+	if (!first && node)
+	  first = node;
+      }
+
+      whitespace = false;
+    }
+
+    if (ch == '<')
+    {
+      // 开始开/闭标签...
+      mxml_token_start(&tok, r, EOF);
+
+      while ((ch = _mxml_getc(options, r)) != EOF)
+      {
+        if (MXML_ISSPACE(ch) || ch == '>' || (ch == '/' && tok.bufptr > tok.buffer))
+        {
+	  break;
+	}
+	else if (ch == '<')
+	{
+	  _mxml_error(options, "元素中的单个 <。");
+	  goto error;
+	}
+	else if (ch == '&')
+	{
+	  if ((ch = _mxml_get_entity(options, r, parent, &line)) == EOF)
+	    goto error;
+
+	  if (!mxml_add_char(options, &tok, ch))
+	    goto error;
+	}
+	else if (ch < '0' && ch != '!' && ch != '-' && ch != '.' && ch != '/')
+	{
+	  goto error;
+	}
+	else if (!mxml_add_char(options, &tok, ch))
+	{
+	  goto error;
+	}
+	else if (((tok.bufptr - tok.buffer) == 1 && tok.buffer[0] == '?') || ((tok.bufptr - tok.buffer) == 3 && !strncmp(tok.buffer, "!--", 3)) || ((tok.bufptr - tok.buffer) == 8 && !strncmp(tok.buffer, "![CDATA[", 8)))
+	{
+	  // 注释、CDATA和处理指令的其余部分将继续添加到令牌中...
+	  prefix = true;
+	  break;
+	}
+
+	if (ch == '\n')
+	  line ++;
+      }
+
+      if (prefix)
+        prefix = false;
+      else if (!mxml_token_end(options, &tok))
+        goto error;
+
+      if ((tok.bufptr - tok.buffer) == 3 && !strncmp(tok.buffer, "!--", 3))
+      {
+        // 收集剩余的注释...
+	while ((ch = _mxml_getc(options, r)) != EOF)
+	{
+	  if (ch == '>' && tok.bufptr > (tok.buffer + 4) && tok.bufptr[-3] != '-' && tok.bufptr[-2] == '-' && tok.bufptr[-1] == '-')
+	    break;
+	  else if (!mxml_add_char(options, &tok, ch) || !mxml_add_run(options, &tok, r, '>', '>', '>'))
+	    goto error;
+
+	  if (ch == '\n')
+	    line ++;
+	}
+
+        // 如果没有获取到整个注释，则报错...
+        if (ch != '>')
+	{
+	  // 打印错误并返回...
+	  _mxml_error(options, "注释节点在第 %d 行遇到早期的 EOF。", line);
+	  goto error;
+	}
+
+        // 否则将其作为元素添加到当前父节点下...
+	tok.bufptr[-2] = '\0';
+
+        if (!parent && first)
+	{
+	  // 只能有一个根元素！
+	  _mxml_error(options, "<%s--> 在 <%s> 之后不能作为第二个根节点，在第 %d 行。", tok.buffer, first->value.element.name, line);
+          goto error;
+	}
+
+	if ((node = mxmlNewComment(parent, tok.buffer + 3)) == NULL)
+	{
+	  // 只打印错误...
+	  _mxml_error(options, "无法将注释节点添加到父节点 <%s> 中，在第 %d 行。", parent ? parent->value.element.name : "null", line);
+	  break;
+	}
+
+	MXML_DEBUG("mxml_load_data: node=%p(<%s-->), parent=%p\n", node, tok.buffer, parent);
+
+        if (options && options->sax_cb)
+        {
+          if (!mxml_sax_event(options, node, MXML_SAX_EVENT_COMMENT))
+	    goto error;
+
+          node = mxml_sax_release(node);
+        }
+
+	if (node && !first)
+	  first = node;
+      }
+      else if ((tok.bufptr - tok.buffer) == 8 && !strncmp(tok.buffer, "![CDATA[", 8))
+      {
+        // 收集 CDATA 部分...
+	while ((ch = _mxml_getc(options, r)) != EOF)
+	{
+	  if (ch == '>' && !strncmp(tok.bufptr - 2, "]]", 2))
+	  {
+	    // 从 CDATA 字符串中删除终止符...
+	    tok.bufptr[-2] = '\0';
+	    break;
+	  }
+	  else if (!mxml_add_char(options, &tok, ch) || !mxml_add_run(options, &tok, r, '>', '>', '>'))
+	  {
+	    goto error;
+	  }
+
+	  if (ch == '\n')
+	    line ++;
+	}
+
+        // 如果没有获取到整个 CDATA 部分，则报错...
+        if (ch != '>')
+	{
+	  // 打印错误并返回...
+	  _mxml_error(options, "CDATA 节点在第 %d 行遇到早期的 EOF。", line);
+	  goto error;
+	}
+
+        // 否则将其作为元素添加到当前父节点下...
+	tok.bufptr[-2] = '\0';
+
+        if (!parent && first)
+	{
+	  // 只能有一个根元素！
+	  _mxml_error(options, "<%s]]> 在 <%s> 之后不能作为第二个根节点，在第 %d 行。", tok.buffer, first->value.element.name, line);
+          goto error;
+	}
+
+	if ((node = mxmlNewCDATA(parent, tok.buffer + 8)) == NULL)
+	{
+	  // 打印错误并返回...
+	  _mxml_error(options, "无法将 CDATA 节点添加到父节点 <%s> 中，在第 %d 行。", parent ? parent->value.element.name : "null", line);
+	  goto error;
+	}
+
+	MXML_DEBUG("mxml_load_data: node=%p(<%s]]>), parent=%p\n", node, tok.buffer, parent);
+
+        if (options && options->sax_cb)
+        {
+          if (!mxml_sax_event(options, node, MXML_SAX_EVENT_CDATA))
+	    goto error;
+
+          node = mxml_sax_release(node);
+        }
+
+	if (node && !first)
+	  first = node;
+      }
+      else if (tok.buffer[0] == '?')
+      {
+        // 收集剩余的处理指令...
+	while ((ch = _mxml_getc(options, r)) != EOF)
+	{
+	  if (ch == '>' && tok.bufptr > tok.buffer && tok.bufptr[-1] == '?')
+	    break;
+	  else if (!mxml_add_char(options, &tok, ch) || !mxml_add_run(options, &tok, r, '>', '>', '>'))
+	    goto error;
+
+	  if (ch == '\n')
+	    line ++;
+	}
+
+        // 如果没有获取到整个处理指令，则报错...
+        if (ch != '>')
+	{
+	  // 打印错误并返回...
+	  _mxml_error(options, "处理指令节点在第 %d 行遇到早期的 EOF。", line);
+	  goto error;
+	}
+
+        // 否则将其作为元素添加到当前父节点下（对于“<?>”，令牌只包含前缀“?”）...
+	if (!mxml_token_end(options, &tok))
+	  goto error;
+
+	tok.bufptr[-1] = '\0';
+
+        if (!parent && first)
+	{
+	  // 只能有一个根元素！
+	  _mxml_error(options, "<%s?> 在 <%s> 之后不能作为第二个根节点，在第 %d 行。", tok.buffer, first->value.element.name, line);
+          goto error;
+	}
+
+	if ((node = mxmlNewDirective(parent, tok.buffer + 1)) == NULL)
+	{
+	  // 打印错误并返回...
+	  _mxml_error(options, "无法将处理指令节点添加到父节点 <%s> 中，在第 %d 行。", parent ? parent->value.element.name : "null", line);
+	  goto error;
+	}
+
+	MXML_DEBUG("mxml_load_data: node=%p(<%s?>), parent=%p\n", node, tok.buffer, parent);
+
+        if (options && options->sax_cb)
+        {
+          if (!mxml_sax_event(options, node, MXML_SAX_EVENT_DIRECTIVE))
+	    goto error;
+
+          // "<?xml ...?>"处理指令总是保留...
+          if (strncmp(node->value.directive, "xml ", 4))
+            node = mxml_sax_release(node);
+          else
+            node = mxml_sax_keep(node);
+        }
+
+        if (node)
+	{
+	  if (!first)
+            first = node;
+
+	  if (!parent)
+	  {
+	    parent = node;
+
+	    if (options && options->type_cb)
+	      type = (options->type_cb)(options->type_cbdata, parent);
+	    else if (options)
+	      type = options->type_value;
+	    else
+	      type = MXML_TYPE_TEXT;
+	  }
+	}
+      }
+      else if (tok.buffer[0] == '!')
+      {
+        // 收集剩余的声明...
+	do
+	{
+	  if (ch == '>')
+	  {
+	    break;
+	  }
+	  else
+	  {
+            if (ch == '&')
+            {
+	      if ((ch = _mxml_get_entity(options, r, parent, &line)) == EOF)
+		goto error;
+            }
+
+	    if (!mxml_add_char(options, &tok, ch) || !mxml_add_run(options, &tok, r, '>', '&', '&'))
+	      goto error;
+	  }
+
+	  if (ch == '\n')
+	    line ++;
+	}
+        while ((ch = _mxml_getc(options, r)) != EOF);
+
+        // 如果没有获取到整个声明，则报错...
+        if (ch != '>')
+	{
+	  // 打印错误并返回...
+	  _mxml_error(options, "声明节点在第 %d 行遇到早期的 EOF。", line);
+	  goto error;
+	}
+
+        // 否则将其作为元素添加到当前父节点下...
+	if (!mxml_token_end(options, &tok))
+	  goto error;
+
+        if (!parent && first)
+	{
+	  // 只能有一个根元素！
+	  _mxml_error(options, "<%s> 在 <%s> 之后不能作为第二个根节点，在第 %d 行。", tok.buffer, first->value.element.name, line);
+          goto error;
+	}
+
+	if ((node = mxmlNewDeclaration(parent, tok.buffer + 1)) == NULL)
+	{
+	  // 打印错误并返回...
+	  _mxml_error(options, "无法将声明节点添加到父节点 <%s> 中，在第 %d 行。", parent ? parent->value.element.name : "null", line);
+	  goto error;
+	}
+
+	MXML_DEBUG("mxml_load_data: node=%p(<%s>), parent=%p\n", node, tok.buffer, parent);
+
+        if (options && options->sax_cb)
+        {
+          if (!mxml_sax_event(options, node, MXML_SAX_EVENT_DECLARATION))
+	    goto error;
+
+          node = mxml_sax_release(node);
+        }
+
+        if (node)
+	{
+	  if (!first)
+            first = node;
+
+	  if (!parent)
+	  {
+	    parent = node;
+
+	    if (options && options->type_cb)
+	      type = (options->type_cb)(options->type_cbdata, parent);
+	    else if (options)
+	      type = options->type_value;
+	    else
+	      type = MXML_TYPE_TEXT;
+	  }
+	}
+      }
+      else if (tok.buffer[0] == '/')
+      {
+        // 处理闭合标签...
+	MXML_DEBUG("mxml_load_data: <%s>, parent=%p\n", tok.buffer, parent);
+
+        if (r->lazy && !tok.buffer[1] && ch == EOF && parent == top)
+        {
+          // 延迟的内容在元素的闭合标签处结束...
+          break;
+        }
+
+        if (!parent || strcmp(tok.buffer + 1, parent->value.element.name))
+	{
+	  // 闭合标签与树不匹配；暂时只打印错误...
+	  _mxml_error(options, "不匹配的闭合标签 <%s>，在父节点 <%s> 下，在第 %d 行。", tok.buffer, parent ? parent->value.element.name : "(null)", line);
+          goto error;
+	}
+
+        // 继续读取，直到遇到 >...
+        while (ch != '>' && ch != EOF)
+	  ch = _mxml_getc(options, r);
+
+        node   = parent;
+        parent = parent->parent;
+        depth --;
+
+        if (depth < keep_depth)
+          keep_depth = 0;
+
+        if (options && options->sax_cb)
+        {
+          if (!mxml_sax_event(options, node, MXML_SAX_EVENT_ELEMENT_CLOSE))
+	    goto error;
+
+          if (first == node)
+            first = node = mxml_sax_release(node);
+          else
+            node = mxml_sax_release(node);
+        }
+
+        // 向上进入父节点，并根据需要设置值类型...
+	if (options && options->type_cb && parent)
+	  type = (options->type_cb)(options->type_cbdata, parent);
+	else if (options && !options->type_cb)
+	  type = options->type_value;
+      }
+      else if ((project = projecting && !keep_depth ? mxml_project(options, top, parent, tok.buffer) : _MXML_PROJECT_ALL) == _MXML_PROJECT_NONE)
+      {
+        // 跳过投影路径之外的元素，不创建节点...
+	MXML_DEBUG("mxml_load_data: skip <%s>, parent=%p\n", tok.buffer, parent);
+
+        if (ch == '/')
+        {
+	  if ((ch = _mxml_getc(options, r)) != '>')
+	  {
+	    _mxml_error(options, "元素 <%s/> 预期为 >，但实际为 '%c'，在第 %d 行。", tok.buffer, ch, line);
+	    goto error;
+	  }
+        }
+        else if (!mxml_skip(options, r, tok.buffer, ch != '>', false, &line))
+        {
+          goto error;
+        }
+      }
+      else
+      {
+        // 处理开放标签...
+        if (!parent && first)
+	{
+	  // 只能有一个根元素！
+	  _mxml_error(options, "<%s> 在 <%s> 之后不能作为第二个根节点，在第 %d 行。", tok.buffer, first->value.element.name, line);
+          goto error;
+	}
+
+        if ((node = mxmlNewElement(parent, tok.buffer)) == NULL)
+	{
+	  // 暂时只打印错误...
+	  _mxml_error(options, "无法将元素节点添加到父节点 <%s> 中，在第 %d 行。", parent ? parent->value.element.name : "null", line);
+	  goto error;
+	}
+
+        if (MXML_ISSPACE(ch))
+        {
+	  MXML_DEBUG("mxml_load_data: node=%p(<%s...>), parent=%p\n", node, tok.buffer, parent);
+
+	  if ((ch = mxml_parse_element(options, r, node, &name, &value, &line)) == EOF)
+	    goto error;
+        }
+        else if (ch == '/')
+	{
+	  MXML_DEBUG("mxml_load_data: node=%p(<%s/>), parent=%p\n", node, tok.buffer, parent);
+
+	  if ((ch = _mxml_getc(options, r)) != '>')
+	  {
+	    _mxml_error(options, "元素 <%s/> 预期为 >，但实际为 '%c'，在第 %d 行。", tok.buffer, ch, line);
+            mxmlDelete(node);
+            node = NULL;
+            goto error;
+	  }
+
+	  ch = '/';
+	}
+
+        if (options && options->sax_cb)
+        {
+          if (!mxml_sax_event(options, node, MXML_SAX_EVENT_ELEMENT_OPEN))
+	    goto error;
+
+          // 保留的临时元素在添加子节点之前复制到节点树中...
+          if (node->ref_count > 1 && (node = mxml_sax_keep(node)) == NULL)
+            goto error;
+	}
+
+        if (!first)
+	  first = node;
+
+	if (ch == EOF)
+	  break;
+
+        if (ch != '/' && lazy_depth && depth + 1 == lazy_depth && project == _MXML_PROJECT_ALL)
+        {
+          // 跳过内容，在第一次访问时加载...
+          if (!mxml_lazy_skip(options, r, node, &line))
+            goto error;
+
+          ch = '/';
+        }
+
+        if (ch != '/')
+	{
+	  // 进入此节点，并根据需要设置值类型...
+	  parent = node;
+	  depth ++;
+
+	  if (projecting && !keep_depth && project == _MXML_PROJECT_ALL)
+	    keep_depth = depth;
+
+	  if (options && options->type_cb && parent)
+	    type = (options->type_cb)(options->type_cbdata, parent);
+	  else if (options && !options->type_cb)
+	    type = options->type_value;
+	  else
+	    type = MXML_TYPE_TEXT;
+	}
+        else if (options && options->sax_cb)
+        {
+          if (!mxml_sax_event(options, node, MXML_SAX_EVENT_ELEMENT_CLOSE))
+	    goto error;
+
+          if (first == node)
+            first = node = mxml_sax_release(node);
+          else
+            node = mxml_sax_release(node);
+        }
+      }
+
+      if (projecting && !keep_depth && depth > 0 && ch != EOF)
+      {
+        // 投影路径上的祖先元素中只加载子元素，跳过文本、注释等内容直到下一个子元素或闭合标签...
+        if (!mxml_skip(options, r, parent->value.element.name, false, true, &line))
+          goto error;
+      }
+
+      mxml_token_start(&tok, r, EOF);
+    }
+    else if (ch == '&')
+    {
+      // 将字符实体添加到当前缓冲区...
+      if ((ch = _mxml_get_entity(options, r, parent, &line)) == EOF)
+	goto error;
+
+      if (!mxml_add_char(options, &tok, ch))
+	goto error;
+    }
+    else if (type == MXML_TYPE_OPAQUE || type == MXML_TYPE_CUSTOM || (type == MXML_TYPE_TEXT && text_runs) || !MXML_ISSPACE(ch))
+    {
+      // 将字符及其后的普通字符添加到当前缓冲区，空格只在分隔值时终止...
+      if (!mxml_add_char(options, &tok, ch))
+	goto error;
+
+      if (!mxml_add_run(options, &tok, r, '<', '&', (type == MXML_TYPE_OPAQUE || type == MXML_TYPE_CUSTOM || (type == MXML_TYPE_TEXT && text_runs)) ? '&' : ' '))
+	goto error;
+    }
+  }
+  while ((ch = _mxml_getc(options, r)) != EOF);
+
+  end_of_data:
+
+  if (ld && r->bufptr < r->bufend)
+  {
+    // 无效的字符或值导致加载在数据结尾之前停止...
+    _mxml_error(options, "在第 %d 行遇到无效的数据。", line);
+    goto error;
+  }
+
+  // 释放字符串缓冲区 - 我们不再需要它了...
+  mxml_token_free(&tok);
+  mxml_token_free(&name);
+  mxml_token_free(&value);
+
+  if (ld)
+  {
+    // 保存状态，如果还有更多数据则返回...
+    ld->started    = true;
+    ld->parent     = parent;
+    ld->first      = first;
+    ld->line       = line;
+    ld->depth      = depth;
+    ld->keep_depth = keep_depth;
+    ld->whitespace = whitespace;
+    ld->type       = type;
+
+    if (!ld->final)
+      return (first);
+
+    ld->first = NULL;
+  }
+
+  // 查找顶级元素并返回它...
+  if (parent)
+  {
+    node = parent;
+
+    while (parent != top && parent->parent)
+      parent = parent->parent;
+
+    if (node != parent)
+    {
+      _mxml_error(options, "在父节点 <%s> 下缺少闭合标签 </%s>，在第 %d 行。", mxmlGetElement(node), node->parent ? node->parent->value.element.name : "(null)", line);
+
+      mxmlDelete(first);
+
+      return (NULL);
+    }
+  }
+
+  if (parent)
+    return (parent);
+  else
+    return (first);
+
+  // 常见的错误返回...
+  error:
+
+  // 临时SAX模式中，从节点树中删除剩余的临时节点（打开的元素和当前节点）...
+  for (node = node ? node : parent, parent = NULL; node; node = node->parent)
+  {
+    if (node->doc && node->doc->transient)
+      parent = node;
+  }
+
+  if (parent)
+  {
+    if (first && first->doc && first->doc->transient)
+      first = NULL;
+
+    mxmlDelete(parent);
+  }
+
+  mxmlDelete(first);
+
+  mxml_token_free(&tok);
+  mxml_token_free(&name);
+  mxml_token_free(&value);
+
+  if (ld)
+  {
+    ld->error = true;
+    ld->first = NULL;
+  }
+
+  return (NULL);
+}
+
+//
+// 'mxml_load_doc()' - 将数据加载到新文档的节点中。
+//
+// 原位解析、使用内存池、驻留名称或延迟加载元素的内容时，加载的节点属于同一个文档，否则直接加载数据。
+//
+
+static mxml_node_t *			// O - 第一个节点，如果无法读取 XML，则为 `NULL`。
+mxml_load_doc(
+    mxml_node_t     *top,		// I - 顶级节点
+    mxml_options_t  *options,		// I - 选项
+    _mxml_read_t    *r,			// I - 输入缓冲区
+    char            *buf,		// I - 原位解析的缓冲区或`NULL`
+    size_t          len)		// I - 原位解析的缓冲区的长度
+{
+  _mxml_global_t  *global;		// 全局数据
+  _mxml_doc_t     *doc,			// 文档
+                  *olddoc;		// 之前正在加载的文档
+  mxml_node_t     *ret,			// 第一个节点
+                  *node;		// 当前节点
+  char            *source;		// 延迟的内容所在数据的副本
+
+
+  if (!buf && (!options || (!options->arena && !options->intern && !(options->sax_cb && options->sax_transient) && !(options->lazy_depth > 0 && !options->sax_cb))))
+    return (mxml_load_data(top, options, r, NULL));
+
+  if ((doc = mxml_load_newdoc(options, buf, len)) == NULL)
+    return (NULL);
+
+  global      = _mxml_global();
+  olddoc      = global->doc;
+  global->doc = doc;
+
+  ret = mxml_load_data(top, options, r, NULL);
+
+  global->doc = olddoc;
+
+  if (ret && doc->source == (const char *)r->buffer)
+  {
+    // 文档保留延迟的内容所在的数据：接管文件的映射或分配的缓冲区，或者复制调用者的字符串...
+    doc->sourcelen = r->bufsize;
+
+    if (r->bufmap)
+    {
+      doc->sourcemap = true;
+      r->bufmap      = false;
+    }
+    else if (r->bufalloc)
+    {
+      doc->sourcealloc = true;
+      r->bufalloc      = false;
+    }
+    else if (!buf)
+    {
+      doc->sourcelen = (size_t)(r->bufend - r->buffer);
+
+      if ((source = malloc(doc->sourcelen)) != NULL)
+      {
+        memcpy(source, r->buffer, doc->sourcelen);
+
+        doc->source      = source;
+        doc->sourcealloc = true;
+      }
+      else
+      {
+        // 无法复制时立即加载所有延迟的内容...
+        for (node = ret; node; node = mxmlWalkNext(node, ret, MXML_DESCEND_ALL));
+
+        doc->source = NULL;
+      }
+    }
+  }
+
+  // 释放加载时的引用，文档在删除最后一个节点时释放...
+  _mxml_doc_release(doc);
+
+  return (ret);
+}
+
+
+//
+// 'mxml_load_newdoc()' - 创建加载数据的文档。
+//
+// 临时SAX模式中，返回的临时文档引用保留的节点所属的文档（如果需要）。
+//
+
+static _mxml_doc_t *			// O - 文档或`NULL`（如果内存不足）
+mxml_load_newdoc(
+    mxml_options_t *options,		// I - 选项
+    char           *buf,		// I - 原位解析的缓冲区或`NULL`
+    size_t         len)			// I - 原位解析的缓冲区的长度
+{
+  _mxml_doc_t	*doc,			// 文档
+		*tdoc;			// 临时文档
+
+
+  doc = NULL;
+
+  if (buf || (options && (options->arena || options->intern || (options->lazy_depth > 0 && !options->sax_cb))))
+  {
+    if ((doc = _mxml_doc_new(options && options->arena)) == NULL)
+      return (NULL);
+
+    doc->intern       = options && options->intern;
+    doc->insitu_start = buf;
+    doc->insitu_end   = buf ? buf + len : NULL;
+
+    if (options && options->lazy_depth > 0 && !options->sax_cb)
+    {
+      // 延迟的内容在加载之后使用选项的副本加载...
+      if ((doc->lazy = malloc(sizeof(mxml_options_t))) == NULL)
+      {
+        _mxml_doc_release(doc);
+        return (NULL);
+      }
+
+      *(doc->lazy) = *options;
+
+      // 投影路径属于调用者的选项，延迟的内容加载所有元素...
+      doc->lazy->num_paths = 0;
+      doc->lazy->paths     = NULL;
+    }
+  }
+
+  if (!options || !options->sax_cb || !options->sax_transient)
+    return (doc);
+
+  // 临时节点从后进先出的内存池中分配...
+  if ((tdoc = _mxml_doc_new(true)) == NULL)
+  {
+    _mxml_doc_release(doc);
+    return (NULL);
+  }
+
+  tdoc->transient    = true;
+  tdoc->keep         = doc;
+  tdoc->intern       = options->intern;
+  tdoc->insitu_start = buf;
+  tdoc->insitu_end   = buf ? buf + len : NULL;
+
+  return (tdoc);
+}
+
+
+//
+// 'mxml_load_part()' - 加载并行加载的一段数据。
+//
+
+static void *				// O - 总是`NULL`
+mxml_load_part(_mxml_part_t *part)	// I - 数据段
+{
+  _mxml_global_t	*global = _mxml_global();
+					// 全局数据
+  _mxml_read_t		r;		// 输入缓冲区
+
+
+  // 使用调用者的字符串回调函数（在调用者的线程中加载时不需要复制，其他线程同时读取这些值）...
+  if (global != part->global)
+  {
+    global->strcopy_cb = part->global->strcopy_cb;
+    global->strfree_cb = part->global->strfree_cb;
+    global->str_cbdata = part->global->str_cbdata;
+  }
+
+  _mxml_read_init_string(&r, part->start, part->bytes);
+  part->ret = mxml_load_doc(part->top, &part->options, &r, NULL, 0);
+  mxml_read_free(&r);
+
+  return (NULL);
+}
+
+
+//
+// 'mxml_load_part_error()' - 记录并行加载时的错误。
+//
+
+static void
+mxml_load_part_error(
+    bool       *error,			// I - 数据段的错误标志
+    const char *message)		// I - 错误信息（未使用）
+{
+  (void)message;
+
+  *error = true;
+}
+
+
+//
+// 'mxml_load_root()' - 跳过根元素之前的处理指令、注释和声明，查找根元素的开始标签。
+//
+
+static const char *			// O - 根元素的开始标签之后的位置或`NULL`（如果无法确定）
+mxml_load_root(const char *s,		// I - 数据的开头
+               const char *end,		// I - 数据的结尾
+               const char **name,	// O - 根元素的名称
+               size_t     *namelen)	// O - 根元素名称的长度
+{
+  char	quote;				// 属性值的引号
+
+
+  // 跳过UTF-8字节顺序标记...
+  if ((end - s) >= 3 && !memcmp(s, "\357\273\277", 3))
+    s += 3;
+
+  while (s < end)
+  {
+    if (MXML_ISSPACE(*s))
+    {
+      s ++;
+    }
+    else if (*s != '<' || (end - s) < 4)
+    {
+      return (NULL);
+    }
+    else if (s[1] == '?')
+    {
+      // 跳过处理指令...
+      for (s += 2; s < (end - 1) && (s[0] != '?' || s[1] != '>'); s ++);
+
+      s += 2;
+    }
+    else if (!memcmp(s, "<!--", 4))
+    {
+      // 跳过注释...
+      for (s += 4; s < (end - 2) && (s[0] != '-' || s[1] != '-' || s[2] != '>'); s ++);
+
+      s += 3;
+    }
+    else if (s[1] == '!')
+    {
+      // 跳过没有内部子集的声明...
+      for (s += 2; s < end && *s != '>'; s ++)
+      {
+        if (*s == '[')
+          return (NULL);
+      }
+
+      s ++;
+    }
+    else
+    {
+      break;
+    }
+  }
+
+  if (s >= end)
+    return (NULL);
+
+  // 根元素的名称和属性...
+  for (*name = ++ s; s < end && !MXML_ISSPACE(*s) && *s != '/' && *s != '>'; s ++);
+
+  if ((*namelen = (size_t)(s - *name)) == 0)
+    return (NULL);
+
+  for (quote = '\0'; s < end; s ++)
+  {
+    if (quote)
+    {
+      if (*s == quote)
+        quote = '\0';
+    }
+    else if (*s == '\"' || *s == '\'')
+    {
+      quote = *s;
+    }
+    else if (*s == '>')
+    {
+      break;
+    }
+  }
+
+  // 空的根元素不需要并行加载...
+  if (s >= end || s[-1] == '/')
+    return (NULL);
+
+  return (s + 1);
+}
+
+
+//
+// 'mxml_load_split()' - 查找记录元素的闭合标签之后的拆分位置。
+//
+// 闭合标签之后（可以有空白字符）必须是另一个元素、注释或处理指令的开始标签。
+//
+
+static const char *			// O - 闭合标签之后的位置或`NULL`（如果没有）
+mxml_load_split(const char *s,		// I - 开始查找的位置
+                const char *end,	// I - 根元素的闭合标签
+                const char *name,	// I - 记录元素的名称
+                size_t     namelen)	// I - 记录元素名称的长度
+{
+  const char	*ptr,			// 闭合标签的结尾
+		*next;			// 下一个标记
+
+
+  while ((s = memchr(s, '<', (size_t)(end - s))) != NULL)
+  {
+    if ((size_t)(end - s) > (namelen + 2) && s[1] == '/' && !memcmp(s + 2, name, namelen))
+    {
+      for (ptr = s + 2 + namelen; ptr < end && MXML_ISSPACE(*ptr); ptr ++);
+
+      if (ptr < end && *ptr == '>')
+      {
+        for (next = ptr + 1; next < end && MXML_ISSPACE(*next); next ++);
+
+        if ((next + 1) < end && *next == '<' && next[1] != '/')
+          return (ptr + 1);
+      }
+    }
+
+    s ++;
+  }
+
+  return (NULL);
+}
+
+
+//
+// 'mxml_parse_element()' - 解析元素的属性...
+//
+
+static int				// O  - 终止字符
+mxml_parse_element(
+    mxml_options_t   *options,		// I  - 选项
+    _mxml_read_t     *r,		// IO - 输入缓冲区
+    mxml_node_t      *node,		// I  - 元素节点
+    _mxml_token_t    *name,		// I  - 属性名的令牌
+    _mxml_token_t    *value,		// I  - 属性值的令牌
+    int              *line)		// IO - 当前行号
+{
+  int		ch,			// 文件中的当前字符
+		quote;			// 引用字符
+
+
+  // 循环直到遇到 >、/、? 或 EOF...
+  while ((ch = _mxml_getc(options, r)) != EOF)
+  {
+    MXML_DEBUG("mxml_parse_element: ch='%c'\n", ch);
+
+    // 跳过前导空白字符...
+    if (MXML_ISSPACE(ch))
+    {
+      if (ch == '\n')
+        (*line)++;
+
+      continue;
+    }
+
+    // 在 /、? 或 > 处停止...
+    if (ch == '/' || ch == '?')
+    {
+      // 获取 > 字符，如果不存在则打印错误...
+      quote = _mxml_getc(options, r);
+
+      if (quote != '>')
+      {
+        _mxml_error(options, "在元素 %s 的 '%c' 后期望 '>'，但在第 %d 行得到 '%c'。", ch, mxmlGetElement(node), quote, *line);
+        goto error;
+      }
+
+      break;
+    }
+    else if (ch == '<')
+    {
+      _mxml_error(options, "在元素 %s 中存在裸的 <，位于第 %d 行。", mxmlGetElement(node), *line);
+      goto error;
+    }
+    else if (ch == '>')
+    {
+      break;
+    }
+
+    // 读取属性名...
+    mxml_token_start(name, r, ch);
+    if (!mxml_add_char(options, name, ch))
+      goto error;
+
+    if (ch == '\"' || ch == '\'')
+    {
+      // 属性名在引号中，获取带引号的字符串...
+      quote = ch;
+
+      while ((ch = _mxml_getc(options, r)) != EOF)
+      {
+        if (ch == '&')
+        {
+	  if ((ch = _mxml_get_entity(options, r, node, line)) == EOF)
+	    goto error;
+	}
+	else if (ch == '\n')
+	{
+	  (*line)++;
+	}
+
+	if (!mxml_add_char(options, name, ch))
+	  goto error;
+
+	if (ch == quote)
+          break;
+      }
+    }
+    else
+    {
+      // 获取普通的非引号属性名...
+      while ((ch = _mxml_getc(options, r)) != EOF)
+      {
+	if (MXML_ISSPACE(ch) || ch == '=' || ch == '/' || ch == '>' || ch == '?')
+	{
+	  if (ch == '\n')
+	    (*line)++;
+          break;
+        }
+	else
+	{
+          if (ch == '&')
+          {
+	    if ((ch = _mxml_get_entity(options, r, node, line)) == EOF)
+	      goto error;
+          }
+
+	  if (!mxml_add_char(options, name, ch))
+	    goto error;
+	}
+      }
+    }
+
+    if (!mxml_token_end(options, name))
+      goto error;
+
+    if (mxmlElementGetAttr(node, name->buffer))
+    {
+      _mxml_error(options, "在元素 %s 中重复的属性 '%s'，位于第 %d 行。", name->buffer, mxmlGetElement(node), *line);
+      goto error;
+    }
+
+    while (ch != EOF && MXML_ISSPACE(ch))
+    {
+      ch = _mxml_getc(options, r);
+
+      if (ch == '\n')
+        (*line)++;
+    }
+
+    if (ch == '=')
+    {
+      // 读取属性值...
+      while ((ch = _mxml_getc(options, r)) != EOF && MXML_ISSPACE(ch))
+      {
+        if (ch == '\n')
+          (*line)++;
+      }
+
+      if (ch == EOF)
+      {
+        _mxml_error(options, "在元素 %s 的属性 '%s' 中缺少值，位于第 %d 行。", name->buffer, mxmlGetElement(node), *line);
+        goto error;
+      }
+
+      if (ch == '\'' || ch == '\"')
+      {
+        // 读取带引号的属性值...
+        quote = ch;
+	mxml_token_start(value, r, EOF);
+
+        while ((ch = _mxml_getc(options, r)) != EOF)
+        {
+	  if (ch == quote)
+	  {
+	    break;
+	  }
+	  else
+	  {
+	    if (ch == '&')
+	    {
+	      if ((ch = _mxml_get_entity(options, r, node, line)) == EOF)
+	        goto error;
+	    }
+	    else if (ch == '\n')
+	    {
+	      (*line)++;
+	    }
+
+	    if (!mxml_add_char(options, value, ch) || !mxml_add_run(options, value, r, quote, '&', '&'))
+	      goto error;
+	  }
+	}
+
+        if (!mxml_token_end(options, value))
+          goto error;
+      }
+      else
+      {
+        // 读取不带引号的属性值...
+	mxml_token_start(value, r, ch);
+	if (!mxml_add_char(options, value, ch))
+	  goto error;
+
+	while ((ch = _mxml_getc(options, r)) != EOF)
+	{
+	  if (MXML_ISSPACE(ch) || ch == '=' || ch == '/' || ch == '>')
+	  {
+	    if (ch == '\n')
+	      (*line)++;
+
+            break;
+          }
+	  else
+	  {
+	    if (ch == '&')
+	    {
+	      if ((ch = _mxml_get_entity(options, r, node, line)) == EOF)
+	        goto error;
+	    }
+
+	    if (!mxml_add_char(options, value, ch))
+	      goto error;
+	  }
+	}
+
+        if (!mxml_token_end(options, value))
+          goto error;
+      }
+
+      // 使用给定的字符串值设置属性...
+      mxmlElementSetAttr(node, name->buffer, value->buffer);
+      MXML_DEBUG("mxml_parse_element: %s=\"%s\"\n", name->buffer, value->buffer);
+    }
+    else
+    {
+      _mxml_error(options, "在元素 %s 的属性 '%s' 中缺少值，位于第 %d 行。", name->buffer, mxmlGetElement(node), *line);
+      goto error;
+    }
+
+    // 检查结束字符...
+    if (ch == '/' || ch == '?')
+    {
+      // 获取 > 字符，如果不存在则打印错误...
+      quote = _mxml_getc(options, r);
+
+      if (quote != '>')
+      {
+        _mxml_error(options, "在元素 %s 的 '%c' 后期望 '>'，但在第 %d 行得到 '%c'。", ch, mxmlGetElement(node), quote, *line);
+        ch = EOF;
+      }
+
+      break;
+    }
+    else if (ch == '>')
+      break;
+  }
+
+  return (ch);
+
+  // 错误返回点...
+  error:
+
+  return (EOF);
+}
+
+
+
+//
+// 'mxml_parser_load()' - 加载推送解析器中的完整标记。
+//
+
+static mxml_node_t *			// O - 最后一段数据的第一个节点或`NULL`
+mxml_parser_load(mxml_parser_t *parser)	// I - 推送解析器
+{
+  _mxml_read_t	r;			// 输入缓冲区
+  _mxml_global_t *global = _mxml_global();
+					// 全局数据
+  _mxml_doc_t	*olddoc = NULL;		// 之前正在加载的文档
+  mxml_node_t	*ret;			// 第一个节点
+
+
+  // 从缓冲区中加载数据，继续使用之前检测到的字符编码...
+  _mxml_read_init_string(&r, (char *)parser->buffer, parser->complete);
+
+  if (parser->ld.started && parser->encoding != _MXML_ENCODING_UTF8 && !mxml_read_init_utf16(parser->options, &r, parser->encoding))
+  {
+    parser->ld.error = true;
+    return (NULL);
+  }
+
+  if (parser->doc)
+  {
+    olddoc      = global->doc;
+    global->doc = parser->doc;
+  }
+
+  ret = mxml_load_data(parser->top, parser->options, &r, &parser->ld);
+
+  if (parser->doc)
+    global->doc = olddoc;
+
+  mxml_read_free(&r);
+
+  // 删除已经加载的数据...
+  if (parser->complete < parser->bufused)
+    memmove(parser->buffer, parser->buffer + parser->complete, parser->bufused - parser->complete);
+
+  parser->bufused  -= parser->complete;
+  parser->scanned  -= parser->complete;
+  parser->complete = 0;
+
+  return (ret);
+}
+
+
+//
+// 'mxml_parser_scan()' - 查找推送解析器中最后一个完整的标记。
+//
+// 扫描规则与@code mxml_load_data@中的标记结尾相同，以便只加载完整的标记：元素在引号外的">"处结束（与
+// @code mxml_parse_element@相同，只有属性名或属性值开头的引号开始带引号的字符串），注释在"-->"处结束，
+// CDATA在"]]>"处结束，处理指令在"?>"处结束，声明在">"处结束。
+//
+
+static void
+mxml_parser_scan(mxml_parser_t *parser)	// I - 推送解析器
+{
+  unsigned char	*bufptr,		// 当前位置
+		*bufend;		// 数据的结尾
+  size_t	unit;			// 每个字符单元的字节数
+  int		ch;			// 当前字符单元
+  bool		end,			// 是否是标记的结尾？
+		tail;			// 是否保留最后三个字符？
+
+
+  bufptr = parser->buffer + parser->scanned;
+  bufend = parser->buffer + parser->bufused;
+
+  // 检测UTF-16字节顺序标记...
+  if (!parser->ld.started && parser->scanned == 0)
+  {
+    if ((bufend - bufptr) < 2)
+    {
+      if (bufptr < bufend && (*bufptr == 0xfe || *bufptr == 0xff))
+        return;
+    }
+    else if (bufptr[0] == 0xfe && bufptr[1] == 0xff)
+    {
+      parser->encoding = _MXML_ENCODING_UTF16BE;
+      bufptr += 2;
+    }
+    else if (bufptr[0] == 0xff && bufptr[1] == 0xfe)
+    {
+      parser->encoding = _MXML_ENCODING_UTF16LE;
+      bufptr += 2;
+    }
+  }
+
+  unit = parser->encoding == _MXML_ENCODING_UTF8 ? 1 : 2;
+
+  while ((size_t)(bufend - bufptr) >= unit)
+  {
+    // 获取下一个字符单元，只需要区分ASCII字符...
+    if (parser->encoding == _MXML_ENCODING_UTF8)
+      ch = bufptr[0];
+    else if (parser->encoding == _MXML_ENCODING_UTF16BE)
+      ch = (bufptr[0] << 8) | bufptr[1];
+    else
+      ch = (bufptr[1] << 8) | bufptr[0];
+
+    if (ch >= 0x80)
+      ch = 0x80;
+
+    bufptr += unit;
+    end    = false;
+    tail   = false;
+
+    switch (parser->state)
+    {
+      case _MXML_SCAN_TEXT :
+          if (ch == '<')
+          {
+            parser->state     = _MXML_SCAN_MARKUP;
+            parser->markuplen = 0;
+          }
+          break;
+
+      case _MXML_SCAN_MARKUP :
+          // 根据前缀确定标记类型，注释、CDATA和处理指令只保留最后三个字符...
+          parser->markup[parser->markuplen ++] = (char)ch;
+
+          if (parser->markup[0] == '?')
+          {
+            parser->state     = _MXML_SCAN_DIRECTIVE;
+            parser->markup[0] = parser->markup[1] = '\0';
+            parser->markup[2] = '?';
+          }
+          else if (parser->markup[0] != '!')
+          {
+            // 元素名称中的引号是普通字符...
+            parser->state = _MXML_SCAN_ELEMENT;
+            parser->quote = 0;
+            parser->prev  = ch;
+            end           = ch == '>';
+          }
+          else if (parser->markuplen <= 3 && !strncmp(parser->markup, "!--", parser->markuplen))
+          {
+            if (parser->markuplen == 3)
+              parser->state = _MXML_SCAN_COMMENT;
+          }
+          else if (!strncmp(parser->markup, "![CDATA[", parser->markuplen))
+          {
+            if (parser->markuplen == 8)
+            {
+              parser->state     = _MXML_SCAN_CDATA;
+              parser->markup[1] = 'A';
+              parser->markup[2] = '[';
+            }
+          }
+          else
+          {
+            parser->state = _MXML_SCAN_DECLARATION;
+            end           = ch == '>';
+          }
+          break;
+
+      case _MXML_SCAN_ELEMENT :
+          if (parser->quote)
+          {
+            // 带引号的字符串之后可以直接开始下一个属性...
+            if (ch == parser->quote)
+            {
+              parser->quote = 0;
+              ch            = ' ';
+            }
+          }
+          else if ((ch == '\"' || ch == '\'') && (parser->prev == '=' || MXML_ISSPACE(parser->prev)))
+          {
+            parser->quote = ch;
+          }
+          else
+          {
+            end = ch == '>';
+          }
+
+          parser->prev = ch;
+          break;
+
+      case _MXML_SCAN_COMMENT :
+          end  = ch == '>' && parser->markuplen > 4 && parser->markup[0] != '-' && parser->markup[1] == '-' && parser->markup[2] == '-';
+          tail = true;
+          break;
+
+      case _MXML_SCAN_CDATA :
+          end  = ch == '>' && parser->markup[1] == ']' && parser->markup[2] == ']';
+          tail = true;
+          break;
+
+      case _MXML_SCAN_DIRECTIVE :
+          end  = ch == '>' && parser->markup[2] == '?';
+          tail = true;
+          break;
+
+      case _MXML_SCAN_DECLARATION :
+          end = ch == '>';
+          break;
+    }
+
+    if (end)
+    {
+      // 标记完整，之前的数据可以加载...
+      parser->state    = _MXML_SCAN_TEXT;
+      parser->complete = (size_t)(bufptr - parser->buffer);
+    }
+    else if (tail)
+    {
+      // 保留最后三个字符...
+      parser->markup[0] = parser->markup[1];
+      parser->markup[1] = parser->markup[2];
+      parser->markup[2] = (char)ch;
+      parser->markuplen ++;
+    }
+  }
+
+  parser->scanned = (size_t)(bufptr - parser->buffer);
+}
+
+
+//
+// 'mxml_project()' - 检查元素与投影路径的匹配。
+//
+
+static _mxml_project_t			// O - 匹配结果
+mxml_project(mxml_options_t *options,	// I - 选项
+             mxml_node_t    *top,	// I - 顶级节点
+             mxml_node_t    *parent,	// I - 父节点
+             const char     *name)	// I - 元素名称
+{
+  size_t	i,			// 循环变量
+		j;			// 路径中的元素
+  _mxml_path_t	*path;			// 投影路径
+  mxml_node_t	*node;			// 祖先元素
+  _mxml_project_t ret = _MXML_PROJECT_NONE;
+					// 匹配结果
+
+
+  for (i = 0; i < options->num_paths; i ++)
+  {
+    path = options->paths[i];
+
+    // 与整个路径匹配时保留整个元素...
+    if (mxml_project_match(path->steps, path->num_steps, top, parent, name))
+      return (_MXML_PROJECT_ALL);
+
+    if (ret != _MXML_PROJECT_NONE)
+      continue;
+
+    // 第一个元素可以在任意深度时，任何元素都可能是祖先元素...
+    if (path->steps[0].descend)
+    {
+      ret = _MXML_PROJECT_PATH;
+      continue;
+    }
+
+    // 否则元素必须与路径的前缀匹配，或者在前缀之下、可以在任意深度的下一个元素之上...
+    for (j = 1; j < path->num_steps && ret == _MXML_PROJECT_NONE; j ++)
+    {
+      if (mxml_project_match(path->steps, j, top, parent, name))
+      {
+        ret = _MXML_PROJECT_PATH;
+      }
+      else if (path->steps[j].descend)
+      {
+        for (node = parent; node && node != top && node->type == MXML_TYPE_ELEMENT; node = node->parent)
+        {
+          if (mxml_project_match(path->steps, j, top, node->parent, node->value.element.name))
+          {
+            ret = _MXML_PROJECT_PATH;
+            break;
+          }
+        }
+      }
+    }
+  }
+
+  return (ret);
+}
+
+
+//
+// 'mxml_project_match()' - 检查元素是否与投影路径的前`num_steps`个元素匹配。
+//
+// 从元素开始向上依次比较祖先元素的名称，"*/"之前的元素可以跳过任意数量的祖先元素。
+//
+
+static bool				// O - `true`表示匹配，`false`表示不匹配
+mxml_project_match(
+    const _mxml_step_t *steps,		// I - 路径中的元素
+    size_t             num_steps,	// I - 比较的元素数量
+    mxml_node_t        *top,		// I - 顶级节点
+    mxml_node_t        *parent,		// I - 父节点
+    const char         *name)		// I - 元素名称
+{
+  const _mxml_step_t	*step = steps + num_steps - 1;
+					// 当前元素
+  mxml_node_t		*node;		// 祖先元素
+
+
+  if (strcmp(step->name, name))
+    return (false);
+
+  // 第一个元素必须是根元素（或顶级节点的子元素），除非它可以在任意深度...
+  if (num_steps == 1)
+    return (step->descend || !parent || parent == top || parent->type != MXML_TYPE_ELEMENT);
+
+  for (node = parent; node && node != top && node->type == MXML_TYPE_ELEMENT; node = node->parent)
+  {
+    if (mxml_project_match(steps, num_steps - 1, top, node->parent, node->value.element.name))
+      return (true);
+
+    if (!step->descend)
+      break;
+  }
+
+  return (false);
+}
+
+
+//
+// 'mxml_read_cb_fd()' - 从文件描述符读取字节。
+//
+
+static size_t				// O - 读取的字节数
+mxml_read_cb_fd(int    *fd,		// I - 文件描述符
+                void   *buffer,		// I - 缓冲区
+                size_t bytes)		// I - 要读取的字节数
+{
+#if _WIN32
+  int		rbytes;			// 读取的字节数
+
+
+  rbytes = read(*fd, buffer, bytes);
+
+#else
+  ssize_t	rbytes;			// 读取的字节数
+
+
+  while ((rbytes = read(*fd, buffer, bytes)) < 0)
+  {
+    if (errno != EINTR && errno != EAGAIN)
+      break;
+  }
+#endif // _WIN32
+
+  if (rbytes < 0)
+    return (0);
+  else
+    return ((size_t)rbytes);
+}
+
+
+//
+// 'mxml_read_cb_file()' - 从文件指针读取字节。
+//
+
+static size_t				// O - 读取的字节数
+mxml_read_cb_file(FILE   *fp,		// I - 文件指针
+                  void   *buffer,	// I - 缓冲区
+                  size_t bytes)		// I - 要读取的字节数
+{
+  if (feof(fp))
+    return (0);
+  else
+    return (fread(buffer, 1, bytes, fp));
+}
+
+
+//
+// 'mxml_read_bom()' - 检测UTF-16字节顺序标记。
+//
+// 数据以UTF-16字节顺序标记开头时，之后的数据在读取时一次性转换为UTF-8，加载代码只需要处理UTF-8。
+//
+
+static bool				// O  - `true`表示成功，`false`表示内存不足
+mxml_read_bom(mxml_options_t *options,	// I  - 选项
+              _mxml_read_t   *r)	// IO - 输入缓冲区
+{
+  if (mxml_read_fill(r, 2) < 2)
+    return (true);
+
+  if (r->bufptr[0] == 0xfe && r->bufptr[1] == 0xff)
+  {
+    r->bufptr += 2;
+    return (mxml_read_init_utf16(options, r, _MXML_ENCODING_UTF16BE));
+  }
+  else if (r->bufptr[0] == 0xff && r->bufptr[1] == 0xfe)
+  {
+    r->bufptr += 2;
+    return (mxml_read_init_utf16(options, r, _MXML_ENCODING_UTF16LE));
+  }
+
+  return (true);
+}
+
+
+//
+// 'mxml_read_fill()' - 确保输入缓冲区中至少有指定数量的字节。
+//
+// 仅在缓冲区中的数据不足时才调用读取回调函数，每次尽可能多地读取数据（不超过`readsize`字节）。
+//
+
+static size_t				// O  - 缓冲区中可用的字节数
+mxml_read_fill(_mxml_read_t *r,		// IO - 输入缓冲区
+               size_t       bytes)	// I  - 需要的字节数
+{
+  size_t	avail,			// 可用的字节数
+		rbytes,			// 读取的字节数
+		request;		// 请求的字节数
+
+
+  // 检查缓冲区中是否已有足够的数据...
+  if ((avail = (size_t)(r->bufend - r->bufptr)) >= bytes || (!r->io_cb && !r->raw))
+    return (avail);
+
+  // 将剩余的数据移到缓冲区开头...
+  if (avail > 0 && r->bufptr > r->buffer)
+    memmove(r->buffer, r->bufptr, avail);
+
+  r->bufptr = r->buffer;
+  r->bufend = r->buffer + avail;
+
+  // 读取更多数据，直到有足够的字节或遇到文件结尾...
+  while (avail < bytes)
+  {
+    if (r->raw)
+    {
+      // 将尽可能多的UTF-16数据一次转换为UTF-8...
+      if ((rbytes = _mxml_utf16_convert(r->bufend, r->bufsize - avail, &r->rawptr, r->rawend, r->encoding)) == 0)
+      {
+        // 数据结尾只剩下不完整的字符（不完整的字符最多4个字节）时读取更多的UTF-16数据，否则数据无效...
+        if (!r->io_cb || (rbytes = (size_t)(r->rawend - r->rawptr)) >= 4)
+          break;
+
+        memmove(r->raw, r->rawptr, rbytes);
+        r->rawptr = r->raw;
+        r->rawend = r->raw + rbytes;
+
+        if ((request = r->rawsize - rbytes) > r->readsize && r->readsize)
+          request = r->readsize;
+
+        if ((rbytes = (r->io_cb)(r->io_cbdata, r->rawend, request)) == 0)
+          break;
 
-  bufsize    = 64;
-  bufptr     = buffer;
-  parent     = top;
-  first      = NULL;
+        r->rawend += rbytes;
+        continue;
+      }
+    }
+    else
+    {
+      if ((request = r->bufsize - avail) > r->readsize && r->readsize)
+        request = r->readsize;
 
-  if (options && options->type_cb && parent)
-    type = (options->type_cb)(options->type_cbdata, parent);
-  else if (options && !options->type_cb)
-    type = options->type_value;
-  else
-    type = MXML_TYPE_IGNORE;
+      if ((rbytes = (r->io_cb)(r->io_cbdata, r->bufend, request)) == 0)
+        break;
+    }
 
-  if ((ch = mxml_getc(options, io_cb, io_cbdata, &encoding)) == EOF)
-  {
-    free(buffer);
-    return (NULL);
-  }
-  else if (ch != '<' && !top)
-  {
-    free(buffer);
-    _mxml_error(options, "XML 不以 '<' 开头（遇到 '%c'）。", ch);
-    return (NULL);
+    r->bufend += rbytes;
+    avail     += rbytes;
   }
 
-  do
-  {
-    if ((ch == '<' || (mxml_isspace(ch) && type != MXML_TYPE_OPAQUE && type != MXML_TYPE_CUSTOM)) && bufptr > buffer)
-    {
-      // 添加一个新的值节点...
-      *bufptr = '\0';
+  return (avail);
+}
 
-      switch (type)
-      {
-	case MXML_TYPE_INTEGER :
-            node = mxmlNewInteger(parent, strtol(buffer, &bufptr, 0));
-	    break;
 
-	case MXML_TYPE_OPAQUE :
-            node = mxmlNewOpaque(parent, buffer);
-	    break;
+//
+// 'mxml_read_free()' - 释放输入缓冲区。
+//
 
-	case MXML_TYPE_REAL :
-            node = mxmlNewReal(parent, mxml_strtod(options, buffer, &bufptr));
-	    break;
+static void
+mxml_read_free(_mxml_read_t *r)		// I - 输入缓冲区
+{
+  if (r->bufalloc)
+    free(r->buffer);
+#ifdef HAVE_SYS_MMAN_H
+  else if (r->bufmap)
+    munmap(r->buffer, r->bufsize);
+#endif // HAVE_SYS_MMAN_H
+
+  if (r->raw && r->rawalloc)
+    free(r->raw);
+#ifdef HAVE_SYS_MMAN_H
+  else if (r->raw && r->rawmap)
+    munmap(r->raw, r->rawsize);
+#endif // HAVE_SYS_MMAN_H
+}
 
-	case MXML_TYPE_TEXT :
-            node = mxmlNewText(parent, whitespace, buffer);
-	    break;
 
-	case MXML_TYPE_CUSTOM :
-	    if (options && options->custload_cb)
-	    {
-	      // 使用回调函数填充自定义数据...
-              node = mxmlNewCustom(parent, /*data*/NULL, /*free_cb*/NULL, /*free_cbdata*/NULL);
+//
+// 'mxml_read_init()' - 为读取回调函数初始化输入缓冲区。
+//
 
-	      if (!(options->custload_cb)(options->cust_cbdata, node, buffer))
-	      {
-	        _mxml_error(options, "父节点 <%s> 中的自定义值 '%s' 无效，在第 %d 行。", parent ? parent->value.element.name : "null", buffer, line);
-		mxmlDelete(node);
-		node = NULL;
-	      }
-	      break;
-	    }
+static bool				// O - `true`表示成功，`false`表示错误
+mxml_read_init(_mxml_read_t   *r,	// I - 输入缓冲区
+               mxml_options_t *options,	// I - 选项
+               mxml_io_cb_t   io_cb,	// I - 读取回调函数
+               void           *io_cbdata)// I - 读取回调数据
+{
+  r->io_cb     = io_cb;
+  r->io_cbdata = io_cbdata;
+  r->encoding  = _MXML_ENCODING_UTF8;
+  r->bufsize   = options && options->bufsize ? options->bufsize : MXML_BUFSIZE;
+  r->readsize  = options ? options->readsize : 0;
+  r->bufalloc  = true;
+  r->bufmap    = false;
+  r->insitu    = false;
+  r->raw       = NULL;
+  r->line      = 1;
+  r->lazy      = false;
+  r->context   = NULL;
+
+  if ((r->buffer = malloc(r->bufsize)) == NULL)
+  {
+    if (options)
+      _mxml_error(options, "无法分配%lu字节的输入缓冲区。", (unsigned long)r->bufsize);
 
-        default : // 忽略...
-	    node = NULL;
-	    break;
-      }
+    return (false);
+  }
 
-      if (*bufptr)
-      {
-        // 整数/实数值无效...
-        _mxml_error(options, "父节点 <%s> 中的 %s 值 '%s' 无效，在第 %d 行。", parent ? parent->value.element.name : "null", type == MXML_TYPE_INTEGER ? "整数" : "实数", buffer, line);
-	break;
-      }
+  r->bufptr = r->buffer;
+  r->bufend = r->buffer;
 
-      MXML_DEBUG("mxml_load_data: node=%p(%s), parent=%p\n", node, buffer, parent);
+  return (true);
+}
 
-      bufptr     = buffer;
-      whitespace = mxml_isspace(ch) && type == MXML_TYPE_TEXT;
 
-      if (!node && type != MXML_TYPE_IGNORE)
-      {
-        // 打印错误并返回...
-	_mxml_error(options, "无法将类型为 %s 的值节点添加到父节点 <%s> 中，在第 %d 行。", types[type], parent ? parent->value.element.name : "null", line);
-	goto error;
-      }
+//
+// 'mxml_read_init_map()' - 将常规文件映射到内存中作为输入缓冲区。
+//
+// 解析从文件描述符的当前位置开始。对于无法映射的文件（管道、套接字、空文件等）返回`false`，
+// 此时调用者应使用缓冲读取。
+//
 
-      if (options && options->sax_cb)
-      {
-        if (!(options->sax_cb)(options->sax_cbdata, node, MXML_SAX_EVENT_DATA))
-          goto error;
+static bool				// O - `true`表示已映射，`false`表示无法映射
+mxml_read_init_map(_mxml_read_t *r,	// I - 输入缓冲区
+                   int          fd)	// I - 文件描述符
+{
+#ifdef HAVE_SYS_MMAN_H
+  struct stat	fileinfo;		// 文件信息
+  off_t		offset;			// 当前文件位置
+  void		*map;			// 文件的内存映射
 
-        if (!mxmlRelease(node))
-          node = NULL;
-      }
 
-      if (!first && node)
-        first = node;
-    }
-    else if (mxml_isspace(ch) && type == MXML_TYPE_TEXT)
-    {
-      whitespace = true;
-    }
+  // 只映射常规文件...
+  if (fstat(fd, &fileinfo) || !S_ISREG(fileinfo.st_mode) || fileinfo.st_size <= 0 || (off_t)(size_t)fileinfo.st_size != fileinfo.st_size)
+    return (false);
 
-    if (ch == '\n')
-      line ++;
+  if ((offset = lseek(fd, 0, SEEK_CUR)) < 0 || offset >= fileinfo.st_size)
+    return (false);
 
-    // 如果有元素并且存在空白字符，则添加一个孤立的空白节点...
-    if (ch == '<' && whitespace && type == MXML_TYPE_TEXT)
-    {
-      if (parent)
-      {
-	node = mxmlNewText(parent, whitespace, "");
+  if ((map = mmap(NULL, (size_t)fileinfo.st_size, PROT_READ, MAP_PRIVATE, fd, 0)) == MAP_FAILED)
+    return (false);
 
-	if (options && options->sax_cb)
-	{
-	  if (!(options->sax_cb)(options->sax_cbdata, node, MXML_SAX_EVENT_DATA))
-	    goto error;
+#  ifdef MADV_SEQUENTIAL
+  // 数据只会被顺序读取一次，让内核积极地预读...
+  madvise(map, (size_t)fileinfo.st_size, MADV_SEQUENTIAL);
+#  endif // MADV_SEQUENTIAL
+
+  r->io_cb     = NULL;
+  r->io_cbdata = NULL;
+  r->encoding  = _MXML_ENCODING_UTF8;
+  r->buffer    = (unsigned char *)map;
+  r->bufptr    = r->buffer + offset;
+  r->bufend    = r->buffer + fileinfo.st_size;
+  r->bufsize   = (size_t)fileinfo.st_size;
+  r->readsize  = 0;
+  r->bufalloc  = false;
+  r->bufmap    = true;
+  r->insitu    = false;
+  r->raw       = NULL;
+  r->line      = 1;
+  r->lazy      = false;
+  r->context   = NULL;
 
-	  if (!mxmlRelease(node))
-	    node = NULL;
-	}
+  return (true);
 
-	if (!first && node)
-	  first = node;
-      }
+#else
+  (void)r;
+  (void)fd;
 
-      whitespace = false;
-    }
+  return (false);
+#endif // HAVE_SYS_MMAN_H
+}
 
-    if (ch == '<')
-    {
-      // 开始开/闭标签...
-      bufptr = buffer;
 
-      while ((ch = mxml_getc(options, io_cb, io_cbdata, &encoding)) != EOF)
-      {
-        if (mxml_isspace(ch) || ch == '>' || (ch == '/' && bufptr > buffer))
-        {
-	  break;
-	}
-	else if (ch == '<')
-	{
-	  _mxml_error(options, "元素中的单个 <。");
-	  goto error;
-	}
-	else if (ch == '&')
-	{
-	  if ((ch = mxml_get_entity(options, io_cb, io_cbdata, &encoding, parent, &line)) == EOF)
-	    goto error;
+//
+// 'mxml_read_init_utf16()' - 将输入缓冲区切换为读取时转换的UTF-16数据。
+//
+// 剩余的数据成为UTF-16数据的缓冲区，转换后的UTF-8数据使用新分配的缓冲区。解码后的UTF-8数据可能比
+// UTF-16数据长，因此不能原位解码。
+//
 
-	  if (!mxml_add_char(options, ch, &bufptr, &buffer, &bufsize))
-	    goto error;
-	}
-	else if (ch < '0' && ch != '!' && ch != '-' && ch != '.' && ch != '/')
-	{
-	  goto error;
-	}
-	else if (!mxml_add_char(options, ch, &bufptr, &buffer, &bufsize))
-	{
-	  goto error;
-	}
-	else if (((bufptr - buffer) == 1 && buffer[0] == '?') || ((bufptr - buffer) == 3 && !strncmp(buffer, "!--", 3)) || ((bufptr - buffer) == 8 && !strncmp(buffer, "![CDATA[", 8)))
-	{
-	  break;
-	}
+static bool				// O  - `true`表示成功，`false`表示内存不足
+mxml_read_init_utf16(
+    mxml_options_t   *options,		// I  - 选项
+    _mxml_read_t     *r,		// IO - 输入缓冲区
+    _mxml_encoding_t encoding)		// I  - UTF-16字节顺序
+{
+  r->encoding = encoding;
+  r->insitu   = false;
+  r->raw      = r->buffer;
+  r->rawptr   = r->bufptr;
+  r->rawend   = r->bufend;
+  r->rawsize  = r->bufsize;
+  r->rawalloc = r->bufalloc;
+  r->rawmap   = r->bufmap;
+  r->bufsize  = options && options->bufsize ? options->bufsize : MXML_BUFSIZE;
+  r->bufalloc = true;
+  r->bufmap   = false;
+
+  if ((r->buffer = malloc(r->bufsize)) == NULL)
+  {
+    if (options)
+      _mxml_error(options, "无法分配%lu字节的输入缓冲区。", (unsigned long)r->bufsize);
 
-	if (ch == '\n')
-	  line ++;
-      }
+    r->bufalloc = false;
+  }
 
-      *bufptr = '\0';
+  r->bufptr = r->buffer;
+  r->bufend = r->buffer;
 
-      if (!strcmp(buffer, "!--"))
-      {
-        // 收集剩余的注释...
-	while ((ch = mxml_getc(options, io_cb, io_cbdata, &encoding)) != EOF)
-	{
-	  if (ch == '>' && bufptr > (buffer + 4) && bufptr[-3] != '-' && bufptr[-2] == '-' && bufptr[-1] == '-')
-	    break;
-	  else if (!mxml_add_char(options, ch, &bufptr, &buffer, &bufsize))
-	    goto error;
+  return (r->buffer != NULL);
+}
 
-	  if (ch == '\n')
-	    line ++;
-	}
 
-        // 如果没有获取到整个注释，则报错...
-        if (ch != '>')
-	{
-	  // 打印错误并返回...
-	  _mxml_error(options, "注释节点在第 %d 行遇到早期的 EOF。", line);
-	  goto error;
-	}
+//
+// 'mxml_records_error()' - 记录逐个加载记录时的错误并显示错误消息。
+//
 
-        // 否则将其作为元素添加到当前父节点下...
-	bufptr[-2] = '\0';
+static void
+mxml_records_error(
+    _mxml_records_t *rec,		// I - 逐个记录加载的状态
+    const char      *message)		// I - 错误消息
+{
+  rec->error = true;
 
-        if (!parent && first)
-	{
-	  // 只能有一个根元素！
-	  _mxml_error(options, "<%s--> 在 <%s> 之后不能作为第二个根节点，在第 %d 行。", buffer, first->value.element.name, line);
-          goto error;
-	}
+  if (rec->options && rec->options->error_cb)
+    (rec->options->error_cb)(rec->options->error_cbdata, message);
+  else
+    fprintf(stderr, "%s\n", message);
+}
 
-	if ((node = mxmlNewComment(parent, buffer + 3)) == NULL)
-	{
-	  // 只打印错误...
-	  _mxml_error(options, "无法将注释节点添加到父节点 <%s> 中，在第 %d 行。", parent ? parent->value.element.name : "null", line);
-	  break;
-	}
 
-	MXML_DEBUG("mxml_load_data: node=%p(<%s-->), parent=%p\n", node, buffer, parent);
+//
+// 'mxml_records_sax()' - 逐个加载记录的SAX回调函数。
+//
+// 只保留当前记录中的节点，记录元素关闭时从节点树中移除记录并传递给记录回调函数。
+//
+
+static bool				// O - `true`表示继续，`false`表示停止
+mxml_records_sax(
+    _mxml_records_t  *rec,		// I - 逐个记录加载的状态
+    mxml_node_t      *node,		// I - 节点
+    mxml_sax_event_t event)		// I - SAX事件
+{
+  _mxml_global_t	*global;	// 全局数据
+  bool			ret;		// 记录回调函数的返回值
+
 
-        if (options && options->sax_cb)
+  switch (event)
+  {
+    case MXML_SAX_EVENT_ELEMENT_OPEN :
+        rec->depth ++;
+
+        if (rec->record)
         {
-          if (!(options->sax_cb)(options->sax_cbdata, node, MXML_SAX_EVENT_COMMENT))
-	    goto error;
+          // 记录中的元素...
+          mxmlRetain(node);
+        }
+        else if (rec->name ? !strcmp(node->value.element.name, rec->name) : rec->depth == 2)
+        {
+          // 新的记录，之后的子节点从记录自己的内存池中分配...
+          if (rec->arena)
+          {
+            if ((rec->doc = _mxml_doc_new(true)) == NULL)
+            {
+              rec->error = true;
+              return (false);
+            }
 
-          if (!mxmlRelease(node))
-            node = NULL;
+            rec->doc->intern = rec->intern;
+
+            global      = _mxml_global();
+            rec->olddoc = global->doc;
+            global->doc = rec->doc;
+          }
+
+          mxmlRetain(node);
+          rec->record = node;
         }
+        break;
 
-	if (node && !first)
-	  first = node;
-      }
-      else if (!strcmp(buffer, "![CDATA["))
-      {
-        // 收集 CDATA 部分...
-	while ((ch = mxml_getc(options, io_cb, io_cbdata, &encoding)) != EOF)
-	{
-	  if (ch == '>' && !strncmp(bufptr - 2, "]]", 2))
-	  {
-	    // 从 CDATA 字符串中删除终止符...
-	    bufptr[-2] = '\0';
-	    break;
-	  }
-	  else if (!mxml_add_char(options, ch, &bufptr, &buffer, &bufsize))
-	  {
-	    goto error;
-	  }
+    case MXML_SAX_EVENT_ELEMENT_CLOSE :
+        rec->depth --;
 
-	  if (ch == '\n')
-	    line ++;
-	}
+        if (node != rec->record)
+          break;
 
-        // 如果没有获取到整个 CDATA 部分，则报错...
-        if (ch != '>')
-	{
-	  // 打印错误并返回...
-	  _mxml_error(options, "CDATA 节点在第 %d 行遇到早期的 EOF。", line);
-	  goto error;
-	}
+        // 记录完成，文档在删除记录的最后一个节点时释放...
+        if (rec->doc)
+        {
+          _mxml_global()->doc = rec->olddoc;
+          _mxml_doc_release(rec->doc);
+          rec->doc = NULL;
+        }
 
-        // 否则将其作为元素添加到当前父节点下...
-	bufptr[-2] = '\0';
+        rec->record = NULL;
+        rec->last   = node;
 
-        if (!parent && first)
-	{
-	  // 只能有一个根元素！
-	  _mxml_error(options, "<%s]]> 在 <%s> 之后不能作为第二个根节点，在第 %d 行。", buffer, first->value.element.name, line);
-          goto error;
-	}
+        mxmlRemove(node);
 
-	if ((node = mxmlNewCDATA(parent, buffer + 8)) == NULL)
-	{
-	  // 打印错误并返回...
-	  _mxml_error(options, "无法将 CDATA 节点添加到父节点 <%s> 中，在第 %d 行。", parent ? parent->value.element.name : "null", line);
-	  goto error;
-	}
+        ret = (rec->record_cb)(rec->record_cbdata, node);
 
-	MXML_DEBUG("mxml_load_data: node=%p(<%s]]>), parent=%p\n", node, buffer, parent);
+        mxmlRelease(node);
 
-        if (options && options->sax_cb)
+        if (!ret)
         {
-          if (!(options->sax_cb)(options->sax_cbdata, node, MXML_SAX_EVENT_CDATA))
-	    goto error;
-
-          if (!mxmlRelease(node))
-            node = NULL;
+          // 停止加载时加载器不会释放记录，在加载之后释放...
+          rec->stopped = node;
+          return (false);
         }
+        break;
 
-	if (node && !first)
-	  first = node;
-      }
-      else if (buffer[0] == '?')
-      {
-        // 收集剩余的处理指令...
-	while ((ch = mxml_getc(options, io_cb, io_cbdata, &encoding)) != EOF)
-	{
-	  if (ch == '>' && bufptr > buffer && bufptr[-1] == '?')
-	    break;
-	  else if (!mxml_add_char(options, ch, &bufptr, &buffer, &bufsize))
-	    goto error;
+    default :
+        // 只保留记录中的值、注释、CDATA、处理指令和声明...
+        if (rec->record)
+          mxmlRetain(node);
+        break;
+  }
+
+  return (true);
+}
+
+
+#ifdef HAVE_PTHREAD_H
+//
+// 'mxml_save_part()' - 写入并行保存的下一段子节点。
+//
+// 调用时必须锁定互斥锁，写入时解锁。没有可以写入的段时返回`false`。
+//
+
+static bool				// O - `true`表示写入了一段，`false`表示没有可以写入的段
+mxml_save_part(_mxml_save_t *save)	// I - 并行保存的状态
+{
+  _mxml_save_part_t	*part;		// 段
+  mxml_node_t		*first,		// 段的第一个子节点
+			*last;		// 段的最后一个子节点
+  size_t		count;		// 段的子节点数
+  _mxml_write_t		w;		// 输出缓冲区
+  int			col;		// 当前列数
+
+
+  // 只写入输出之前可以保存的段...
+  if (save->error || !save->next || (save->assigned - save->written) >= save->window)
+    return (false);
 
-	  if (ch == '\n')
-	    line ++;
-	}
+  part = save->parts + save->assigned % save->window;
+  save->assigned ++;
 
-        // 如果没有获取到整个处理指令，则报错...
-        if (ch != '>')
-	{
-	  // 打印错误并返回...
-	  _mxml_error(options, "处理指令节点在第 %d 行遇到早期的 EOF。", line);
-	  goto error;
-	}
+  // 下一段从至少`run`个子节点之后的标记之后开始，开头的列数是确定的...
+  for (first = last = save->next, count = 1; last->next && (count < save->run || !mxml_is_markup(last)); last = last->next, count ++);
 
-        // 否则将其作为元素添加到当前父节点下...
-	bufptr[-1] = '\0';
+  save->next = last->next;
 
-        if (!parent && first)
-	{
-	  // 只能有一个根元素！
-	  _mxml_error(options, "<%s?> 在 <%s> 之后不能作为第二个根节点，在第 %d 行。", buffer, first->value.element.name, line);
-          goto error;
-	}
+  pthread_mutex_unlock(&save->mutex);
 
-	if ((node = mxmlNewDirective(parent, buffer + 1)) == NULL)
-	{
-	  // 打印错误并返回...
-	  _mxml_error(options, "无法将处理指令节点添加到父节点 <%s> 中，在第 %d 行。", parent ? parent->value.element.name : "null", line);
-	  goto error;
-	}
+  part->sb.bufptr = part->sb.buffer;
 
-	MXML_DEBUG("mxml_load_data: node=%p(<%s?>), parent=%p\n", node, buffer, parent);
+  if (_mxml_write_init(&w, save->options, (mxml_io_cb_t)mxml_io_cb_string, &part->sb))
+  {
+    col = mxml_write_node(first, last, save->options, &w, save->depth, 1);
 
-        if (options && options->sax_cb)
-        {
-          if (!(options->sax_cb)(options->sax_cbdata, node, MXML_SAX_EVENT_DIRECTIVE))
-	    goto error;
+    if (col >= 0 && !_mxml_write_flush(&w))
+      col = -1;
 
-          if (strncmp(node->value.directive, "xml ", 4) && !mxmlRelease(node))
-            node = NULL;
-        }
+    _mxml_write_free(&w);
+  }
+  else
+  {
+    col = -1;
+  }
 
-        if (node)
-	{
-	  if (!first)
-            first = node;
+  pthread_mutex_lock(&save->mutex);
 
-	  if (!parent)
-	  {
-	    parent = node;
+  part->col  = col;
+  part->done = true;
 
-	    if (options && options->type_cb)
-	      type = (options->type_cb)(options->type_cbdata, parent);
-	    else if (options)
-	      type = options->type_value;
-	    else
-	      type = MXML_TYPE_TEXT;
-	  }
-	}
-      }
-      else if (buffer[0] == '!')
-      {
-        // 收集剩余的声明...
-	do
-	{
-	  if (ch == '>')
-	  {
-	    break;
-	  }
-	  else
-	  {
-            if (ch == '&')
-            {
-	      if ((ch = mxml_get_entity(options, io_cb, io_cbdata, &encoding, parent, &line)) == EOF)
-		goto error;
-            }
+  if (col < 0)
+    save->error = true;
 
-	    if (!mxml_add_char(options, ch, &bufptr, &buffer, &bufsize))
-	      goto error;
-	  }
+  pthread_cond_broadcast(&save->cond);
 
-	  if (ch == '\n')
-	    line ++;
-	}
-        while ((ch = mxml_getc(options, io_cb, io_cbdata, &encoding)) != EOF);
+  return (true);
+}
 
-        // 如果没有获取到整个声明，则报错...
-        if (ch != '>')
-	{
-	  // 打印错误并返回...
-	  _mxml_error(options, "声明节点在第 %d 行遇到早期的 EOF。", line);
-	  goto error;
-	}
 
-        // 否则将其作为元素添加到当前父节点下...
-	*bufptr = '\0';
+//
+// 'mxml_save_thread()' - 在线程中写入并行保存的子节点。
+//
 
-        if (!parent && first)
-	{
-	  // 只能有一个根元素！
-	  _mxml_error(options, "<%s> 在 <%s> 之后不能作为第二个根节点，在第 %d 行。", buffer, first->value.element.name, line);
-          goto error;
-	}
+static void *				// O - 总是`NULL`
+mxml_save_thread(_mxml_save_t *save)	// I - 并行保存的状态
+{
+  pthread_mutex_lock(&save->mutex);
 
-	if ((node = mxmlNewDeclaration(parent, buffer + 1)) == NULL)
-	{
-	  // 打印错误并返回...
-	  _mxml_error(options, "无法将声明节点添加到父节点 <%s> 中，在第 %d 行。", parent ? parent->value.element.name : "null", line);
-	  goto error;
-	}
+  while (!save->error && save->next)
+  {
+    // 等待输出释放缓冲区...
+    if (!mxml_save_part(save))
+      pthread_cond_wait(&save->cond, &save->mutex);
+  }
 
-	MXML_DEBUG("mxml_load_data: node=%p(<%s>), parent=%p\n", node, buffer, parent);
+  pthread_mutex_unlock(&save->mutex);
 
-        if (options && options->sax_cb)
-        {
-          if (!(options->sax_cb)(options->sax_cbdata, node, MXML_SAX_EVENT_DECLARATION))
-	    goto error;
+  return (NULL);
+}
+#endif // HAVE_PTHREAD_H
 
-          if (!mxmlRelease(node))
-            node = NULL;
-        }
 
-        if (node)
-	{
-	  if (!first)
-            first = node;
+//
+// 'mxml_sax_event()' - 调用SAX回调函数。
+//
+// 临时SAX模式中，回调函数创建的节点属于保留的节点所属的文档，而不是临时文档；回调函数在临时文档中
+// 分配的内存（例如临时元素的新属性）不再返回内存池。
+//
 
-	  if (!parent)
-	  {
-	    parent = node;
+static bool				// O - 继续加载时为`true`
+mxml_sax_event(
+    mxml_options_t   *options,		// I - 选项
+    mxml_node_t      *node,		// I - 节点
+    mxml_sax_event_t event)		// I - SAX事件
+{
+  _mxml_global_t *global;		// 全局数据
+  _mxml_doc_t	*doc = node->doc,	// 临时文档
+		*olddoc;		// 之前正在加载的文档
+  _mxml_chunk_t	*chunk;			// 内存池的当前块
+  char		*ptr;			// 当前块中下一个可用字节
+  bool		ret;			// 返回值
 
-	    if (options && options->type_cb)
-	      type = (options->type_cb)(options->type_cbdata, parent);
-	    else if (options)
-	      type = options->type_value;
-	    else
-	      type = MXML_TYPE_TEXT;
-	  }
-	}
-      }
-      else if (buffer[0] == '/')
-      {
-        // 处理闭合标签...
-	MXML_DEBUG("mxml_load_data: <%s>, parent=%p\n", buffer, parent);
 
-        if (!parent || strcmp(buffer + 1, parent->value.element.name))
-	{
-	  // 闭合标签与树不匹配；暂时只打印错误...
-	  _mxml_error(options, "不匹配的闭合标签 <%s>，在父节点 <%s> 下，在第 %d 行。", buffer, parent ? parent->value.element.name : "(null)", line);
-          goto error;
-	}
+  if (!doc || !doc->transient)
+    return ((options->sax_cb)(options->sax_cbdata, node, event));
 
-        // 继续读取，直到遇到 >...
-        while (ch != '>' && ch != EOF)
-	  ch = mxml_getc(options, io_cb, io_cbdata, &encoding);
+  global      = _mxml_global();
+  olddoc      = global->doc;
+  global->doc = doc->keep;
+  chunk       = doc->chunks;
+  ptr         = chunk ? chunk->ptr : NULL;
 
-        node   = parent;
-        parent = parent->parent;
+  ret = (options->sax_cb)(options->sax_cbdata, node, event);
 
-        if (options && options->sax_cb)
-        {
-          if (!(options->sax_cb)(options->sax_cbdata, node, MXML_SAX_EVENT_ELEMENT_CLOSE))
-	    goto error;
+  global->doc = olddoc;
 
-          if (!mxmlRelease(node))
-          {
-            if (first == node)
-	      first = NULL;
+  // 回调函数修改临时节点时分配的内存在加载结束前保持有效...
+  if (doc->chunks != chunk || (chunk && chunk->ptr != ptr))
+    doc->pin = doc->chunks->ptr;
 
-	    node = NULL;
-	  }
-        }
+  return (ret);
+}
 
-        // 向上进入父节点，并根据需要设置值类型...
-	if (options && options->type_cb && parent)
-	  type = (options->type_cb)(options->type_cbdata, parent);
-	else if (options && !options->type_cb)
-	  type = options->type_value;
-      }
-      else
-      {
-        // 处理开放标签...
-        if (!parent && first)
-	{
-	  // 只能有一个根元素！
-	  _mxml_error(options, "<%s> 在 <%s> 之后不能作为第二个根节点，在第 %d 行。", buffer, first->value.element.name, line);
-          goto error;
-	}
 
-        if ((node = mxmlNewElement(parent, buffer)) == NULL)
-	{
-	  // 暂时只打印错误...
-	  _mxml_error(options, "无法将元素节点添加到父节点 <%s> 中，在第 %d 行。", parent ? parent->value.element.name : "null", line);
-	  goto error;
-	}
+//
+// 'mxml_sax_keep()' - 将保留的临时节点复制到节点树中。
+//
+// 复制的节点属于原来的文档并替换临时节点，元素的子节点移到复制的元素中。非临时节点直接返回。
+//
 
-        if (mxml_isspace(ch))
-        {
-	  MXML_DEBUG("mxml_load_data: node=%p(<%s...>), parent=%p\n", node, buffer, parent);
+static mxml_node_t *			// O - 复制的节点，如果内存不足则为`NULL`
+mxml_sax_keep(mxml_node_t *node)	// I - 保留的节点
+{
+  _mxml_doc_t	*doc = node->doc,	// 临时文档
+		*olddoc;		// 之前正在加载的文档
+  _mxml_global_t *global;		// 全局数据
+  mxml_node_t	*copy,			// 复制的节点
+		*child;			// 子节点
+  size_t	i;			// 循环变量
 
-	  if ((ch = mxml_parse_element(options, io_cb, io_cbdata, node, &encoding, &line)) == EOF)
-	    goto error;
-        }
-        else if (ch == '/')
-	{
-	  MXML_DEBUG("mxml_load_data: node=%p(<%s/>), parent=%p\n", node, buffer, parent);
 
-	  if ((ch = mxml_getc(options, io_cb, io_cbdata, &encoding)) != '>')
-	  {
-	    _mxml_error(options, "元素 <%s/> 预期为 >，但实际为 '%c'，在第 %d 行。", buffer, ch, line);
-            mxmlDelete(node);
-            node = NULL;
-            goto error;
-	  }
+  if (!doc || !doc->transient)
+    return (node);
 
-	  ch = '/';
-	}
+  global      = _mxml_global();
+  olddoc      = global->doc;
+  global->doc = doc->keep;
 
-        if (options && options->sax_cb)
-        {
-          if (!(options->sax_cb)(options->sax_cbdata, node, MXML_SAX_EVENT_ELEMENT_OPEN))
-	    goto error;
-	}
+  switch (node->type)
+  {
+    case MXML_TYPE_CDATA :
+        copy = mxmlNewCDATA(NULL, node->value.cdata);
+        break;
 
-        if (!first)
-	  first = node;
+    case MXML_TYPE_COMMENT :
+        copy = mxmlNewComment(NULL, node->value.comment);
+        break;
 
-	if (ch == EOF)
-	  break;
+    case MXML_TYPE_DECLARATION :
+        copy = mxmlNewDeclaration(NULL, node->value.declaration);
+        break;
 
-        if (ch != '/')
-	{
-	  // 进入此节点，并根据需要设置值类型...
-	  parent = node;
+    case MXML_TYPE_DIRECTIVE :
+        copy = mxmlNewDirective(NULL, node->value.directive);
+        break;
 
-	  if (options && options->type_cb && parent)
-	    type = (options->type_cb)(options->type_cbdata, parent);
-	  else if (options && !options->type_cb)
-	    type = options->type_value;
-	  else
-	    type = MXML_TYPE_TEXT;
-	}
-        else if (options && options->sax_cb)
+    case MXML_TYPE_ELEMENT :
+        if ((copy = mxmlNewElement(NULL, node->value.element.name)) != NULL)
         {
-          if (!(options->sax_cb)(options->sax_cbdata, node, MXML_SAX_EVENT_ELEMENT_CLOSE))
-	    goto error;
+          for (i = 0; i < node->value.element.num_attrs; i ++)
+            mxmlElementSetAttr(copy, node->value.element.attrs[i].name, node->value.element.attrs[i].value);
+        }
+        break;
 
-          if (!mxmlRelease(node))
-          {
-            if (first == node)
-	      first = NULL;
+    case MXML_TYPE_INTEGER :
+        copy = mxmlNewInteger(NULL, node->value.integer);
+        break;
 
-	    node = NULL;
-	  }
-        }
-      }
+    case MXML_TYPE_OPAQUE :
+        copy = mxmlNewOpaque(NULL, node->value.opaque);
+        break;
 
-      bufptr  = buffer;
-    }
-    else if (ch == '&')
-    {
-      // 将字符实体添加到当前缓冲区...
-      if ((ch = mxml_get_entity(options, io_cb, io_cbdata, &encoding, parent, &line)) == EOF)
-	goto error;
+    case MXML_TYPE_REAL :
+        copy = mxmlNewReal(NULL, node->value.real);
+        break;
 
-      if (!mxml_add_char(options, ch, &bufptr, &buffer, &bufsize))
-	goto error;
-    }
-    else if (type == MXML_TYPE_OPAQUE || type == MXML_TYPE_CUSTOM || !mxml_isspace(ch))
+    case MXML_TYPE_TEXT :
+        copy = mxmlNewText(NULL, node->value.text.whitespace, node->value.text.string);
+        break;
+
+    case MXML_TYPE_CUSTOM :
+        // 自定义数据转移到复制的节点中...
+        if ((copy = mxmlNewCustom(NULL, node->value.custom.data, node->value.custom.free_cb, node->value.custom.free_cbdata)) != NULL)
+          node->value.custom.data = NULL;
+        break;
+
+    default :
+        copy = NULL;
+        break;
+  }
+
+  global->doc = olddoc;
+
+  if (copy)
+  {
+    copy->ref_count = node->ref_count;
+    copy->user_data = node->user_data;
+
+    if ((copy->child = node->child) != NULL)
     {
-      // 将字符添加到当前缓冲区...
-      if (!mxml_add_char(options, ch, &bufptr, &buffer, &bufsize))
-	goto error;
+      copy->last_child = node->last_child;
+      node->child      = NULL;
+      node->last_child = NULL;
+
+      for (child = copy->child; child; child = child->next)
+        child->parent = copy;
     }
+
+    mxmlAdd(node->parent, MXML_ADD_AFTER, node, copy);
   }
-  while ((ch = mxml_getc(options, io_cb, io_cbdata, &encoding)) != EOF);
 
-  // 释放字符串缓冲区 - 我们不再需要它了...
-  free(buffer);
+  // 删除临时节点并将其内存返回内存池...
+  mxmlDelete(node);
+  _mxml_doc_pop(doc, node);
 
-  // 查找顶级元素并返回它...
-  if (parent)
-  {
-    node = parent;
+  return (copy);
+}
 
-    while (parent != top && parent->parent)
-      parent = parent->parent;
 
-    if (node != parent)
-    {
-      _mxml_error(options, "在父节点 <%s> 下缺少闭合标签 </%s>，在第 %d 行。", mxmlGetElement(node), node->parent ? node->parent->value.element.name : "(null)", line);
+//
+// 'mxml_sax_release()' - 在SAX事件之后释放节点。
+//
+// 临时节点删除后立即将其内存返回内存池，SAX回调函数保留的临时节点复制到节点树中。
+//
 
-      mxmlDelete(first);
+static mxml_node_t *			// O - 保留的节点或`NULL`
+mxml_sax_release(mxml_node_t *node)	// I - 节点或`NULL`
+{
+  _mxml_doc_t	*doc;			// 节点所属的文档
 
-      return (NULL);
-    }
+
+  if (!node)
+    return (NULL);
+
+  doc = node->doc;
+
+  if (!mxmlRelease(node))
+  {
+    if (doc && doc->transient)
+      _mxml_doc_pop(doc, node);
+
+    return (NULL);
   }
 
-  if (parent)
-    return (parent);
-  else
-    return (first);
+  return (mxml_sax_keep(node));
+}
 
-  // 常见的错误返回...
-  error:
 
-  mxmlDelete(first);
+//
+// 'mxml_scan()' - 查找第一个不是普通字符的字节。
+//
+// 返回从`s`开始的可打印ASCII字符（不包括`d1`、`d2`和`d3`）的字节数。不需要查找三个终止字符时
+// 可以重复传递同一个字符。支持时使用AVX2或SSE2一次比较32或16个字节。
+//
 
-  free(buffer);
+static size_t				// O - 普通字符的字节数
+mxml_scan(const unsigned char *s,	// I - 开始位置
+          const unsigned char *end,	// I - 数据的结尾
+          int                 d1,	// I - 第一个终止字符
+          int                 d2,	// I - 第二个终止字符
+          int                 d3)	// I - 第三个终止字符
+{
+#ifndef MXML_SCAN_SSE2
+  const unsigned char	*ptr;		// 当前位置
+#endif // !MXML_SCAN_SSE2
+
+
+#ifdef MXML_SCAN_AVX2
+#  ifdef __AVX2__
+  return (mxml_scan_avx2(s, end, d1, d2, d3));
+#  else
+  if (__builtin_cpu_supports("avx2"))
+    return (mxml_scan_avx2(s, end, d1, d2, d3));
+#  endif // __AVX2__
+#endif // MXML_SCAN_AVX2
+
+#ifdef MXML_SCAN_SSE2
+  return (mxml_scan_sse2(s, end, d1, d2, d3));
+#else
+  for (ptr = s; ptr < end && *ptr >= ' ' && *ptr < 0x80 && *ptr != d1 && *ptr != d2 && *ptr != d3; ptr ++);
 
-  return (NULL);
+  return ((size_t)(ptr - s));
+#endif // MXML_SCAN_SSE2
 }
 
+
+#ifdef MXML_SCAN_AVX2
 //
-// 'mxml_parse_element()' - 解析元素的属性...
+// 'mxml_scan_avx2()' - 使用AVX2查找第一个不是普通字符的字节。
 //
 
-static int				// O  - 终止字符
-mxml_parse_element(
-    mxml_options_t   *options,		// I - 选项
-    mxml_io_cb_t     io_cb,		// I - 读取回调函数
-    void             *io_cbdata,	// I - 读取回调数据
-    mxml_node_t      *node,		// I  - 元素节点
-    _mxml_encoding_t *encoding,		// IO - 编码
-    int              *line)		// IO - 当前行号
+#  ifndef __AVX2__
+__attribute__((target("avx2")))
+#  endif // !__AVX2__
+static size_t				// O - 普通字符的字节数
+mxml_scan_avx2(const unsigned char *s,	// I - 开始位置
+               const unsigned char *end,// I - 数据的结尾
+               int                 d1,	// I - 第一个终止字符
+               int                 d2,	// I - 第二个终止字符
+               int                 d3)	// I - 第三个终止字符
 {
-  int		ch,			// 文件中的当前字符
-		quote;			// 引用字符
-  char		*name,			// 属性名
-		*value,			// 属性值
-		*ptr;			// 指向属性名/值的指针
-  size_t	namesize,		// 属性名字符串的大小
-		valsize;		// 属性值字符串的大小
+  const unsigned char	*ptr;		// 当前位置
+  __m256i		v1 = _mm256_set1_epi8((char)d1),
+			v2 = _mm256_set1_epi8((char)d2),
+			v3 = _mm256_set1_epi8((char)d3),
+			vspace = _mm256_set1_epi8(' '),
+			data;		// 当前的32个字节
+  unsigned		mask;		// 不是普通字符的字节
 
 
-  // 初始化属性名和属性值缓冲区...
-  if ((name = malloc(64)) == NULL)
+  for (ptr = s; (end - ptr) >= 32; ptr += 32)
   {
-    _mxml_error(options, "无法为属性名分配内存.");
-    return (EOF);
+    // 有符号比较时，控制字符和非ASCII字节（0x80-0xff）都小于空格...
+    data = _mm256_loadu_si256((const __m256i *)ptr);
+    mask = (unsigned)_mm256_movemask_epi8(_mm256_or_si256(_mm256_or_si256(_mm256_cmpeq_epi8(data, v1), _mm256_cmpeq_epi8(data, v2)), _mm256_or_si256(_mm256_cmpeq_epi8(data, v3), _mm256_cmpgt_epi8(vspace, data))));
+
+    if (mask)
+      return ((size_t)(ptr - s) + (size_t)__builtin_ctz(mask));
   }
 
-  namesize = 64;
+  for (; ptr < end && *ptr >= ' ' && *ptr < 0x80 && *ptr != d1 && *ptr != d2 && *ptr != d3; ptr ++);
 
-  if ((value = malloc(64)) == NULL)
-  {
-    free(name);
-    _mxml_error(options, "无法为属性值分配内存.");
-    return (EOF);
-  }
+  return ((size_t)(ptr - s));
+}
+#endif // MXML_SCAN_AVX2
 
-  valsize = 64;
 
-  // 循环直到遇到 >、/、? 或 EOF...
-  while ((ch = mxml_getc(options, io_cb, io_cbdata, encoding)) != EOF)
+#ifdef MXML_SCAN_SSE2
+//
+// 'mxml_scan_sse2()' - 使用SSE2查找第一个不是普通字符的字节。
+//
+
+static size_t				// O - 普通字符的字节数
+mxml_scan_sse2(const unsigned char *s,	// I - 开始位置
+               const unsigned char *end,// I - 数据的结尾
+               int                 d1,	// I - 第一个终止字符
+               int                 d2,	// I - 第二个终止字符
+               int                 d3)	// I - 第三个终止字符
+{
+  const unsigned char	*ptr;		// 当前位置
+  __m128i		v1 = _mm_set1_epi8((char)d1),
+			v2 = _mm_set1_epi8((char)d2),
+			v3 = _mm_set1_epi8((char)d3),
+			vspace = _mm_set1_epi8(' '),
+			data;		// 当前的16个字节
+  unsigned		mask;		// 不是普通字符的字节
+#  ifdef _MSC_VER
+  unsigned long		bit;		// 第一个不是普通字符的字节
+#  endif // _MSC_VER
+
+
+  for (ptr = s; (end - ptr) >= 16; ptr += 16)
   {
-    MXML_DEBUG("mxml_parse_element: ch='%c'\n", ch);
+    // 有符号比较时，控制字符和非ASCII字节（0x80-0xff）都小于空格...
+    data = _mm_loadu_si128((const __m128i *)ptr);
+    mask = (unsigned)_mm_movemask_epi8(_mm_or_si128(_mm_or_si128(_mm_cmpeq_epi8(data, v1), _mm_cmpeq_epi8(data, v2)), _mm_or_si128(_mm_cmpeq_epi8(data, v3), _mm_cmplt_epi8(data, vspace))));
 
-    // 跳过前导空白字符...
-    if (mxml_isspace(ch))
+    if (mask)
     {
-      if (ch == '\n')
-        (*line)++;
-
-      continue;
+#  ifdef _MSC_VER
+      _BitScanForward(&bit, mask);
+      return ((size_t)(ptr - s) + bit);
+#  else
+      return ((size_t)(ptr - s) + (size_t)__builtin_ctz(mask));
+#  endif // _MSC_VER
     }
+  }
 
-    // 在 /、? 或 > 处停止...
-    if (ch == '/' || ch == '?')
-    {
-      // 获取 > 字符，如果不存在则打印错误...
-      quote = mxml_getc(options, io_cb, io_cbdata, encoding);
+  for (; ptr < end && *ptr >= ' ' && *ptr < 0x80 && *ptr != d1 && *ptr != d2 && *ptr != d3; ptr ++);
 
-      if (quote != '>')
-      {
-        _mxml_error(options, "在元素 %s 的 '%c' 后期望 '>'，但在第 %d 行得到 '%c'。", ch, mxmlGetElement(node), quote, *line);
-        goto error;
-      }
+  return ((size_t)(ptr - s));
+}
+#endif // MXML_SCAN_SSE2
 
-      break;
-    }
-    else if (ch == '<')
-    {
-      _mxml_error(options, "在元素 %s 中存在裸的 <，位于第 %d 行。", mxmlGetElement(node), *line);
-      goto error;
-    }
-    else if (ch == '>')
-    {
-      break;
-    }
 
-    // 读取属性名...
-    ptr = name;
-    if (!mxml_add_char(options, ch, &ptr, &name, &namesize))
-      goto error;
+//
+// 'mxml_skip()' - 跳过元素的内容而不创建节点。
+//
+// 只检查标记的嵌套，不解码实体也不检查字符。`intag`为`true`时先跳过元素开放标签的其余部分（属性），
+// 空元素在开放标签的结尾结束。`children`为`true`时在下一个子元素的开放标签或元素的闭合标签处停止，
+// 输入缓冲区指向它的"<"，否则跳过元素的闭合标签。
+//
 
-    if (ch == '\"' || ch == '\'')
+static unsigned char *			// O  - 停止处标记的"<"（只对内存中的数据有效），`NULL`表示错误
+mxml_skip(mxml_options_t *options,	// I  - 选项
+          _mxml_read_t   *r,		// IO - 输入缓冲区
+          const char     *name,		// I  - 元素名称
+          bool           intag,		// I  - 是否在元素的开放标签中？
+          bool           children,	// I  - 是否在下一个子元素处停止？
+          int            *line)		// IO - 当前行号
+{
+  size_t	namelen = strlen(name),	// 元素名称的长度
+		i,			// 已比较的名称字节数
+		count,			// 比较的字节数
+		termlen,		// 标记结尾的长度
+		depth = intag ? 0 : 1;	// 打开的元素数（包括这个元素）
+  unsigned char	*ptr = r->bufptr,	// 当前位置
+		*next,			// 下一个"<"或标记结尾
+		*close = NULL;		// 停止处标记的开头
+  const char	*term;			// 标记的结尾
+  int		ch,			// 当前字节
+		prev = ' ',		// 上一个字节
+		last,			// 标记结尾之前的字节或-1
+		quote = 0;		// 引号字符
+  bool		eof = true;		// 错误是否为数据结尾？
+
+
+  for (;;)
+  {
+    if (intag)
     {
-      // 属性名在引号中，获取带引号的字符串...
-      quote = ch;
-
-      while ((ch = mxml_getc(options, io_cb, io_cbdata, encoding)) != EOF)
+      // 开放标签的其余部分，属性值可以包含">"...
+      for (;;)
       {
-        if (ch == '&')
-        {
-	  if ((ch = mxml_get_entity(options, io_cb, io_cbdata, encoding, node, line)) == EOF)
-	    goto error;
-	}
-	else if (ch == '\n')
-	{
-	  (*line)++;
-	}
+        if (ptr >= r->bufend && !mxml_skip_fill(r, &ptr, 1, line))
+          goto error;
 
-	if (!mxml_add_char(options, ch, &ptr, &name, &namesize))
-	  goto error;
+        ch = *ptr++;
 
-	if (ch == quote)
-          break;
-      }
-    }
-    else
-    {
-      // 获取普通的非引号属性名...
-      while ((ch = mxml_getc(options, io_cb, io_cbdata, encoding)) != EOF)
-      {
-	if (mxml_isspace(ch) || ch == '=' || ch == '/' || ch == '>' || ch == '?')
-	{
-	  if (ch == '\n')
-	    (*line)++;
-          break;
-        }
-	else
-	{
-          if (ch == '&')
+        if (quote)
+        {
+          if (ch == quote)
           {
-	    if ((ch = mxml_get_entity(options, io_cb, io_cbdata, encoding, node, line)) == EOF)
-	      goto error;
+            // 带引号的字符串之后可以直接开始下一个属性...
+            quote = 0;
+            ch    = ' ';
           }
+        }
+        else if ((ch == '\"' || ch == '\'') && (prev == '=' || MXML_ISSPACE(prev)))
+        {
+          // 与mxml_parse_element（）相同，只有属性名或属性值开头的引号开始带引号的字符串，
+          // 不带引号的名称和值中的引号是普通字符...
+          quote = ch;
+        }
+        else if (ch == '>')
+        {
+          break;
+        }
 
-	  if (!mxml_add_char(options, ch, &ptr, &name, &namesize))
-	    goto error;
-	}
+        prev = ch;
       }
-    }
 
-    *ptr = '\0';
+      intag = false;
 
-    if (mxmlElementGetAttr(node, name))
-    {
-      _mxml_error(options, "在元素 %s 中重复的属性 '%s'，位于第 %d 行。", name, mxmlGetElement(node), *line);
-      goto error;
+      if (prev != '/')
+        depth ++;
+      else if (depth == 0)
+        break;				// 空元素
+
+      continue;
     }
 
-    while (ch != EOF && mxml_isspace(ch))
+    // 查找下一个标记...
+    if ((next = memchr(ptr, '<', (size_t)(r->bufend - ptr))) == NULL)
     {
-      ch = mxml_getc(options, io_cb, io_cbdata, encoding);
+      ptr = r->bufend;
 
-      if (ch == '\n')
-        (*line)++;
+      if (!mxml_skip_fill(r, &ptr, 1, line))
+        goto error;
+
+      continue;
     }
 
-    if (ch == '=')
+    // 确定标记的类型最多需要"<![CDATA["的9个字节...
+    ptr = next;
+
+    if ((r->bufend - ptr) < 9)
+      mxml_skip_fill(r, &ptr, 9, line);
+
+    if ((r->bufend - ptr) < 2)
+      goto error;
+
+    if (ptr[1] == '/' && depth == 1)
     {
-      // 读取属性值...
-      while ((ch = mxml_getc(options, io_cb, io_cbdata, encoding)) != EOF && mxml_isspace(ch))
+      // 元素的闭合标签...
+      if (children)
       {
-        if (ch == '\n')
-          (*line)++;
+        close = ptr;
+        break;
       }
 
-      if (ch == EOF)
-      {
-        _mxml_error(options, "在元素 %s 的属性 '%s' 中缺少值，位于第 %d 行。", name, mxmlGetElement(node), *line);
-        goto error;
-      }
+      close = ptr;
 
-      if (ch == '\'' || ch == '\"')
+      // 名称可能比输入缓冲区长，分段比较...
+      for (ptr += 2, i = 0; i < namelen; i += count, ptr += count)
       {
-        // 读取带引号的属性值...
-        quote = ch;
-	ptr   = value;
-
-        while ((ch = mxml_getc(options, io_cb, io_cbdata, encoding)) != EOF)
-        {
-	  if (ch == quote)
-	  {
-	    break;
-	  }
-	  else
-	  {
-	    if (ch == '&')
-	    {
-	      if ((ch = mxml_get_entity(options, io_cb, io_cbdata, encoding, node, line)) == EOF)
-	        goto error;
-	    }
-	    else if (ch == '\n')
-	    {
-	      (*line)++;
-	    }
+        if (ptr >= r->bufend && !mxml_skip_fill(r, &ptr, 1, line))
+          goto error;
 
-	    if (!mxml_add_char(options, ch, &ptr, &value, &valsize))
-	      goto error;
-	  }
-	}
+        if ((count = (size_t)(r->bufend - ptr)) > namelen - i)
+          count = namelen - i;
 
-        *ptr = '\0';
+        if (memcmp(ptr, name + i, count))
+        {
+          eof = false;
+          goto error;
+        }
       }
-      else
-      {
-        // 读取不带引号的属性值...
-	ptr      = value;
-	if (!mxml_add_char(options, ch, &ptr, &value, &valsize))
-	  goto error;
-
-	while ((ch = mxml_getc(options, io_cb, io_cbdata, encoding)) != EOF)
-	{
-	  if (mxml_isspace(ch) || ch == '=' || ch == '/' || ch == '>')
-	  {
-	    if (ch == '\n')
-	      (*line)++;
-
-            break;
-          }
-	  else
-	  {
-	    if (ch == '&')
-	    {
-	      if ((ch = mxml_get_entity(options, io_cb, io_cbdata, encoding, node, line)) == EOF)
-	        goto error;
-	    }
 
-	    if (!mxml_add_char(options, ch, &ptr, &value, &valsize))
-	      goto error;
-	  }
-	}
+      if (ptr >= r->bufend && !mxml_skip_fill(r, &ptr, 1, line))
+        goto error;
 
-        *ptr = '\0';
+      if (*ptr != '>' && !MXML_ISSPACE(*ptr))
+      {
+        eof = false;
+        goto error;
       }
 
-      // 使用给定的字符串值设置属性...
-      mxmlElementSetAttr(node, name, value);
-      MXML_DEBUG("mxml_parse_element: %s=\"%s\"\n", name, value);
+      term  = ">";
+      depth = 0;
     }
-    else
+    else if (ptr[1] == '/')
     {
-      _mxml_error(options, "在元素 %s 的属性 '%s' 中缺少值，位于第 %d 行。", name, mxmlGetElement(node), *line);
-      goto error;
+      depth --;
+      ptr += 2;
+      term = ">";
     }
-
-    // 检查结束字符...
-    if (ch == '/' || ch == '?')
+    else if ((r->bufend - ptr) >= 4 && !memcmp(ptr, "<!--", 4))
     {
-      // 获取 > 字符，如果不存在则打印错误...
-      quote = mxml_getc(options, io_cb, io_cbdata, encoding);
-
-      if (quote != '>')
-      {
-        _mxml_error(options, "在元素 %s 的 '%c' 后期望 '>'，但在第 %d 行得到 '%c'。", ch, mxmlGetElement(node), quote, *line);
-        ch = EOF;
-      }
-
-      break;
+      // 与mxml_load_data（）相同，注释在第一个前面不是"-"的"-->"处结束，"<!---->"不是完整的注释...
+      ptr += 4;
+      term = "-->";
     }
-    else if (ch == '>')
+    else if ((r->bufend - ptr) >= 9 && !memcmp(ptr, "<![CDATA[", 9))
+    {
+      ptr += 9;
+      term = "]]>";
+    }
+    else if (ptr[1] == '?')
+    {
+      // 处理指令的"?"也可以是结尾的"?"（"<?>"）...
+      ptr += 1;
+      term = "?>";
+    }
+    else if (ptr[1] == '!')
+    {
+      ptr += 2;
+      term = ">";
+    }
+    else if (depth == 1 && children)
+    {
+      // 子元素的开放标签...
+      close = ptr;
       break;
-  }
-
-  // 释放属性名和属性值缓冲区并返回...
-  free(name);
-  free(value);
-
-  return (ch);
-
-  // 错误返回点...
-  error:
+    }
+    else
+    {
+      // 嵌套的元素，元素名称中的引号是普通字符...
+      ptr ++;
+      intag = true;
+      prev  = '<';
+      continue;
+    }
 
-  free(name);
-  free(value);
+    // 跳到标记的结尾，读取更多的数据时之前的字节可能被丢弃，因此单独记录标记结尾之前的字节...
+    for (termlen = strlen(term), last = -1;;)
+    {
+      if ((next = memchr(ptr, term[0], (size_t)(r->bufend - ptr))) == NULL)
+      {
+        if (r->bufend > ptr)
+          last = r->bufend[-1];
 
-  return (EOF);
-}
+        ptr = r->bufend;
 
+        if (!mxml_skip_fill(r, &ptr, 1, line))
+          goto error;
 
+        continue;
+      }
 
-//
-// 'mxml_read_cb_fd()' - 从文件描述符读取字节。
-//
+      if (next > ptr)
+        last = next[-1];
 
-static size_t				// O - 读取的字节数
-mxml_read_cb_fd(int    *fd,		// I - 文件描述符
-                void   *buffer,		// I - 缓冲区
-                size_t bytes)		// I - 要读取的字节数
-{
-#if _WIN32
-  int		rbytes;			// 读取的字节数
+      ptr = next;
 
+      if ((size_t)(r->bufend - ptr) < termlen && !mxml_skip_fill(r, &ptr, termlen, line))
+        goto error;
 
-  rbytes = read(*fd, buffer, bytes);
+      if (!memcmp(ptr, term, termlen) && (term[0] != '-' || (last >= 0 && last != '-')))
+        break;
 
-#else
-  ssize_t	rbytes;			// 读取的字节数
+      last = *ptr++;
+    }
 
+    ptr += termlen;
 
-  while ((rbytes = read(*fd, buffer, bytes)) < 0)
-  {
-    if (errno != EINTR && errno != EAGAIN)
+    if (depth == 0)
       break;
   }
-#endif // _WIN32
 
-  if (rbytes < 0)
-    return (0);
-  else
-    return ((size_t)rbytes);
-}
+  // 跳过的行仍然计入行号...
+  mxml_skip_fill(r, &ptr, 0, line);
 
+  return (close ? close : r->bufptr);
 
-//
-// 'mxml_read_cb_file()' - 从文件指针读取字节。
-//
+  // 数据在闭合标签之前结束或闭合标签不匹配，使用错误位置的行号...
+  error:
 
-static size_t				// O - 读取的字节数
-mxml_read_cb_file(FILE   *fp,		// I - 文件指针
-                  void   *buffer,	// I - 缓冲区
-                  size_t bytes)		// I - 要读取的字节数
-{
-  if (feof(fp))
-    return (0);
+  mxml_skip_fill(r, &ptr, 0, line);
+
+  if (eof)
+    _mxml_error(options, "元素 <%s> 的内容在第 %d 行遇到早期的 EOF。", name, *line);
   else
-    return (fread(buffer, 1, bytes, fp));
+    _mxml_error(options, "元素 <%s> 的内容中有不匹配的闭合标签，在第 %d 行。", name, *line);
+
+  return (NULL);
 }
 
 
 //
-// 'mxml_read_cb_string()' - 从字符串读取字节。
+// 'mxml_skip_fill()' - 跳过内容时读取更多的数据。
+//
+// 计算跳过的行数并移动到`*ptr`，然后确保至少有`bytes`个字节，数据可能在缓冲区中移动。
 //
 
-static size_t				// O - 读取的字节数
-mxml_read_cb_string(
-    _mxml_stringbuf_t *sb,		// I - 字符串缓冲区
-    void              *buffer,		// I - 缓冲区
-    size_t            bytes)		// I - 要读取的字节数
+static bool				// O  - `true`表示有足够的数据，`false`表示数据结尾
+mxml_skip_fill(_mxml_read_t  *r,	// IO - 输入缓冲区
+               unsigned char **ptr,	// IO - 当前位置
+               size_t        bytes,	// I  - 需要的字节数
+               int           *line)	// IO - 当前行号
 {
-  size_t	remaining;		// 缓冲区中剩余的字节数
+  unsigned char	*start;			// 换行符
 
 
-  if ((remaining = sb->bufsize - (size_t)(sb->bufptr - sb->buffer)) < bytes)
-    bytes = remaining;
+  for (start = r->bufptr; (start = memchr(start, '\n', (size_t)(*ptr - start))) != NULL; start ++)
+    (*line) ++;
 
-  if (bytes > 0)
+  r->bufptr = *ptr;
+
+  if (mxml_read_fill(r, bytes) < bytes)
   {
-    // 从字符串中复制字节...
-    memcpy(buffer, sb->bufptr, bytes);
-    sb->bufptr += bytes;
+    *ptr = r->bufptr;
+    return (false);
   }
 
-  return (bytes);
+  *ptr = r->bufptr;
+
+  return (true);
 }
 
 
@@ -1818,49 +5434,193 @@ mxml_strtod(mxml_options_t *options,	// I - 选项
 
 
 //
-// 'mxml_io_cb_fd()' - 将字节写入文件描述符。
+// 'mxml_token_end()' - 以空字符结束令牌。
 //
 
-static size_t				// O - 写入的字节数
-mxml_io_cb_fd(int    *fd,		// I - 文件描述符
-                 void   *buffer,	// I - 缓冲区
-                 size_t bytes)		// I - 要写入的字节数
+static bool				// O  - `true`表示成功，`false`表示错误
+mxml_token_end(mxml_options_t *options,	// I  - 选项
+               _mxml_token_t  *tok)	// IO - 令牌
 {
-#if _WIN32
-  int		wbytes;			// 写入的字节数
+  // 原位解码时，空字符不能覆盖尚未读取的数据...
+  if (tok->r && tok->bufptr >= (char *)tok->r->bufptr && !mxml_token_spill(options, tok))
+    return (false);
 
+  *(tok->bufptr) = '\0';
 
-  wbytes = write(*fd, buffer, bytes);
+  return (true);
+}
 
-#else
-  ssize_t	wbytes;			// 写入的字节数
 
+//
+// 'mxml_token_free()' - 释放令牌缓冲区。
+//
 
-  while ((wbytes = write(*fd, buffer, bytes)) < 0)
+static void
+mxml_token_free(_mxml_token_t *tok)	// I - 令牌
+{
+  mxml_context_t *context = tok->context;
+					// 加载上下文
+
+
+  if (tok->heap && context && context->num_heaps < (sizeof(context->heaps) / sizeof(context->heaps[0])))
   {
-    if (errno != EINTR && errno != EAGAIN)
+    // 将缓冲区（可能已经扩展）还给加载上下文...
+    context->heaps[context->num_heaps]     = tok->heap;
+    context->heapsizes[context->num_heaps] = tok->bufsize;
+    context->num_heaps ++;
+  }
+  else
+  {
+    free(tok->heap);
+  }
+}
+
+
+//
+// 'mxml_token_grow()' - 将令牌的分配缓冲区扩展到至少指定的大小。
+//
+// 缓冲区的大小按照几何级数增长，因此较大的CDATA或文本令牌的总复制量与令牌的长度成正比。
+//
+
+static bool				// O  - `true`表示成功，`false`表示错误
+mxml_token_grow(mxml_options_t *options,// I  - 选项
+                _mxml_token_t  *tok,	// IO - 令牌
+                size_t         bytes)	// I  - 需要的大小
+{
+  char		*newheap;		// 新缓冲区
+  size_t	newsize = tok->bufsize;	// 新大小
+
+
+  while (newsize < bytes)
+  {
+    // 加倍缓冲区的大小...
+    if (newsize > (SIZE_MAX / 2))
+    {
+      newsize = bytes;
       break;
+    }
+
+    newsize *= 2;
   }
-#endif // _WIN32
 
-  if (wbytes < 0)
-    return (0);
+  if ((newheap = realloc(tok->heap, newsize)) == NULL)
+  {
+    _mxml_error(options, "无法将字符串缓冲区扩展到%lu字节。", (unsigned long)newsize);
+
+    return (false);
+  }
+
+  if (tok->buffer == tok->heap)
+  {
+    tok->bufptr = newheap + (tok->bufptr - tok->buffer);
+    tok->buffer = newheap;
+  }
+
+  tok->heap    = newheap;
+  tok->bufsize = newsize;
+
+  return (true);
+}
+
+
+//
+// 'mxml_token_init()' - 初始化令牌缓冲区。
+//
+
+static bool				// O - `true`表示成功，`false`表示错误
+mxml_token_init(mxml_options_t *options,// I - 选项
+                mxml_context_t *context,// I - 加载上下文或`NULL`
+                _mxml_token_t  *tok)	// I - 令牌
+{
+  tok->context = context;
+
+  if (context && context->num_heaps > 0)
+  {
+    // 重复使用加载上下文中之前的缓冲区...
+    context->num_heaps --;
+
+    tok->heap    = context->heaps[context->num_heaps];
+    tok->bufsize = context->heapsizes[context->num_heaps];
+  }
+  else if ((tok->heap = malloc(64)) == NULL)
+  {
+    _mxml_error(options, "无法分配字符串缓冲区。");
+    return (false);
+  }
   else
-    return ((size_t)wbytes);
+  {
+    tok->bufsize = 64;
+  }
+
+  tok->buffer = tok->heap;
+  tok->bufptr = tok->heap;
+  tok->r      = NULL;
+
+  return (true);
 }
 
 
+//
+// 'mxml_token_spill()' - 将原位解码的令牌移到分配的缓冲区中。
+//
+// 当解码后的数据（例如实体回调返回的字符）比原始数据长时使用，之后的字符都添加到分配的缓冲区中。
+//
+
+static bool				// O  - `true`表示成功，`false`表示错误
+mxml_token_spill(mxml_options_t *options,// I  - 选项
+                 _mxml_token_t  *tok)	// IO - 令牌
+{
+  size_t	bytes = (size_t)(tok->bufptr - tok->buffer);
+					// 令牌的长度
+
+
+  if ((bytes + 5) > tok->bufsize && !mxml_token_grow(options, tok, bytes + 5))
+    return (false);
+
+  memcpy(tok->heap, tok->buffer, bytes);
+
+  tok->buffer = tok->heap;
+  tok->bufptr = tok->heap + bytes;
+  tok->r      = NULL;
+
+  return (true);
+}
+
 
 //
-// 'mxml_io_cb_file()' - 将字节写入文件指针。
+// 'mxml_token_start()' - 开始一个新的令牌。
+//
+// 原位解析时，令牌从输入缓冲区中的当前字符开始（如果`ch`不是`EOF`，则包括刚读取的字符`ch`），
+// 否则使用分配的缓冲区。
 //
 
-static size_t				// O - 写入的字节数
-mxml_io_cb_file(FILE   *fp,		// I - 文件指针
-                   void   *buffer,	// I - 缓冲区
-                   size_t bytes)	// I - 要写入的字节数
+static void
+mxml_token_start(_mxml_token_t *tok,	// I - 令牌
+                 _mxml_read_t  *r,	// I - 输入缓冲区
+                 int           ch)	// I - 已读取的第一个字符或`EOF`
 {
-  return (fwrite(buffer, 1, bytes, fp));
+  if (r->insitu)
+  {
+    tok->buffer = (char *)r->bufptr;
+
+    if (ch >= 0x10000)
+      tok->buffer -= 4;
+    else if (ch >= 0x800)
+      tok->buffer -= 3;
+    else if (ch >= 0x80)
+      tok->buffer -= 2;
+    else if (ch >= 0)
+      tok->buffer --;
+
+    tok->r = r;
+  }
+  else
+  {
+    tok->buffer = tok->heap;
+    tok->r      = NULL;
+  }
+
+  tok->bufptr = tok->buffer;
 }
 
 
@@ -1877,14 +5637,18 @@ mxml_io_cb_string(
   size_t	remaining;		// 剩余字节数
 
 
-  // 根据需要扩展缓冲区...
-  if ((sb->bufptr + bytes) >= (sb->buffer + sb->bufsize - 1) && sb->bufalloc)
+  // 根据需要扩展缓冲区（只计算字节数时缓冲区为`NULL`）...
+  if (sb->bufalloc && ((size_t)(sb->bufptr - sb->buffer) + bytes + 1) > sb->bufsize)
   {
     // 重新分配缓冲区
     char	*temp;			// 新缓冲区指针
     size_t	newsize;		// 新的缓冲区大小
 
-    newsize = (size_t)(sb->bufptr - sb->buffer) + bytes + 257;
+    // 至少加倍缓冲区的大小，使多次写入的总复制量与输出的长度成正比...
+    newsize = (size_t)(sb->bufptr - sb->buffer) + bytes + 1;
+    if (newsize < (SIZE_MAX / 2) && newsize < 2 * sb->bufsize)
+      newsize = 2 * sb->bufsize;
+
     if ((temp = realloc(sb->buffer, newsize)) == NULL)
       return (0);
 
@@ -1894,28 +5658,182 @@ mxml_io_cb_string(
   }
 
   // 复制尽可能多的字节...
-  if (sb->bufptr >= (sb->buffer + sb->bufsize - 1))
-    return (0);			// 没有更多空间
-  else if ((remaining = (sb->bufsize - (size_t)(sb->bufptr - sb->buffer) - 1)) < bytes)
-    bytes = remaining;
+  remaining = sb->bufsize > 0 ? sb->bufsize - (size_t)(sb->bufptr - sb->buffer) - 1 : 0;
+
+  if (remaining < bytes)
+  {
+    if (sb->bufalloc)
+      return (0);			// 没有更多空间
+
+    // 固定大小的缓冲区截断输出，但是继续计算字节数（与`snprintf`相同）...
+    sb->overflow += bytes - remaining;
+  }
+  else
+  {
+    remaining = bytes;
+  }
 
-  memcpy(sb->bufptr, buffer, bytes);
-  sb->bufptr += bytes;
+  if (remaining > 0)
+  {
+    memcpy(sb->bufptr, buffer, remaining);
+    sb->bufptr += remaining;
+  }
 
   return (bytes);
 }
 
 
 //
-// 'mxml_write_node()' - 将 XML 节点保存到文件。
+// 'mxml_write_all()' - 通过输出缓冲区保存XML树。
 //
 
-static int				// O - 列或错误时为 -1
-mxml_write_node(
+static bool				// O - `true`表示成功，`false`表示错误
+mxml_write_all(
     mxml_node_t    *node,		// I - 要写入的节点
     mxml_options_t *options,		// I - 选项
     mxml_io_cb_t   io_cb,		// I - 写入回调函数
     void           *io_cbdata,		// I - 写入回调数据
+    bool           newline)		// I - 是否确保输出以换行符结束？
+{
+  _mxml_write_t	w;			// 输出缓冲区
+  int		col;			// 最终列
+  bool		ret;			// 返回值
+
+
+  if (!_mxml_write_init(&w, options, io_cb, io_cbdata))
+    return (false);
+
+#ifdef MXML_WRITEV
+  if (io_cb == (mxml_io_cb_t)_mxml_io_cb_fd)
+  {
+    // 节点在保存期间不会改变，写入文件描述符时引用节点中的字符串而不复制...
+    w.borrow = true;
+    w.fd     = *((int *)io_cbdata);
+  }
+#endif // MXML_WRITEV
+
+  // 写入节点...
+  col = mxml_write_node(node, node, options, &w, /*depth*/0, 0);
+
+  // 确保文件以换行符结束...
+  if (newline && col > 0)
+    col = _mxml_write_string("\n", &w, /*use_entities*/false, col);
+
+  // 写入缓冲的数据...
+  ret = col >= 0 && _mxml_write_flush(&w);
+
+  _mxml_write_free(&w);
+
+  return (ret);
+}
+
+
+//
+// 'mxml_write_data()' - 将字节添加到输出缓冲区。
+//
+// 缓冲区满时调用写入回调函数，不小于缓冲区的数据直接传递给写入回调函数而不复制。
+//
+
+static bool				// O - `true`表示成功，`false`表示错误
+mxml_write_data(_mxml_write_t *w,	// I - 输出缓冲区
+                const char    *s,	// I - 数据
+                size_t        bytes)	// I - 字节数
+{
+#ifdef MXML_WRITEV
+  if (w->borrow && bytes >= MXML_WRITEV_MIN)
+  {
+    // 引用较长的字符串，与之前缓冲的数据一起使用`writev`写入...
+    if (w->num_iov >= (MXML_WRITEV_MAX - 2) && !_mxml_write_flush(w))
+      return (false);
+
+    if (w->bufptr > w->bufstart)
+    {
+      w->iov[w->num_iov].iov_base = w->bufstart;
+      w->iov[w->num_iov].iov_len  = (size_t)(w->bufptr - w->bufstart);
+      w->num_iov ++;
+      w->bufstart = w->bufptr;
+    }
+
+    w->iov[w->num_iov].iov_base = (void *)s;
+    w->iov[w->num_iov].iov_len  = bytes;
+    w->num_iov ++;
+
+    return (true);
+  }
+#endif // MXML_WRITEV
+
+  if (bytes > (size_t)(w->bufend - w->bufptr))
+  {
+    // 缓冲区放不下，写入缓冲的数据...
+    if (!_mxml_write_flush(w))
+      return (false);
+
+    if (bytes >= (size_t)(w->bufend - w->buffer))
+    {
+      // 较大的数据直接写入...
+      size_t	wbytes;			// 写入的字节数
+
+      while (bytes > 0)
+      {
+        if ((wbytes = (w->io_cb)(w->io_cbdata, (void *)s, bytes)) == 0 || wbytes > bytes)
+          return (false);
+
+        s     += wbytes;
+        bytes -= wbytes;
+      }
+
+      return (true);
+    }
+  }
+
+  memcpy(w->bufptr, s, bytes);
+  w->bufptr += bytes;
+
+  return (true);
+}
+
+
+//
+// 'mxml_write_inline()' - 确定缩进时元素的内容是否保持在一行。
+//
+// 按照`MXML_INDENT_ELEMENTS`缩进时，包含文本、CDATA或其他数据的元素中的空白字符是内容的一部分，
+// 因此这些元素（包括其中所有的子元素）不换行缩进。
+//
+
+static bool				// O - `true`表示内容保持在一行
+mxml_write_inline(
+    mxml_node_t   *node,		// I - 元素
+    mxml_indent_t indent)		// I - 缩进方式
+{
+  mxml_node_t	*child;			// 子节点
+
+
+  if (indent != MXML_INDENT_ELEMENTS)
+    return (false);
+
+  for (child = node->child; child; child = child->next)
+  {
+    if (!mxml_is_markup(child))
+      return (true);
+  }
+
+  return (false);
+}
+
+
+//
+// 'mxml_write_node()' - 将 XML 节点保存到文件。
+//
+// 写入从`node`到`last`的同级节点及其子节点，`last`通常为`node`。
+//
+
+static int				// O - 列或错误时为 -1
+mxml_write_node(
+    mxml_node_t    *node,		// I - 要写入的第一个节点
+    mxml_node_t    *last,		// I - 要写入的最后一个同级节点
+    mxml_options_t *options,		// I - 选项
+    _mxml_write_t  *w,			// I - 输出缓冲区
+    int            depth,		// I - 缩进级别
     int            col)			// I - 当前列
 {
   mxml_node_t	*current,		// 当前节点
@@ -1927,6 +5845,9 @@ mxml_write_node(
 		*data;			// 自定义数据字符串
   const char	*text;			// 文本字符串
   bool		whitespace;		// 文本字符串之前的空白字符？
+  mxml_indent_t	indent = options ? options->indent : MXML_INDENT_NONE;
+					// 缩进方式
+  mxml_node_t	*inline_node = NULL;	// 内容保持在一行的元素
 
 
   // 循环遍历此节点及其所有子节点...
@@ -1935,44 +5856,57 @@ mxml_write_node(
     // 输出节点值...
     MXML_DEBUG("mxml_write_node: current=%p(%d)\n", current, current->type);
 
+    // 缩进时在元素、注释、声明和处理指令之前换行，按照`MXML_INDENT_ALL`缩进时也在连续的数据之前换行...
+    if (indent != MXML_INDENT_NONE && !inline_node && (mxml_is_markup(current) || (indent == MXML_INDENT_ALL && (current == node || !current->prev || mxml_is_markup(current->prev)))))
+      col = _mxml_write_indent(options, w, depth, col);
+
     switch (mxmlGetType(current))
     {
       case MXML_TYPE_CDATA :
-	  col = mxml_write_ws(current, options, io_cb, io_cbdata, MXML_WS_BEFORE_OPEN, col);
-	  col = mxml_write_string("<![CDATA[", io_cb, io_cbdata, /*use_entities*/false, col);
-	  col = mxml_write_string(mxmlGetCDATA(current), io_cb, io_cbdata, /*use_entities*/false, col);
-	  col = mxml_write_string("]]>", io_cb, io_cbdata, /*use_entities*/false, col);
-	  col = mxml_write_ws(current, options, io_cb, io_cbdata, MXML_WS_AFTER_OPEN, col);
+	  col = mxml_write_ws(current, options, w, MXML_WS_BEFORE_OPEN, col);
+	  col = _mxml_write_string("<![CDATA[", w, /*use_entities*/false, col);
+	  col = _mxml_write_string(mxmlGetCDATA(current), w, /*use_entities*/false, col);
+	  col = _mxml_write_string("]]>", w, /*use_entities*/false, col);
+	  col = mxml_write_ws(current, options, w, MXML_WS_AFTER_OPEN, col);
           break;
 
       case MXML_TYPE_COMMENT :
-	  col = mxml_write_ws(current, options, io_cb, io_cbdata, MXML_WS_BEFORE_OPEN, col);
-	  col = mxml_write_string("<!--", io_cb, io_cbdata, /*use_entities*/false, col);
-	  col = mxml_write_string(mxmlGetComment(current), io_cb, io_cbdata, /*use_entities*/false, col);
-	  col = mxml_write_string("-->", io_cb, io_cbdata, /*use_entities*/false, col);
-	  col = mxml_write_ws(current, options, io_cb, io_cbdata, MXML_WS_AFTER_OPEN, col);
+	  col = mxml_write_ws(current, options, w, MXML_WS_BEFORE_OPEN, col);
+	  col = _mxml_write_string("<!--", w, /*use_entities*/false, col);
+	  col = _mxml_write_string(mxmlGetComment(current), w, /*use_entities*/false, col);
+	  col = _mxml_write_string("-->", w, /*use_entities*/false, col);
+	  col = mxml_write_ws(current, options, w, MXML_WS_AFTER_OPEN, col);
           break;
 
       case MXML_TYPE_DECLARATION :
-	  col = mxml_write_ws(current, options, io_cb, io_cbdata, MXML_WS_BEFORE_OPEN, col);
-	  col = mxml_write_string("<!", io_cb, io_cbdata, /*use_entities*/false, col);
-	  col = mxml_write_string(mxmlGetDeclaration(current), io_cb, io_cbdata, /*use_entities*/false, col);
-	  col = mxml_write_string(">", io_cb, io_cbdata, /*use_entities*/false, col);
-	  col = mxml_write_ws(current, options, io_cb, io_cbdata, MXML_WS_AFTER_OPEN, col);
+	  col = mxml_write_ws(current, options, w, MXML_WS_BEFORE_OPEN, col);
+	  col = _mxml_write_string("<!", w, /*use_entities*/false, col);
+	  col = _mxml_write_string(mxmlGetDeclaration(current), w, /*use_entities*/false, col);
+	  col = _mxml_write_string(">", w, /*use_entities*/false, col);
+	  col = mxml_write_ws(current, options, w, MXML_WS_AFTER_OPEN, col);
           break;
 
       case MXML_TYPE_DIRECTIVE :
-	  col = mxml_write_ws(current, options, io_cb, io_cbdata, MXML_WS_BEFORE_OPEN, col);
-	  col = mxml_write_string("<?", io_cb, io_cbdata, /*use_entities*/false, col);
-	  col = mxml_write_string(mxmlGetDirective(current), io_cb, io_cbdata, /*use_entities*/false, col);
-	  col = mxml_write_string("?>", io_cb, io_cbdata, /*use_entities*/false, col);
-	  col = mxml_write_ws(current, options, io_cb, io_cbdata, MXML_WS_AFTER_OPEN, col);
+	  col = mxml_write_ws(current, options, w, MXML_WS_BEFORE_OPEN, col);
+	  col = _mxml_write_string("<?", w, /*use_entities*/false, col);
+	  col = _mxml_write_string(mxmlGetDirective(current), w, /*use_entities*/false, col);
+	  col = _mxml_write_string("?>", w, /*use_entities*/false, col);
+	  col = mxml_write_ws(current, options, w, MXML_WS_AFTER_OPEN, col);
           break;
 
       case MXML_TYPE_ELEMENT :
-	  col = mxml_write_ws(current, options, io_cb, io_cbdata, MXML_WS_BEFORE_OPEN, col);
-	  col = mxml_write_string("<", io_cb, io_cbdata, /*use_entities*/false, col);
-	  col = mxml_write_string(mxmlGetElement(current), io_cb, io_cbdata, /*use_entities*/true, col);
+	  // 写入之前加载延迟的内容，内容有错误时保存失败...
+	  MXML_EXPAND(current);
+
+	  if (current->value.element.lazy)
+	  {
+	    col = -1;
+	    break;
+	  }
+
+	  col = mxml_write_ws(current, options, w, MXML_WS_BEFORE_OPEN, col);
+	  col = _mxml_write_string("<", w, /*use_entities*/false, col);
+	  col = _mxml_write_string(mxmlGetElement(current), w, /*use_entities*/true, col);
 
 	  for (i = current->value.element.num_attrs, attr = current->value.element.attrs; i > 0 && col >= 0; i --, attr ++)
 	  {
@@ -1982,22 +5916,31 @@ mxml_write_node(
 	      width += strlen(attr->value) + 3;
 
 	    if (options && options->wrap > 0 && (col + (int)width) > options->wrap)
-	      col = mxml_write_string("\n", io_cb, io_cbdata, /*use_entities*/false, col);
+	      col = _mxml_write_string("\n", w, /*use_entities*/false, col);
 	    else
-	      col = mxml_write_string(" ", io_cb, io_cbdata, /*use_entities*/false, col);
+	      col = _mxml_write_string(" ", w, /*use_entities*/false, col);
 
-	    col = mxml_write_string(attr->name, io_cb, io_cbdata, /*use_entities*/true, col);
+	    col = _mxml_write_string(attr->name, w, /*use_entities*/true, col);
 
 	    if (attr->value)
 	    {
-	      col = mxml_write_string("=\"", io_cb, io_cbdata, /*use_entities*/false, col);
-	      col = mxml_write_string(attr->value, io_cb, io_cbdata, /*use_entities*/true, col);
-	      col = mxml_write_string("\"", io_cb, io_cbdata, /*use_entities*/false, col);
+	      col = _mxml_write_string("=\"", w, /*use_entities*/false, col);
+	      col = _mxml_write_string(attr->value, w, /*use_entities*/true, col);
+	      col = _mxml_write_string("\"", w, /*use_entities*/false, col);
 	    }
 	  }
 
-	  col = mxml_write_string(current->child ? ">" : "/>", io_cb, io_cbdata, /*use_entities*/false, col);
-	  col = mxml_write_ws(current, options, io_cb, io_cbdata, MXML_WS_AFTER_OPEN, col);
+	  col = _mxml_write_string(current->child ? ">" : "/>", w, /*use_entities*/false, col);
+	  col = mxml_write_ws(current, options, w, MXML_WS_AFTER_OPEN, col);
+
+	  if (current->child)
+	  {
+	    // 子节点缩进一级，包含数据的元素的内容保持在一行...
+	    depth ++;
+
+	    if (indent != MXML_INDENT_NONE && !inline_node && mxml_write_inline(current, indent))
+	      inline_node = current;
+	  }
 	  break;
 
       case MXML_TYPE_INTEGER :
@@ -2005,18 +5948,18 @@ mxml_write_node(
 	  {
 	    // 添加空格分隔符...
 	    if (options && options->wrap > 0 && col > options->wrap)
-	      col = mxml_write_string("\n", io_cb, io_cbdata, /*use_entities*/false, col);
+	      col = _mxml_write_string("\n", w, /*use_entities*/false, col);
 	    else
-	      col = mxml_write_string(" ", io_cb, io_cbdata, /*use_entities*/false, col);
+	      col = _mxml_write_string(" ", w, /*use_entities*/false, col);
 	  }
 
           // 写入整数...
 	  snprintf(s, sizeof(s), "%ld", current->value.integer);
-	  col = mxml_write_string(s, io_cb, io_cbdata, /*use_entities*/true, col);
+	  col = _mxml_write_string(s, w, /*use_entities*/true, col);
 	  break;
 
       case MXML_TYPE_OPAQUE :
-	  col = mxml_write_string(mxmlGetOpaque(current), io_cb, io_cbdata, /*use_entities*/true, col);
+	  col = _mxml_write_string(mxmlGetOpaque(current), w, /*use_entities*/true, col);
 	  break;
 
       case MXML_TYPE_REAL :
@@ -2024,9 +5967,9 @@ mxml_write_node(
 	  {
 	    // 添加空格分隔符...
 	    if (options && options->wrap > 0 && col > options->wrap)
-	      col = mxml_write_string("\n", io_cb, io_cbdata, /*use_entities*/false, col);
+	      col = _mxml_write_string("\n", w, /*use_entities*/false, col);
 	    else
-	      col = mxml_write_string(" ", io_cb, io_cbdata, /*use_entities*/false, col);
+	      col = _mxml_write_string(" ", w, /*use_entities*/false, col);
 	  }
 
           // 写入实数...
@@ -2046,7 +5989,7 @@ mxml_write_node(
 	    }
           }
 
-	  col = mxml_write_string(s, io_cb, io_cbdata, /*use_entities*/true, col);
+	  col = _mxml_write_string(s, w, /*use_entities*/true, col);
 	  break;
 
       case MXML_TYPE_TEXT :
@@ -2056,12 +5999,12 @@ mxml_write_node(
 	  {
 	    // 添加空格分隔符...
 	    if (options && options->wrap > 0 && col > options->wrap)
-	      col = mxml_write_string("\n", io_cb, io_cbdata, /*use_entities*/false, col);
+	      col = _mxml_write_string("\n", w, /*use_entities*/false, col);
 	    else
-	      col = mxml_write_string(" ", io_cb, io_cbdata, /*use_entities*/false, col);
+	      col = _mxml_write_string(" ", w, /*use_entities*/false, col);
 	  }
 
-	  col = mxml_write_string(text, io_cb, io_cbdata, /*use_entities*/true, col);
+	  col = _mxml_write_string(text, w, /*use_entities*/true, col);
 	  break;
 
       case MXML_TYPE_CUSTOM :
@@ -2071,7 +6014,17 @@ mxml_write_node(
 	  if ((data = (options->custsave_cb)(options->cust_cbdata, current)) == NULL)
 	    return (-1);
 
-	  col = mxml_write_string(data, io_cb, io_cbdata, /*use_entities*/true, col);
+#ifdef MXML_WRITEV
+	  if (w->borrow)
+	  {
+	    // 字符串写入之后被释放，不能引用...
+	    w->borrow = false;
+	    col       = _mxml_write_string(data, w, /*use_entities*/true, col);
+	    w->borrow = true;
+	  }
+	  else
+#endif // MXML_WRITEV
+	  col = _mxml_write_string(data, w, /*use_entities*/true, col);
 
 	  free(data);
 	  break;
@@ -2081,11 +6034,23 @@ mxml_write_node(
     }
 
     // 确定下一个节点...
-    if ((next = mxmlGetFirstChild(current)) == NULL)
+#ifdef HAVE_PTHREAD_H
+    if (w->save && current == w->save->parent && col >= 0)
+    {
+      // 按照顺序写入其他线程写入的子节点，然后从最后一个子节点继续...
+      col     = mxml_write_parts(w->save, w, col);
+      current = current->last_child;
+      next    = NULL;
+    }
+    else
+#endif // HAVE_PTHREAD_H
+    next = mxmlGetFirstChild(current);
+
+    if (!next)
     {
-      if (current == node)
+      if (current == last)
       {
-        // 如果我们在“根”节点上，不遍历到兄弟节点...
+        // 如果我们在最后一个“根”节点上，不遍历到兄弟节点...
         next = NULL;
       }
       else
@@ -2093,7 +6058,7 @@ mxml_write_node(
         // 尝试下一个兄弟节点，并根据需要继续向上遍历...
 	while ((next = mxmlGetNextSibling(current)) == NULL)
 	{
-	  if (current == node || !mxmlGetParent(current))
+	  if (current == last || !mxmlGetParent(current))
 	    break;
 
 	  // 声明和指令没有结束标记...
@@ -2101,14 +6066,21 @@ mxml_write_node(
 
 	  if (mxmlGetType(current) == MXML_TYPE_ELEMENT)
 	  {
-	    col = mxml_write_ws(current, options, io_cb, io_cbdata, MXML_WS_BEFORE_CLOSE, col);
-	    col = mxml_write_string("</", io_cb, io_cbdata, /*use_entities*/false, col);
-	    col = mxml_write_string(mxmlGetElement(current), io_cb, io_cbdata, /*use_entities*/true, col);
-	    col = mxml_write_string(">", io_cb, io_cbdata, /*use_entities*/false, col);
-	    col = mxml_write_ws(current, options, io_cb, io_cbdata, MXML_WS_AFTER_CLOSE, col);
+	    depth --;
+
+	    if (indent != MXML_INDENT_NONE && !inline_node)
+	      col = _mxml_write_indent(options, w, depth, col);
+	    else if (inline_node == current)
+	      inline_node = NULL;
+
+	    col = mxml_write_ws(current, options, w, MXML_WS_BEFORE_CLOSE, col);
+	    col = _mxml_write_string("</", w, /*use_entities*/false, col);
+	    col = _mxml_write_string(mxmlGetElement(current), w, /*use_entities*/true, col);
+	    col = _mxml_write_string(">", w, /*use_entities*/false, col);
+	    col = mxml_write_ws(current, options, w, MXML_WS_AFTER_CLOSE, col);
 	  }
 
-	  if (current == node)
+	  if (current == last)
 	    break;
 	}
       }
@@ -2119,79 +6091,123 @@ mxml_write_node(
 }
 
 
+#ifdef HAVE_PTHREAD_H
 //
-// 'mxml_write_string()' - 写入字符串，根据需要转义 & 和 <。
+// 'mxml_write_parts()' - 按照顺序输出并行保存的子节点。
+//
+// 等待下一段时调用者的线程也写入其他段。
 //
 
-static int				// O - 新的列数，错误时为 `-1`
-mxml_write_string(
-    const char      *s,			// I - 要写入的字符串
-    mxml_io_cb_t    io_cb,		// I - 写入回调函数
-    void            *io_cbdata,		// I - 写入回调数据
-    bool            use_entities,	// I - 是否转义特殊字符？
-    int             col)		// I - 当前列数
+static int				// O - 列或错误时为 -1
+mxml_write_parts(_mxml_save_t  *save,	// I - 并行保存的状态
+                 _mxml_write_t *w,	// I - 输出缓冲区
+                 int           col)	// I - 当前列
 {
-  const char	*frag,			// 当前字符串片段的起始位置
-		*ptr,			// 字符串指针
-		*ent;			// 实体，如果有的话
-  size_t	fraglen;		// 片段的长度
+  _mxml_save_part_t	*part;		// 下一段
 
 
-  MXML_DEBUG("mxml_write_string(io_cb=%p, io_cbdata=%p, s=\"%s\", use_entities=%s, col=%d)\n", io_cb, io_cbdata, s, use_entities ? "true" : "false", col);
+  pthread_mutex_lock(&save->mutex);
 
-  if (col < 0)
-    return (-1);
-
-  for (frag = ptr = s; *ptr; ptr ++)
+  while (col >= 0 && (save->next || save->written < save->assigned))
   {
-    if (use_entities && (ent = _mxml_entity_string(*ptr)) != NULL)
+    part = save->parts + save->written % save->window;
+
+    if (!part->done)
     {
-      size_t entlen = strlen(ent);	// 实体的长度
+      if (save->error && save->written >= save->assigned)
+        col = -1;
+      else if (!mxml_save_part(save))
+        pthread_cond_wait(&save->cond, &save->mutex);
+      continue;
+    }
 
-      if (ptr > frag)
-      {
-        // 写入当前片段
-        fraglen = (size_t)(ptr - frag);
+    pthread_mutex_unlock(&save->mutex);
 
-	if ((io_cb)(io_cbdata, (char *)frag, fraglen) != fraglen)
-	  return (-1);
-      }
+    if ((col = part->col) >= 0 && !mxml_write_data(w, part->sb.buffer, (size_t)(part->sb.bufptr - part->sb.buffer)))
+      col = -1;
 
-      frag = ptr + 1;
+    pthread_mutex_lock(&save->mutex);
 
-      // 写入实体
-      if ((io_cb)(io_cbdata, (char *)ent, entlen) != entlen)
-        return (-1);
+    part->done = false;
+    save->written ++;
 
-      col ++;
-    }
-    else if (*ptr == '\r' || *ptr == '\n')
-    {
-      // CR 或 LF 重置列数
-      col = 0;
-    }
-    else if (*ptr == '\t')
-    {
-      // Tab 缩进列数
-      col = col - (col % MXML_TAB) + MXML_TAB;
-    }
-    else
+    if (col < 0)
+      save->error = true;
+
+    pthread_cond_broadcast(&save->cond);
+  }
+
+  pthread_mutex_unlock(&save->mutex);
+
+  return (col);
+}
+#endif // HAVE_PTHREAD_H
+
+
+//
+// 'mxml_write_scan()' - 查找第一个需要转义或影响列数的字节。
+//
+// 返回从`s`开始不需要特殊处理的字节数：转义特殊字符时在"&"、"<"、">"和"\""处停止，跟踪列数时在
+// 控制字符（包括换行符和制表符）处停止。支持时使用SSE2一次比较16个字节。
+//
+
+static size_t				// O - 可以直接写入的字节数
+mxml_write_scan(const char *s,		// I - 开始位置
+                const char *end,	// I - 字符串的结尾
+                bool       use_entities,// I - 是否转义特殊字符？
+                bool       columns)	// I - 是否跟踪列数？
+{
+  const unsigned char	*ptr = (const unsigned char *)s,
+					// 当前位置
+			*uend = (const unsigned char *)end;
+					// 字符串的结尾
+#ifdef MXML_SCAN_SSE2
+  __m128i		data,		// 当前的16个字节
+			special;	// 需要特殊处理的字节
+  unsigned		mask;		// 需要特殊处理的字节的位掩码
+#  ifdef _MSC_VER
+  unsigned long		bit;		// 第一个需要特殊处理的字节
+#  endif // _MSC_VER
+#endif // MXML_SCAN_SSE2
+
+
+  if (!use_entities && !columns)
+    return ((size_t)(end - s));
+
+#ifdef MXML_SCAN_SSE2
+  for (; (uend - ptr) >= 16; ptr += 16)
+  {
+    // "<"（0x3c）和">"（0x3e）只有第1位不同，"\""（0x22）和"&"（0x26）只有第2位不同...
+    data    = _mm_loadu_si128((const __m128i *)ptr);
+    special = _mm_setzero_si128();
+
+    if (use_entities)
+      special = _mm_or_si128(_mm_cmpeq_epi8(_mm_and_si128(data, _mm_set1_epi8((char)0xfd)), _mm_set1_epi8(0x3c)), _mm_cmpeq_epi8(_mm_and_si128(data, _mm_set1_epi8((char)0xfb)), _mm_set1_epi8(0x22)));
+
+    if (columns)
+      special = _mm_or_si128(special, _mm_cmpeq_epi8(_mm_min_epu8(data, _mm_set1_epi8(0x1f)), data));
+
+    if ((mask = (unsigned)_mm_movemask_epi8(special)) != 0)
     {
-      // 所有其他字符占据 1 列
-      col ++;
+#  ifdef _MSC_VER
+      _BitScanForward(&bit, mask);
+      return ((size_t)(ptr - (const unsigned char *)s) + bit);
+#  else
+      return ((size_t)(ptr - (const unsigned char *)s) + (size_t)__builtin_ctz(mask));
+#  endif // _MSC_VER
     }
   }
+#endif // MXML_SCAN_SSE2
 
-  if (ptr > frag)
+  for (; ptr < uend; ptr ++)
   {
-    // 写入最后一个片段
-    fraglen = (size_t)(ptr - frag);
-
-    if ((io_cb)(io_cbdata, (char *)frag, fraglen) != fraglen)
-      return (-1);
+    if (use_entities && (*ptr == '&' || *ptr == '<' || *ptr == '>' || *ptr == '\"'))
+      break;
+    else if (columns && *ptr < ' ')
+      break;
   }
 
-  return (col);
+  return ((size_t)(ptr - (const unsigned char *)s));
 }
 
 
@@ -2203,16 +6219,26 @@ static int				// O - 新的列数，错误时为 `-1`
 mxml_write_ws(
     mxml_node_t    *node,		// I - 当前节点
     mxml_options_t *options,		// I - 选项
-    mxml_io_cb_t   io_cb,		// I - 写入回调函数
-    void           *io_cbdata,		// I - 写入回调数据
+    _mxml_write_t  *w,			// I - 输出缓冲区
     mxml_ws_t      ws,			// I - 空白字符值
     int            col)			// I - 当前列数
 {
   const char	*s;			// 空白字符字符串
 
 
-  if (options && options->ws_cb && (s = (options->ws_cb)(options->ws_cbdata, node, ws)) != NULL)
-    col = mxml_write_string(s, io_cb, io_cbdata, /*use_entities*/false, col);
+  if (options && options->ws_cb && options->indent == MXML_INDENT_NONE && (s = (options->ws_cb)(options->ws_cbdata, node, ws)) != NULL)
+  {
+#ifdef MXML_WRITEV
+    // 回调函数可能重复使用同一个缓冲区，不能引用返回的字符串...
+    bool borrow = w->borrow;		// 是否引用字符串？
+
+    w->borrow = false;
+    col       = _mxml_write_string(s, w, /*use_entities*/false, col);
+    w->borrow = borrow;
+#else
+    col = _mxml_write_string(s, w, /*use_entities*/false, col);
+#endif // MXML_WRITEV
+  }
 
   return (col);
 }
@@ -60,6 +60,9 @@ mxmlGetCustom(mxml_node_t *node)	// I - 要获取的节点
   if (!node)
     return (NULL);
 
+  // 加载元素延迟的内容...
+  MXML_EXPAND(node);
+
   // 返回自定义值...
   if (node->type == MXML_TYPE_CUSTOM)
     return (node->value.custom.data);
@@ -133,8 +136,14 @@ mxmlGetElement(mxml_node_t *node)	// I - 要获取的节点
 mxml_node_t *				// O - 第一个子节点或 `NULL`
 mxmlGetFirstChild(mxml_node_t *node)	// I - 要获取的节点
 {
-  // 返回第一个子节点...
-  return (node ? node->child : NULL);
+  // 范围检查输入...
+  if (!node)
+    return (NULL);
+
+  // 加载延迟的内容并返回第一个子节点...
+  MXML_EXPAND(node);
+
+  return (node->child);
 }
 
 
@@ -151,6 +160,9 @@ mxmlGetInteger(mxml_node_t *node)	// I - 要获取的节点
   if (!node)
     return (0);
 
+  // 加载元素延迟的内容...
+  MXML_EXPAND(node);
+
   // 返回整数值...
   if (node->type == MXML_TYPE_INTEGER)
     return (node->value.integer);
@@ -170,7 +182,14 @@ mxmlGetInteger(mxml_node_t *node)	// I - 要获取的节点
 mxml_node_t *				// O - 最后一个子节点或 `NULL`
 mxmlGetLastChild(mxml_node_t *node)	// I - 要获取的节点
 {
-  return (node ? node->last_child : NULL);
+  // 范围检查输入...
+  if (!node)
+    return (NULL);
+
+  // 加载延迟的内容并返回最后一个子节点...
+  MXML_EXPAND(node);
+
+  return (node->last_child);
 }
 
 
@@ -200,6 +219,9 @@ mxmlGetOpaque(mxml_node_t *node)	// I - 要获取的节点
   if (!node)
     return (NULL);
 
+  // 加载元素延迟的内容...
+  MXML_EXPAND(node);
+
   // 返回不透明值...
   if (node->type == MXML_TYPE_OPAQUE)
     return (node->value.opaque);
@@ -249,6 +271,9 @@ mxmlGetReal(mxml_node_t *node)		// I - 要获取的节点
   if (!node)
     return (0.0);
 
+  // 加载元素延迟的内容...
+  MXML_EXPAND(node);
+
   // 返回实数值...
   if (node->type == MXML_TYPE_REAL)
     return (node->value.real);
@@ -282,6 +307,9 @@ mxmlGetText(mxml_node_t *node,		// I - 要获取的节点
     return (NULL);
   }
 
+  // 加载元素延迟的内容...
+  MXML_EXPAND(node);
+
   // 返回整数值...
   if (node->type == MXML_TYPE_TEXT)
   {
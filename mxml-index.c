@@ -294,8 +294,8 @@ static int index_compare(mxml_index_t *ind, mxml_node_t *first, mxml_node_t *sec
     int diff;		// 差异
 
 
-    // 检查元素名称...
-    if ((diff = strcmp(first->value.element.name, second->value.element.name)) != 0)
+    // 检查元素名称，驻留的名称相同时指针相同...
+    if (first->value.element.name != second->value.element.name && (diff = strcmp(first->value.element.name, second->value.element.name)) != 0)
         return (diff);
 
     // 检查属性值...
@@ -41,6 +41,9 @@ void mxmlAdd(mxml_node_t *parent,		// I - 父节点
     if (node->parent)
         mxmlRemove(node);
 
+    // 在延迟的内容之后添加...
+    MXML_EXPAND(parent);
+
     // 重置指针...
     node->parent = parent;
 
@@ -193,7 +196,7 @@ mxml_node_t * mxmlNewCDATA(mxml_node_t *parent,	// I - 父节点或`MXML_NO_PARE
     // 创建节点并设置名称值...
     if ((node = mxml_new(parent, MXML_TYPE_CDATA)) != NULL)
     {
-        if ((node->value.cdata = _mxml_strcopy(data)) == NULL)
+        if ((node->value.cdata = _mxml_node_strcopy(node, data)) == NULL)
         {
             mxmlDelete(node);
             return (NULL);
@@ -233,7 +236,7 @@ mxml_node_t * mxmlNewCDATAf(mxml_node_t *parent,	// I - 父节点或`MXML_NO_PAR
         vsnprintf(buffer, sizeof(buffer), format, ap);
         va_end(ap);
 
-        node->value.cdata = _mxml_strcopy(buffer);
+        node->value.cdata = _mxml_node_strcopy(node, buffer);
     }
 
     return (node);
@@ -262,7 +265,7 @@ mxml_node_t * mxmlNewComment(mxml_node_t *parent,	// I - 父节点或`MXML_NO_PA
     // 创建节点并设置名称值...
     if ((node = mxml_new(parent, MXML_TYPE_COMMENT)) != NULL)
     {
-        if ((node->value.comment = _mxml_strcopy(comment)) == NULL)
+        if ((node->value.comment = _mxml_node_strcopy(node, comment)) == NULL)
         {
             mxmlDelete(node);
             return (NULL);
@@ -302,7 +305,7 @@ mxml_node_t * mxmlNewCommentf(mxml_node_t *parent,	// I - 父节点或`MXML_NO_P
         vsnprintf(buffer, sizeof(buffer), format, ap);
         va_end(ap);
 
-        node->value.comment = _mxml_strcopy(buffer);
+        node->value.comment = _mxml_node_strcopy(node, buffer);
     }
 
     return (node);
@@ -361,7 +364,7 @@ mxml_node_t * mxmlNewDeclaration(
     // 创建节点并设置名称值...
     if ((node = mxml_new(parent, MXML_TYPE_DECLARATION)) != NULL)
     {
-        if ((node->value.declaration = _mxml_strcopy(declaration)) == NULL)
+        if ((node->value.declaration = _mxml_node_strcopy(node, declaration)) == NULL)
         {
             mxmlDelete(node);
             return (NULL);
@@ -403,7 +406,7 @@ va_start(ap, format);
 vsnprintf(buffer, sizeof(buffer), format, ap);
 va_end(ap);
 
-node->value.declaration = _mxml_strcopy(buffer);
+node->value.declaration = _mxml_node_strcopy(node, buffer);
 
 }
 
@@ -433,7 +436,7 @@ return (NULL);
 // 创建节点并设置名称值...
 if ((node = mxml_new(parent, MXML_TYPE_DIRECTIVE)) != NULL)
 {
-if ((node->value.directive = _mxml_strcopy(directive)) == NULL)
+if ((node->value.directive = _mxml_node_strcopy(node, directive)) == NULL)
 {
 mxmlDelete(node);
 return (NULL);
@@ -473,7 +476,7 @@ va_start(ap, format);
 vsnprintf(buffer, sizeof(buffer), format, ap);
 va_end(ap);
 
-node->value.directive = _mxml_strcopy(buffer);
+node->value.directive = _mxml_node_strcopy(node, buffer);
 
 }
 
@@ -501,7 +504,7 @@ return (NULL);
 
 // 创建节点并设置元素名称...
 if ((node = mxml_new(parent, MXML_TYPE_ELEMENT)) != NULL)
-node->value.element.name = _mxml_strcopy(name);
+node->value.element.name = _mxml_node_namecopy(node, name);
 
 return (node);
 }
@@ -550,7 +553,7 @@ return (NULL);
 
 // 创建节点并设置元素名称...
 if ((node = mxml_new(parent, MXML_TYPE_OPAQUE)) != NULL)
-node->value.opaque = _mxml_strcopy(opaque);
+node->value.opaque = _mxml_node_strcopy(node, opaque);
 
 return (node);
 }
@@ -585,7 +588,7 @@ va_start(ap, format);
 vsnprintf(buffer, sizeof(buffer), format, ap);
 va_end(ap);
 
-node->value.opaque = _mxml_strcopy(buffer);
+node->value.opaque = _mxml_node_strcopy(node, buffer);
 
 }
 
@@ -640,7 +643,7 @@ return (NULL);
 if ((node = mxml_new(parent, MXML_TYPE_TEXT)) != NULL)
 {
 node->value.text.whitespace = whitespace;
-node->value.text.string = _mxml_strcopy(string);
+node->value.text.string = _mxml_node_strcopy(node, string);
 }
 
 return (node);
@@ -679,7 +682,7 @@ vsnprintf(buffer, sizeof(buffer), format, ap);
 va_end(ap);
 
 node->value.text.whitespace = whitespace;
-node->value.text.string     = _mxml_strcopy(buffer);
+node->value.text.string     = _mxml_node_strcopy(node, buffer);
 
 }
 
@@ -786,47 +789,60 @@ static void
 mxml_free(mxml_node_t *node)		// 输入参数 - 节点
 {
   size_t	i;			// 循环变量
+  _mxml_doc_t	*doc = node->doc;	// 文档
+
+
+  // 内存池中的节点、字符串和属性数组在释放文档时一起释放...
+  if (doc && doc->arena)
+  {
+    if (node->type == MXML_TYPE_CUSTOM && node->value.custom.data && node->value.custom.free_cb)
+      (node->value.custom.free_cb)(node->value.custom.free_cbdata, node->value.custom.data);
 
+    _mxml_doc_release(doc);
+    return;
+  }
 
   switch (node->type)
   {
     case MXML_TYPE_CDATA :
-	_mxml_strfree(node->value.cdata);
+	_mxml_node_strfree(node, node->value.cdata);
         break;
     case MXML_TYPE_COMMENT :
-	_mxml_strfree(node->value.comment);
+	_mxml_node_strfree(node, node->value.comment);
         break;
     case MXML_TYPE_DECLARATION :
-	_mxml_strfree(node->value.declaration);
+	_mxml_node_strfree(node, node->value.declaration);
         break;
     case MXML_TYPE_DIRECTIVE :
-	_mxml_strfree(node->value.directive);
+	_mxml_node_strfree(node, node->value.directive);
         break;
     case MXML_TYPE_ELEMENT :
-	_mxml_strfree(node->value.element.name);
+	_mxml_node_namefree(node, node->value.element.name);
 
 	if (node->value.element.num_attrs)
 	{
 	  for (i = 0; i < node->value.element.num_attrs; i ++)
 	  {
-	    _mxml_strfree(node->value.element.attrs[i].name);
-	    _mxml_strfree(node->value.element.attrs[i].value);
+	    _mxml_node_namefree(node, node->value.element.attrs[i].name);
+	    _mxml_node_strfree(node, node->value.element.attrs[i].value);
 	  }
 
           free(node->value.element.attrs);
 	}
+
+        free(node->value.element.lazy);
         break;
     case MXML_TYPE_INTEGER :
        // 无需处理
         break;
     case MXML_TYPE_OPAQUE :
-	_mxml_strfree(node->value.opaque);
+	_mxml_node_strfree(node, node->value.opaque);
         break;
     case MXML_TYPE_REAL :
        // 无需处理
         break;
     case MXML_TYPE_TEXT :
-	_mxml_strfree(node->value.text.string);
+	_mxml_node_strfree(node, node->value.text.string);
         break;
     case MXML_TYPE_CUSTOM :
         if (node->value.custom.data && node->value.custom.free_cb)
@@ -837,6 +853,8 @@ mxml_free(mxml_node_t *node)		// 输入参数 - 节点
   }
 
   // 释放该节点...
+  _mxml_doc_release(doc);
+
   free(node);
 }
 
@@ -850,12 +868,29 @@ mxml_new(mxml_node_t *parent,		// 输入参数 - 父节点
          mxml_type_t type)		// 输入参数 - 节点类型
 {
   mxml_node_t	*node;			// 新节点
+  _mxml_doc_t	*doc;			// 所属文档
+  _mxml_global_t *global = _mxml_global();
+					// 全局数据
 
 
   MXML_DEBUG("mxml_new(parent=%p, type=%d)\n", parent, type);
 
+  // 节点属于正在加载的文档或父节点的文档，只有加载器创建临时节点...
+  if ((doc = global->doc) == NULL && parent && (doc = parent->doc) != NULL && doc->transient)
+    doc = doc->keep;
+
   // 为节点分配内存...
-  if ((node = calloc(1, sizeof(mxml_node_t))) == NULL)
+  if (doc && doc->arena)
+  {
+    if ((node = _mxml_doc_alloc(doc, sizeof(mxml_node_t))) != NULL)
+      memset(node, 0, sizeof(mxml_node_t));
+  }
+  else
+  {
+    node = calloc(1, sizeof(mxml_node_t));
+  }
+
+  if (!node)
   {
     MXML_DEBUG("mxml_new: 返回 NULL\n");
     return (NULL);
@@ -867,6 +902,9 @@ mxml_new(mxml_node_t *parent,		// 输入参数 - 父节点
   node->type      = type;
   node->ref_count = 1;
 
+  if ((node->doc = doc) != NULL)
+    doc->ref_count ++;
+
   // 如果存在父节点，则添加到父节点中...
   if (parent)
     mxmlAdd(parent, MXML_ADD_AFTER, /*child*/NULL, node);
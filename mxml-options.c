@@ -12,6 +12,125 @@
 #include "mxml-private.h"
 
 
+//
+// 'mxmlOptionsAddProjection（）' - 添加加载时保留的元素路径。
+//
+// 此函数添加一个投影路径。路径使用与@link mxmlFindPath@相同的语法，即以"/"分隔的元素名称，
+// 从根元素（或加载到的顶级节点的子元素）开始，"*/"前缀表示下一个元素可以在任意深度，例如：
+//
+// ```c
+// mxmlOptionsAddProjection(options, "catalog/item/price");
+// mxmlOptionsAddProjection(options, "catalog/*/note");
+// ```
+//
+// 添加了投影路径时，加载函数只加载与某个路径完全匹配的元素（包括其中的所有内容），以及这些
+// 路径上的祖先元素（包括属性）。其他的元素、祖先元素中的文本、注释、CDATA等内容在词法层面跳过，
+// 不创建节点、不驻留名称也不解码实体，只检查标记的嵌套。"*/"之前的元素之下的所有元素都可能是
+// 祖先元素，因此即使没有匹配的子元素也会加载（没有内容）。根元素不匹配任何路径时不加载任何元素。
+//
+// 投影路径不适用于@link mxmlParserNew@推送解析器、@link mxmlReaderNew@拉取式读取器和
+// 之后加载的延迟内容，@link mxmlLoadFilenameParallel@在使用投影路径时只使用一个线程加载。
+//
+
+bool					// 输出 - 成功时为`true`，路径无效或内存不足时为`false`
+mxmlOptionsAddProjection(
+    mxml_options_t *options,		// 输入 - 选项
+    const char     *path)		// 输入 - 元素的路径
+{
+  _mxml_path_t	*p,			// 投影路径
+		**temp;			// 新的投影路径数组
+  size_t	num_steps,		// 元素数量
+		pathlen;		// 路径的长度
+  const char	*ptr;			// 路径中的当前位置
+  char		*name;			// 复制的元素名称
+  _mxml_step_t	*step;			// 当前元素
+
+
+  // 输入范围检查...
+  if (!options || !path || !*path)
+    return (false);
+
+  // 检查路径并计算元素数量，每个"*/"之后必须有元素名称...
+  for (ptr = path, num_steps = 0; *ptr;)
+  {
+    if (!strncmp(ptr, "*/", 2))
+      ptr += 2;
+
+    if (!*ptr || *ptr == '/')
+      return (false);
+
+    num_steps ++;
+
+    if ((ptr = strchr(ptr, '/')) == NULL)
+      break;
+
+    if (!*++ptr)
+      return (false);
+  }
+
+  // 元素和名称保存在同一块内存中...
+  pathlen = strlen(path) + 1;
+
+  if ((temp = realloc(options->paths, (options->num_paths + 1) * sizeof(_mxml_path_t *))) == NULL)
+    return (false);
+
+  options->paths = temp;
+
+  if ((p = malloc(sizeof(_mxml_path_t) + num_steps * sizeof(_mxml_step_t) + pathlen)) == NULL)
+    return (false);
+
+  p->num_steps = num_steps;
+  name         = (char *)(p->steps + num_steps);
+
+  memcpy(name, path, pathlen);
+
+  for (step = p->steps; *name; step ++)
+  {
+    step->descend = !strncmp(name, "*/", 2);
+
+    if (step->descend)
+      name += 2;
+
+    step->name = name;
+
+    if ((name = strchr(name, '/')) == NULL)
+      break;
+
+    *name++ = '\0';
+  }
+
+  options->paths[options->num_paths ++] = p;
+
+  return (true);
+}
+
+
+//
+// 'mxmlOptionsClearProjection（）' - 删除所有的投影路径。
+//
+// 此函数删除@link mxmlOptionsAddProjection@添加的所有路径，之后的加载加载所有元素。
+//
+
+void
+mxmlOptionsClearProjection(
+    mxml_options_t *options)		// 输入 - 选项
+{
+  size_t	i;			// 循环变量
+
+
+  if (!options)
+    return;
+
+  for (i = 0; i < options->num_paths; i ++)
+    free(options->paths[i]);
+
+  free(options->paths);
+
+  options->num_paths = 0;
+  options->paths     = NULL;
+}
+
+
 //
 // 'mxmlOptionsDelete（）' - 释放加载/保存选项。
 //
@@ -20,6 +139,7 @@ void
 mxmlOptionsDelete(
     mxml_options_t *options)		// 输入 - 选项
 {
+  mxmlOptionsClearProjection(options);
   free(options);
 }
 
@@ -58,6 +178,7 @@ mxmlOptionsNew(void)
     // 设置默认值...
     options->type_value = MXML_TYPE_TEXT;
     options->wrap       = 72;
+    options->bufsize    = MXML_BUFSIZE;
 
     if ((options->loc = localeconv()) != NULL)
     {
@@ -72,6 +193,56 @@ mxmlOptionsNew(void)
 }
 
 
+//
+// 'mxmlOptionsSetArena（）' - 设置是否使用文档内存池。
+//
+// 此函数设置加载函数是否从文档内存池中分配节点、属性数组和字符串。当`arena`为`true`时，
+// 每次加载创建一个文档，所有内存从大块中连续分配，并在删除文档的最后一个节点时一次性释放。
+// 之后添加到这些节点中的子节点以及设置的新值也从同一个内存池中分配。
+//
+// 注意：内存池中的内存在删除整个文档之前不会被回收，因此频繁修改的节点树不应使用内存池。
+// 使用内存池时，@link mxmlSetStringCallbacks@设置的字符串回调函数不用于文档中的字符串。
+//
+
+void
+mxmlOptionsSetArena(
+    mxml_options_t *options,		// 输入 - 选项
+    bool           arena)		// 输入 - `true`表示使用内存池，`false`表示单独分配
+{
+  if (options)
+    options->arena = arena;
+}
+
+
+//
+// 'mxmlOptionsSetBufferSize（）' - 设置读取和写入XML数据时使用的缓冲区大小。
+//
+// 此函数设置@mxmlLoadFd@、@mxmlLoadFile@、@mxmlLoadFilename@和@mxmlLoadIO@
+// 函数每次从输入源读取的最大字节数，以及@mxmlSaveFd@、@mxmlSaveFile@、@mxmlSaveFilename@和
+// @mxmlSaveIO@函数在写入之前收集输出的缓冲区大小。当`bytes`为`0`时，使用默认的64k字节。
+//
+// 注意：读取是按块进行的，因此加载在数据结尾之前停止时（出错或者SAX回调函数停止加载），可能已经
+// 预读了之后的数据。对于可定位的文件，未使用的数据会被退回；对于管道、套接字和读取回调函数，请使用
+// @link mxmlOptionsSetReadSize@限制预读的数据。
+//
+
+void
+mxmlOptionsSetBufferSize(
+    mxml_options_t *options,		// 输入 - 选项
+    size_t         bytes)		// 输入 - 缓冲区大小（字节），`0`表示默认值
+{
+  if (options)
+  {
+    if (bytes == 0)
+      options->bufsize = MXML_BUFSIZE;
+    else if (bytes < 16)
+      options->bufsize = 16;
+    else
+      options->bufsize = bytes;
+  }
+}
+
+
 //
 // 'mxmlOptionsSetCustomCallbacks（）' - 设置自定义数据回调。
 //
@@ -243,6 +414,106 @@ mxmlOptionsSetErrorCallback(
 }
 
 
+//
+// 'mxmlOptionsSetIndent（）' - 设置保存XML数据时的缩进方式。
+//
+// 此函数设置保存函数是否自动换行并缩进元素，不需要空白回调函数。`indent`为`MXML_INDENT_ELEMENTS`
+// 时，只包含元素（以及注释、声明和处理指令）的元素的每个子节点都写入新的一行，包含文本、CDATA或
+// 其他数据的元素与之前相同保持在一行，因此重新加载时文本不变。`indent`为`MXML_INDENT_ALL`时，所有
+// 元素的子节点都写入新的一行，连续的文本节点写入同一行。
+//
+// 每一级缩进`width`个空格，`width`为`0`时每一级缩进一个制表符。缩进时不调用
+// @link mxmlOptionsSetWhitespaceCallback@设置的空白回调函数。
+//
+
+void
+mxmlOptionsSetIndent(
+    mxml_options_t *options,		// 输入 - 选项
+    mxml_indent_t  indent,		// 输入 - 缩进方式
+    int            width)		// 输入 - 每一级缩进的空格数，`0`表示制表符
+{
+  if (options)
+  {
+    options->indent       = indent;
+    options->indent_width = width > 0 ? width : 0;
+  }
+}
+
+
+//
+// 'mxmlOptionsSetInternNames（）' - 设置是否驻留元素和属性名称。
+//
+// 此函数设置加载函数是否驻留元素和属性名称。当`intern`为`true`时，相同的名称只存储一次，
+// 节点使用@link mxmlGetAtom@返回的原子，并且可以使用@link mxmlFindElementAtom@和
+// @link mxmlElementGetAttrAtom@函数通过比较指针来查找元素和属性。之后添加到这些节点中的
+// 子节点以及设置的新名称也会被驻留。
+//
+// 注意：原子由所有线程共享，并且在程序退出或调用@link mxmlResetAtoms@之前不会被释放。原子表
+// 最多包含`MXML_ATOM_MAX`个原子，之后的新名称单独复制，因此不可信的XML数据最多使用固定数量的原子，
+// 但是这些文档中的查找会变慢。
+//
+
+void
+mxmlOptionsSetInternNames(
+    mxml_options_t *options,		// 输入 - 选项
+    bool           intern)		// 输入 - `true`表示驻留名称，`false`表示单独复制
+{
+  if (options)
+    options->intern = intern;
+}
+
+
+//
+// 'mxmlOptionsSetLazyDepth（）' - 设置延迟加载内容的元素深度。
+//
+// 此函数设置加载函数延迟加载哪一层元素的内容。根元素的深度为1，`depth`为1时只加载根元素及其
+// 属性，为2时加载根元素的子元素及其属性，依此类推。这些元素的内容在加载时只被跳过，并记录它在
+// 数据中的位置，在第一次通过@link mxmlGetFirstChild@、@link mxmlWalkNext@、@link mxmlFindElement@、
+// @link mxmlFindPath@等函数访问元素的子节点、向元素添加节点或保存元素时才加载，其中更深的元素
+// 的内容再次延迟。`depth`为0（默认）时加载所有内容。
+//
+// 延迟的内容使用加载时的选项（的副本）加载，因此回调函数的数据必须在删除节点树之前保持有效。
+// 加载时只检查跳过的内容中标记的嵌套，因此加载函数可能对@link mxmlLoadString@拒绝的数据返回成功。
+// 内容中的其他错误在加载内容时报告，出错的元素没有子节点，保存节点树也会失败；使用
+// @link mxmlElementExpand@可以加载并检查延迟的内容。从映射到内存中的文件加载时，节点树保留
+// 文件的映射，从字符串加载时保留字符串的副本，原位解析的缓冲区必须在删除节点树之前保持有效。
+// 从流或回调函数读取的数据、UTF-16数据以及使用SAX回调函数的加载总是加载所有内容。
+//
+// 注意：访问节点会修改节点树，因此多个线程同时访问同一个节点树时需要加锁。
+//
+
+void
+mxmlOptionsSetLazyDepth(
+    mxml_options_t *options,		// 输入 - 选项
+    int            depth)		// 输入 - 元素深度，0表示加载所有内容
+{
+  if (options)
+    options->lazy_depth = depth;
+}
+
+
+//
+// 'mxmlOptionsSetReadSize（）' - 设置每次读取的最大字节数。
+//
+// 此函数设置@mxmlLoadFd@、@mxmlLoadFile@、@mxmlLoadIO@、@mxmlLoadRecords@和@mxmlReaderNewIO@等函数
+// 每次调用读取回调函数时请求的最大字节数，不改变缓冲区的大小。当`bytes`为`0`（默认值）时，每次读取
+// 填满缓冲区（@link mxmlOptionsSetBufferSize@）。
+//
+// 加载在数据结尾之前停止时（出错或者SAX回调函数停止加载），无法定位的输入（管道、套接字和读取回调函数）
+// 中已经预读的数据会丢失。`bytes`为`1`时每次只读取一个字节，加载停止后输入的位置紧接在加载读取的
+// 最后一个字符之后，可以继续从同一个输入读取剩余的数据，但是读取回调函数的调用次数与数据的大小成正比。
+//
+
+void
+mxmlOptionsSetReadSize(
+    mxml_options_t *options,		// 输入 - 选项
+    size_t         bytes)		// 输入 - 最大字节数，`0`表示填满缓冲区
+{
+  if (options)
+    options->readsize = bytes;
+}
+
+
 //
 // 'mxmlOptionsSetSAXCallback（）' - 设置在读取XML数据时使用的SAX回调。
 //
@@ -289,6 +560,43 @@ mxmlOptionsSetSAXCallback(
 }
 
 
+//
+// 'mxmlOptionsSetSAXTransient（）' - 设置SAX回调函数是否只接收临时节点。
+//
+// 当`transient`为`true`时，传递给SAX回调函数的节点及其字符串从加载使用的临时内存池中分配，只在
+// 回调期间有效，释放时不调用`malloc`和`free`。回调函数使用[mxmlRetain](@@)函数保留的节点在回调
+// 返回后复制到节点树中，因此回调函数不应保存节点指针，而应在加载完成后从节点树中查找保留的节点。
+// 元素在打开元素事件中保留时立即复制，之后的子节点添加到复制的元素中。
+//
+
+void
+mxmlOptionsSetSAXTransient(
+    mxml_options_t *options,		// 输入 - 选项
+    bool           transient)		// 输入 - `true`表示临时节点，`false`表示普通节点
+{
+  if (options)
+    options->sax_transient = transient;
+}
+
+
+//
+// 'mxmlOptionsSetTextRuns（）' - 设置文本节点是否包含整段字符数据。
+//
+// 默认情况下，`MXML_TYPE_TEXT`值在每个空白字符处拆分，每个单词创建一个文本节点。当`text_runs`为
+// `true`时，每段连续的字符数据（包括其中的空白字符和元素之间仅包含空白字符的数据）加载为一个
+// 文本节点，节点的空白标志为`false`，字符串中保留原样的空白字符，因此保存时输出原始的字符数据。
+//
+
+void
+mxmlOptionsSetTextRuns(
+    mxml_options_t *options,		// 输入 - 选项
+    bool           text_runs)		// 输入 - `true`表示整段字符数据，`false`表示每个单词
+{
+  if (options)
+    options->text_runs = text_runs;
+}
+
+
 //
 // 'mxmlOptionsSetTypeCallback（）' - 设置用于子节点/值节点的类型回调。
 //
@@ -8,6 +8,9 @@
 //
 
 #include "mxml-private.h"
+#ifdef HAVE_SYS_MMAN_H
+#  include <sys/mman.h>
+#endif // HAVE_SYS_MMAN_H
 
 
 //
@@ -80,6 +83,165 @@
 #endif // __sun
 
 
+//
+// 原子表的锁...
+//
+
+#ifdef HAVE_PTHREAD_H
+#  include <pthread.h>
+static pthread_mutex_t	_mxml_atom_mutex = PTHREAD_MUTEX_INITIALIZER;
+#  define MXML_ATOM_LOCK()	pthread_mutex_lock(&_mxml_atom_mutex)
+#  define MXML_ATOM_UNLOCK()	pthread_mutex_unlock(&_mxml_atom_mutex)
+#elif defined(_WIN32)
+#  include <windows.h>
+static SRWLOCK		_mxml_atom_lock = SRWLOCK_INIT;
+#  define MXML_ATOM_LOCK()	AcquireSRWLockExclusive(&_mxml_atom_lock)
+#  define MXML_ATOM_UNLOCK()	ReleaseSRWLockExclusive(&_mxml_atom_lock)
+#else
+#  define MXML_ATOM_LOCK()
+#  define MXML_ATOM_UNLOCK()
+#endif // HAVE_PTHREAD_H
+
+
+//
+// 本地全局变量...
+//
+
+static size_t		_mxml_num_atoms = 0,
+					// 原子数量
+			_mxml_alloc_atoms = 0;
+					// 原子表的大小（2的幂）
+static const char	**_mxml_atoms = NULL;
+					// 原子的哈希表
+static _mxml_doc_t	_mxml_atom_pool;
+					// 原子字符串的内存池
+
+
+//
+// 本地函数...
+//
+
+static const char *mxml_atom_find(const char *name, size_t hash);
+static size_t	mxml_atom_hash(const char *s);
+static void	*mxml_doc_alloc(_mxml_doc_t *doc, size_t bytes, size_t align);
+
+
+//
+// 'mxmlGetAtom()' - 获取名称的原子。
+//
+// 此函数返回名称`name`的原子，即由所有线程共享的名称的唯一副本：相同的名称总是返回相同的
+// 指针，因此可以通过比较指针代替`strcmp`。使用@link mxmlOptionsSetInternNames@加载的节点的
+// 元素和属性名称是原子，可以使用@link mxmlFindElementAtom@和@link mxmlElementGetAttrAtom@
+// 函数查找。
+//
+// 原子在程序退出或调用@link mxmlResetAtoms@之前不会被释放。原子表最多包含`MXML_ATOM_MAX`（默认65536）
+// 个原子，表已满时新的名称返回`NULL`，驻留名称的加载函数将这些名称单独复制，因此包含任意名称的数据
+// 不会无限地增加原子使用的内存。
+//
+
+const char *				// 输出 - 原子或`NULL`（如果内存不足）
+mxmlGetAtom(const char *name)		// 输入 - 名称
+{
+  size_t	hash,			// 名称的哈希值
+		i, j,			// 循环变量
+		bytes;			// 名称的字节数
+  const char	**atoms,		// 新的哈希表
+		*atom = NULL;		// 原子
+
+
+  if (!name)
+    return (NULL);
+
+  hash = mxml_atom_hash(name);
+
+  MXML_ATOM_LOCK();
+
+  // 查找现有的原子，原子表已满时不添加新的原子...
+  if ((atom = mxml_atom_find(name, hash)) != NULL || _mxml_num_atoms >= MXML_ATOM_MAX)
+    goto done;
+
+  // 根据需要扩大哈希表，保持一半以上的空位...
+  if (2 * (_mxml_num_atoms + 1) > _mxml_alloc_atoms)
+  {
+    size_t	alloc_atoms = _mxml_alloc_atoms ? 2 * _mxml_alloc_atoms : 256;
+					// 新的哈希表大小
+
+    if ((atoms = (const char **)calloc(alloc_atoms, sizeof(const char *))) == NULL)
+      goto done;
+
+    for (i = 0; i < _mxml_alloc_atoms; i ++)
+    {
+      if (!_mxml_atoms[i])
+        continue;
+
+      for (j = mxml_atom_hash(_mxml_atoms[i]) & (alloc_atoms - 1); atoms[j]; j = (j + 1) & (alloc_atoms - 1));
+
+      atoms[j] = _mxml_atoms[i];
+    }
+
+    free(_mxml_atoms);
+
+    _mxml_atoms       = atoms;
+    _mxml_alloc_atoms = alloc_atoms;
+  }
+
+  // 添加新的原子...
+  bytes = strlen(name) + 1;
+
+  if ((atom = (const char *)mxml_doc_alloc(&_mxml_atom_pool, bytes, 1)) != NULL)
+  {
+    memcpy((char *)atom, name, bytes);
+
+    for (i = hash & (_mxml_alloc_atoms - 1); _mxml_atoms[i]; i = (i + 1) & (_mxml_alloc_atoms - 1));
+
+    _mxml_atoms[i] = atom;
+    _mxml_num_atoms ++;
+  }
+
+  done:
+
+  MXML_ATOM_UNLOCK();
+
+  return (atom);
+}
+
+
+//
+// 'mxmlResetAtoms()' - 释放所有原子。
+//
+// 此函数释放原子表和所有原子的字符串，之后@link mxmlGetAtom@返回新的原子。调用此函数时不能存在使用
+// @link mxmlOptionsSetInternNames@加载的节点，也不能再使用之前返回的原子，并且其他线程不能同时
+// 加载驻留名称的数据。长时间运行的程序可以在处理完一批驻留名称的文档之后调用此函数。
+//
+
+void
+mxmlResetAtoms(void)
+{
+  _mxml_chunk_t	*chunk,			// 当前块
+		*next;			// 下一个块
+
+
+  MXML_ATOM_LOCK();
+
+  for (chunk = _mxml_atom_pool.chunks; chunk; chunk = next)
+  {
+    next = chunk->next;
+    free(chunk);
+  }
+
+  free(_mxml_atom_pool.spare);
+  memset(&_mxml_atom_pool, 0, sizeof(_mxml_atom_pool));
+
+  free(_mxml_atoms);
+
+  _mxml_atoms       = NULL;
+  _mxml_num_atoms   = 0;
+  _mxml_alloc_atoms = 0;
+
+  MXML_ATOM_UNLOCK();
+}
+
+
 // 'mxmlSetStringCallbacks()' - 设置字符串复制/释放的回调函数。
 //
 // 此函数为当前线程设置字符串复制/释放的回调函数。`strcopy_cb`函数用于复制提供的字符串，而`strfree_cb`函数用于释放复制的字符串。
@@ -115,6 +277,246 @@ mxmlSetStringCallbacks(
 }
 
 
+//
+// '_mxml_doc_alloc()' - 从文档的内存池中分配内存。
+//
+// 内存按照指针和`double`中较大的对齐方式对齐，在释放文档时一起释放。
+//
+
+void *					// 输出 - 内存或`NULL`
+_mxml_doc_alloc(_mxml_doc_t *doc,	// 输入 - 文档
+                size_t      bytes)	// 输入 - 字节数
+{
+  return (mxml_doc_alloc(doc, bytes, sizeof(void *) > sizeof(double) ? sizeof(void *) : sizeof(double)));
+}
+
+
+//
+// '_mxml_doc_new()' - 创建新的文档。
+//
+
+_mxml_doc_t *				// 输出 - 新文档或`NULL`
+_mxml_doc_new(bool arena)		// 输入 - 是否使用内存池
+{
+  _mxml_doc_t	*doc;			// 新文档
+
+
+  if ((doc = (_mxml_doc_t *)calloc(1, sizeof(_mxml_doc_t))) != NULL)
+  {
+    doc->ref_count = 1;
+    doc->arena     = arena;
+  }
+
+  return (doc);
+}
+
+
+//
+// '_mxml_doc_pop()' - 将内存池中从指定位置开始分配的内存返回内存池。
+//
+// 只用于临时文档，其中的节点按照后进先出的顺序释放。之后分配的块被释放，保留一个标准大小的块以便
+// 重复使用。SAX回调函数分配的内存（`doc->pin`之下）不会返回内存池。`mark`为`NULL`时清空没有节点的
+// 文档的整个内存池。
+//
+
+void
+_mxml_doc_pop(_mxml_doc_t *doc,		// 输入 - 临时文档
+              void        *mark)	// 输入 - 要释放的第一个分配的内存
+{
+  _mxml_chunk_t	*chunk;			// 当前块
+
+
+  while ((chunk = doc->chunks) != NULL)
+  {
+    if (doc->pin >= (char *)chunk && doc->pin <= chunk->ptr)
+    {
+      if ((char *)mark < doc->pin || (char *)mark > chunk->ptr)
+        mark = doc->pin;
+      break;
+    }
+
+    if ((char *)mark >= (char *)chunk && (char *)mark <= chunk->ptr)
+      break;
+
+    doc->chunks = chunk->next;
+
+    if (!doc->spare && chunk->end == ((char *)chunk + MXML_ARENA_CHUNK))
+    {
+      chunk->next = NULL;
+      doc->spare  = chunk;
+    }
+    else
+    {
+      free(chunk);
+    }
+  }
+
+  if (chunk)
+    chunk->ptr = (char *)mark;
+}
+
+
+//
+// '_mxml_doc_release()' - 释放对文档的引用。
+//
+// 引用计数为0时一次性释放内存池中的所有块、临时文档对保留的节点所属的文档的引用，以及延迟的内容
+// 所在的数据。
+//
+
+void
+_mxml_doc_release(_mxml_doc_t *doc)	// 输入 - 文档
+{
+  _mxml_chunk_t	*chunk,			// 当前块
+		*next;			// 下一个块
+
+
+  if (doc && (-- doc->ref_count) == 0)
+  {
+    for (chunk = doc->chunks; chunk; chunk = next)
+    {
+      next = chunk->next;
+      free(chunk);
+    }
+
+    free(doc->spare);
+    _mxml_doc_release(doc->keep);
+
+#ifdef HAVE_SYS_MMAN_H
+    if (doc->sourcemap)
+      munmap((void *)doc->source, doc->sourcelen);
+#endif // HAVE_SYS_MMAN_H
+    if (doc->sourcealloc)
+      free((void *)doc->source);
+
+    free(doc->lazy);
+    free(doc);
+  }
+}
+
+
+//
+// '_mxml_node_namecopy()' - 复制节点的元素或属性名称。
+//
+// 驻留名称的文档中的节点使用名称的原子。原子表已满时单独复制名称，并且标记文档，以后比较名称时使用
+// `strcmp`。
+//
+
+char *					// 输出 - 节点使用的名称
+_mxml_node_namecopy(mxml_node_t *node,	// 输入 - 节点
+                    const char  *s)	// 输入 - 名称
+{
+  char		*atom;			// 名称的原子
+
+
+  if (node->doc && node->doc->intern)
+  {
+    if ((atom = (char *)mxmlGetAtom(s)) != NULL)
+      return (atom);
+
+    node->doc->unatomized = true;
+  }
+
+  return (_mxml_node_strcopy(node, s));
+}
+
+
+//
+// '_mxml_node_nameeq()' - 比较节点的元素或属性名称和原子。
+//
+// 驻留名称的文档中的节点只比较指针。
+//
+
+bool					// 输出 - `true`表示相同
+_mxml_node_nameeq(mxml_node_t *node,	// 输入 - 节点
+                  const char  *s,	// 输入 - 节点的名称
+                  const char  *atom)	// 输入 - 原子
+{
+  if (s == atom)
+    return (true);
+  else if (node->doc && node->doc->intern && !node->doc->unatomized)
+    return (false);
+  else
+    return (!strcmp(s, atom));
+}
+
+
+//
+// '_mxml_node_namefree()' - 释放节点的元素或属性名称。
+//
+
+void
+_mxml_node_namefree(mxml_node_t *node,	// 输入 - 节点
+                    char        *s)	// 输入 - 名称
+{
+  const char	*atom;			// 名称的原子
+
+
+  if (!node->doc || !node->doc->intern)
+  {
+    _mxml_node_strfree(node, s);
+  }
+  else if (node->doc->unatomized)
+  {
+    // 只释放没有驻留的名称...
+    MXML_ATOM_LOCK();
+    atom = mxml_atom_find(s, mxml_atom_hash(s));
+    MXML_ATOM_UNLOCK();
+
+    if (atom != s)
+      _mxml_node_strfree(node, s);
+  }
+}
+
+
+//
+// '_mxml_node_strcopy()' - 复制节点的字符串。
+//
+// 原位解析的缓冲区中的字符串直接由节点使用，不进行复制。使用内存池的文档从内存池中复制字符串。
+//
+
+char *					// 输出 - 节点使用的字符串
+_mxml_node_strcopy(mxml_node_t *node,	// 输入 - 节点
+                   const char  *s)	// 输入 - 字符串
+{
+  _mxml_doc_t	*doc = node->doc;	// 文档
+  size_t	bytes;			// 字符串的字节数
+  char		*copy;			// 字符串的副本
+
+
+  if (!doc)
+    return (_mxml_strcopy(s));
+  else if (!s || (s >= doc->insitu_start && s < doc->insitu_end))
+    return ((char *)s);
+  else if (!doc->arena)
+    return (_mxml_strcopy(s));
+
+  bytes = strlen(s) + 1;
+
+  if ((copy = (char *)mxml_doc_alloc(doc, bytes, 1)) != NULL)
+    memcpy(copy, s, bytes);
+
+  return (copy);
+}
+
+
+//
+// '_mxml_node_strfree()' - 释放节点的字符串。
+//
+// 内存池中的字符串在释放文档时一起释放。
+//
+
+void
+_mxml_node_strfree(mxml_node_t *node,	// 输入 - 节点
+                   char        *s)	// 输入 - 字符串
+{
+  _mxml_doc_t	*doc = node->doc;	// 文档
+
+
+  if (!doc || (!doc->arena && (s < doc->insitu_start || s >= doc->insitu_end)))
+    _mxml_strfree(s);
+}
+
+
 //
 // '_mxml_strcopy()' - 复制字符串。
 //
@@ -155,6 +557,119 @@ _mxml_strfree(char *s)			// 输入 - 字符串
 }
 
 
+//
+// 'mxml_atom_find()' - 查找现有的原子。
+//
+// 调用者必须持有原子表的锁。
+//
+
+static const char *			// 输出 - 原子或`NULL`
+mxml_atom_find(const char *name,	// 输入 - 名称
+               size_t     hash)		// 输入 - 名称的哈希值
+{
+  size_t	i;			// 循环变量
+
+
+  if (!_mxml_alloc_atoms)
+    return (NULL);
+
+  for (i = hash & (_mxml_alloc_atoms - 1); _mxml_atoms[i]; i = (i + 1) & (_mxml_alloc_atoms - 1))
+  {
+    if (!strcmp(_mxml_atoms[i], name))
+      return (_mxml_atoms[i]);
+  }
+
+  return (NULL);
+}
+
+
+//
+// 'mxml_atom_hash()' - 计算名称的FNV-1a哈希值。
+//
+
+static size_t				// 输出 - 哈希值
+mxml_atom_hash(const char *s)		// 输入 - 名称
+{
+  size_t	hash = 2166136261U;	// 哈希值
+
+
+  while (*s)
+    hash = (hash ^ (unsigned char)*s++) * 16777619U;
+
+  return (hash);
+}
+
+
+//
+// 'mxml_doc_alloc()' - 从内存池中分配内存。
+//
+// 较大的请求使用单独的块，插入到当前块之后，以免浪费当前块的剩余空间。临时文档按照后进先出的顺序
+// 释放内存，因此所有新块都插入到最前面。
+//
+
+static void *				// 输出 - 内存或`NULL`
+mxml_doc_alloc(_mxml_doc_t *doc,	// 输入 - 文档
+               size_t      bytes,	// 输入 - 字节数
+               size_t      align)	// 输入 - 对齐方式（2的幂）
+{
+  _mxml_chunk_t	*chunk;			// 当前块
+  size_t	offset;			// 块中的偏移量
+  char		*ptr;			// 分配的内存
+
+
+  // 块的开头由malloc对齐，因此只需要对齐块中的偏移量...
+  if ((chunk = doc->chunks) != NULL)
+  {
+    offset = (size_t)(chunk->ptr - (char *)chunk);
+    offset = (offset + align - 1) & ~(align - 1);
+
+    if (offset <= (size_t)(chunk->end - (char *)chunk) && bytes <= (size_t)(chunk->end - (char *)chunk) - offset)
+    {
+      ptr        = (char *)chunk + offset;
+      chunk->ptr = ptr + bytes;
+
+      return (ptr);
+    }
+  }
+
+  // 分配新块...
+  offset = (sizeof(_mxml_chunk_t) + align - 1) & ~(align - 1);
+
+  if (bytes > MXML_ARENA_CHUNK / 4)
+  {
+    if (bytes > (size_t)-1 - offset || (chunk = (_mxml_chunk_t *)malloc(offset + bytes)) == NULL)
+      return (NULL);
+
+    chunk->ptr = chunk->end = (char *)chunk + offset + bytes;
+
+    if (doc->chunks && !doc->transient)
+    {
+      chunk->next       = doc->chunks->next;
+      doc->chunks->next = chunk;
+    }
+    else
+    {
+      chunk->next = NULL;
+      doc->chunks = chunk;
+    }
+  }
+  else
+  {
+    if ((chunk = doc->spare) != NULL)
+      doc->spare = NULL;
+    else if ((chunk = (_mxml_chunk_t *)malloc(MXML_ARENA_CHUNK)) == NULL)
+      return (NULL);
+
+    chunk->ptr  = (char *)chunk + offset + bytes;
+    chunk->end  = (char *)chunk + MXML_ARENA_CHUNK;
+    chunk->next = doc->chunks;
+    doc->chunks = chunk;
+  }
+
+  return ((char *)chunk + offset);
+}
+
+
 #ifdef HAVE_PTHREAD_H			// POSIX 线程
 #  include <pthread.h>
 
@@ -305,6 +820,7 @@ _mxml_global(void)
     NULL,				// strcopy_cb
     NULL,				// strfree_cb
     NULL,				// str_cbdata
+    NULL				// doc
   };
 
 
@@ -14,6 +14,10 @@
 #  include "config.h"
 #  include "mxml.h"
 #  include <locale.h>
+#  ifndef _WIN32
+#    include <sys/uio.h>
+#    define MXML_WRITEV		1	// 使用`writev`写入文件描述符
+#  endif // !_WIN32
 
 
 以下是给定代码的汉化版本：
@@ -28,6 +32,18 @@
 #    define MXML_DEBUG(...)
 #  endif // DEBUG
 #  define MXML_TAB		8	// 每N列的制表符
+#  define MXML_BUFSIZE		65536	// 默认的I/O缓冲区大小
+#  define MXML_ARENA_CHUNK	65536	// 文档内存池的块大小
+#  ifndef MXML_ATOM_MAX
+#    define MXML_ATOM_MAX	65536	// 原子表中的最大原子数
+#  endif // !MXML_ATOM_MAX
+#  define MXML_WRITEV_MAX	64	// 每次`writev`写入的最大数据段数
+#  define MXML_BAD_CHAR(ch)	((ch) < ' ' && (ch) != '\n' && (ch) != '\r' && (ch) != '\t')
+					// 不能出现在XML数据中的控制字符
+#  define MXML_ISSPACE(ch)	((ch) == ' ' || (ch) == '\t' || (ch) == '\r' || (ch) == '\n')
+					// XML空白字符
+#  define MXML_EXPAND(node)	((node) && (node)->type == MXML_TYPE_ELEMENT && (node)->value.element.lazy ? _mxml_node_expand(node) : (void)0)
+					// 加载元素延迟的内容
 
 
 //
@@ -40,11 +56,32 @@ typedef struct _mxml_attr_s		// XML元素属性值
   char			*value;		// 属性值
 } _mxml_attr_t;
 
+typedef struct _mxml_lazy_s		// 延迟加载的元素内容
+{
+  size_t		start,		// 内容在数据中的开头
+			end;		// 内容在数据中的结尾（包括闭合标签的"</"）
+  int			line;		// 内容开头的行号
+  bool			error;		// 加载内容时是否遇到错误？
+} _mxml_lazy_t;
+
+typedef struct _mxml_step_s		// 投影路径中的一个元素
+{
+  const char		*name;		// 元素名称
+  bool			descend;	// 是否可以在上一个元素之下的任意深度（"*/"）？
+} _mxml_step_t;
+
+typedef struct _mxml_path_s		// 投影路径
+{
+  size_t		num_steps;	// 元素数量
+  _mxml_step_t		steps[];	// 元素，名称保存在同一块内存中
+} _mxml_path_t;
+
 typedef struct _mxml_element_s		// XML元素值
 {
   char			*name;		// 元素名称
   size_t		num_attrs;	// 属性数量
   _mxml_attr_t		*attrs;		// 属性
+  _mxml_lazy_t		*lazy;		// 尚未加载的内容或NULL
 } _mxml_element_t;
 
 typedef struct _mxml_text_s		// XML文本值
@@ -74,6 +111,33 @@ _mxml_text_t text; // 文本片段
 _mxml_custom_t custom; // 自定义数据
 } _mxml_value_t;
 
+typedef struct _mxml_chunk_s // 文档内存池的块
+{
+struct _mxml_chunk_s *next; // 下一个块
+char *ptr; // 下一个可用字节
+char *end; // 块的结尾
+} _mxml_chunk_t;
+
+typedef struct _mxml_doc_s // XML文档（同一次加载的节点共享的数据）
+{
+size_t ref_count; // 引用该文档的节点数量
+const char *insitu_start; // 原位解析的缓冲区的开头
+const char *insitu_end; // 原位解析的缓冲区的结尾
+bool arena; // 节点和字符串是否从内存池中分配？
+bool intern; // 元素和属性名称是否驻留？
+bool unatomized; // 是否有名称因为原子表已满而没有驻留（只能使用strcmp比较）？
+bool transient; // 节点是否只在SAX回调期间有效（按照后进先出的顺序释放）？
+struct _mxml_doc_s *keep; // 临时SAX模式中保留的节点所属的文档或NULL
+_mxml_chunk_t *chunks; // 内存池的块，当前块在最前面
+_mxml_chunk_t *spare; // 释放后保留以便重复使用的块或NULL
+char *pin; // 不能返回内存池的最高位置（SAX回调函数分配的内存）或NULL
+mxml_options_t *lazy; // 加载延迟的内容时使用的选项或NULL
+const char *source; // 延迟的内容所在的数据或NULL
+size_t sourcelen; // 数据的长度
+bool sourcealloc; // 数据是否是分配的副本？
+bool sourcemap; // 数据是否为内存映射的文件？
+} _mxml_doc_t;
+
 struct _mxml_node_s // XML节点
 {
 mxml_type_t type; // 节点类型
@@ -85,6 +149,7 @@ struct _mxml_node_s *last_child; // 最后一个子节点
 _mxml_value_t value; // 节点值
 size_t ref_count; // 使用计数
 void *user_data; // 用户数据
+_mxml_doc_t *doc; // 所属文档或NULL
 };
 
 typedef struct _mxml_global_s // 全局的、每个线程的数据
@@ -92,6 +157,7 @@ typedef struct _mxml_global_s // 全局的、每个线程的数据
 mxml_strcopy_cb_t strcopy_cb; // 字符串拷贝回调函数
 mxml_strfree_cb_t strfree_cb; // 字符串释放回调函数
 void *str_cbdata; // 字符串回调数据
+_mxml_doc_t *doc; // 当前正在加载的文档
 } _mxml_global_t;
 
 struct _mxml_index_s // XML节点索引
@@ -120,10 +186,73 @@ mxml_type_cb_t type_cb; // 类型回调函数
 void *type_cbdata; // 类型回调数据
 mxml_type_t type_value; // 固定类型值（如果没有类型回调）
 int wrap; // 换行边距
+mxml_indent_t indent; // 保存时的缩进方式
+int indent_width; // 每一级缩进的空格数，0表示制表符
+size_t bufsize; // I/O缓冲区大小
+size_t readsize; // 每次调用读取回调函数时请求的最大字节数，0表示填满缓冲区
+bool arena; // 是否使用文档内存池？
+bool intern; // 是否驻留元素和属性名称？
+bool text_runs; // 文本节点是否包含整段字符数据？
+bool sax_transient; // SAX回调函数是否只接收临时节点？
+int lazy_depth; // 延迟加载内容的元素深度，0表示不延迟
+size_t num_paths; // 投影路径的数量，0表示加载所有元素
+_mxml_path_t **paths; // 投影路径
 mxml_ws_cb_t ws_cb; // 空白字符回调函数
 void *ws_cbdata; // 空白字符回调数据
 };
 
+typedef enum _mxml_encoding_e        // 字符编码
+{
+  _MXML_ENCODING_UTF8,            // UTF-8
+  _MXML_ENCODING_UTF16BE,        // UTF-16大端
+  _MXML_ENCODING_UTF16LE        // UTF-16小端
+} _mxml_encoding_t;
+
+typedef struct _mxml_write_s		// 输出缓冲区
+{
+  mxml_io_cb_t		io_cb;		// 写入回调函数
+  void			*io_cbdata;	// 写入回调数据
+  char			*buffer,	// 缓冲区
+			*bufptr,	// 缓冲区中的当前位置
+			*bufend;	// 缓冲区的结尾
+  bool			bufalloc;	// 是否分配了缓冲区？
+  bool			columns;	// 是否跟踪列数（换行边距大于0）？
+  struct _mxml_save_s	*save;		// 并行保存的状态或`NULL`
+#  ifdef MXML_WRITEV
+  bool			borrow;		// 是否引用（而不复制）节点中较长的字符串？
+  int			fd;		// 使用`writev`写入的文件描述符
+  char			*bufstart;	// 还没有添加到`iov`的缓冲数据的开头
+  int			num_iov;	// 等待写入的数据段数
+  struct iovec		iov[MXML_WRITEV_MAX];
+					// 等待写入的数据段（缓冲的数据和引用的字符串）
+#  endif // MXML_WRITEV
+  char			local[4096];	// 保存到字符串时使用的本地缓冲区
+} _mxml_write_t;
+
+typedef struct _mxml_read_s		// 输入缓冲区
+{
+  mxml_io_cb_t		io_cb;		// 读取回调函数，`NULL`表示内存中的数据
+  void			*io_cbdata;	// 读取回调数据
+  _mxml_encoding_t	encoding;	// 原始数据的字符编码，UTF-16数据在读取时转换为UTF-8
+  unsigned char		*buffer,	// 缓冲区（UTF-8）
+			*bufptr,	// 缓冲区中的当前位置
+			*bufend;	// 缓冲区中数据的结尾
+  size_t		bufsize,	// 缓冲区大小
+			readsize;	// 每次读取的最大字节数，0表示填满缓冲区
+  bool			bufalloc,	// 是否分配了缓冲区？
+			bufmap,		// 缓冲区是否为内存映射的文件？
+			insitu;		// 是否在输入缓冲区中原位解码令牌？
+  unsigned char		*raw,		// 尚未转换的UTF-16数据的缓冲区或`NULL`
+			*rawptr,	// UTF-16数据中的当前位置
+			*rawend;	// UTF-16数据的结尾
+  size_t		rawsize;	// UTF-16数据的缓冲区大小
+  bool			rawalloc,	// 是否分配了UTF-16数据的缓冲区？
+			rawmap;		// UTF-16数据的缓冲区是否为内存映射的文件？
+  int			line;		// 数据开头的行号
+  bool			lazy;		// 是否是元素延迟的内容（以闭合标签的"</"结尾）？
+  mxml_context_t	*context;	// 提供令牌缓冲区的加载上下文或`NULL`
+} _mxml_read_t;
+
 
 //
 // Private functions...
@@ -136,6 +265,38 @@ void *ws_cbdata; // 空白字符回调数据
  */
 extern _mxml_global_t *_mxml_global(void);
 
+/**
+ * @brief 从文档的内存池中分配内存
+ *
+ * @param doc 文档
+ * @param bytes 字节数
+ * @return 返回对齐的内存，失败时返回NULL
+ */
+extern void *_mxml_doc_alloc(_mxml_doc_t *doc, size_t bytes);
+
+/**
+ * @brief 创建新的文档
+ *
+ * @param arena 是否使用内存池分配节点和字符串
+ * @return 返回引用计数为1的文档，失败时返回NULL
+ */
+extern _mxml_doc_t *_mxml_doc_new(bool arena);
+
+/**
+ * @brief 将内存池中从指定位置开始分配的内存返回内存池
+ *
+ * @param doc 临时文档
+ * @param mark 要释放的第一个分配的内存
+ */
+extern void _mxml_doc_pop(_mxml_doc_t *doc, void *mark);
+
+/**
+ * @brief 释放对文档的引用，引用计数为0时释放文档
+ *
+ * @param doc 文档
+ */
+extern void _mxml_doc_release(_mxml_doc_t *doc);
+
 /**
  * @brief 获取实体字符的字符串表示
  *
@@ -162,6 +323,127 @@ extern int _mxml_entity_value(mxml_options_t *options, const char *name);
  */
 extern void _mxml_error(mxml_options_t *options, const char *format, ...) MXML_FORMAT(2, 3);
 
+/**
+ * @brief 读取"&"之后的实体并获取对应的字符
+ *
+ * @param options mxml_options_t 结构体指针
+ * @param r 输入缓冲区
+ * @param parent 父节点或NULL
+ * @param line 当前行号
+ * @return 返回字符值，错误时返回EOF
+ */
+extern int _mxml_get_entity(mxml_options_t *options, _mxml_read_t *r, mxml_node_t *parent, int *line);
+
+/**
+ * @brief 从输入缓冲区中读取一个字符
+ *
+ * @param options mxml_options_t 结构体指针
+ * @param r 输入缓冲区
+ * @return 返回字符，数据结尾或错误时返回EOF
+ */
+extern int _mxml_getc(mxml_options_t *options, _mxml_read_t *r);
+
+/**
+ * @brief 将字节写入文件描述符
+ *
+ * @param fd 文件描述符
+ * @param buffer 缓冲区
+ * @param bytes 要写入的字节数
+ * @return 返回写入的字节数
+ */
+extern size_t _mxml_io_cb_fd(int *fd, void *buffer, size_t bytes);
+
+/**
+ * @brief 将字节写入文件指针
+ *
+ * @param fp 文件指针
+ * @param buffer 缓冲区
+ * @param bytes 要写入的字节数
+ * @return 返回写入的字节数
+ */
+extern size_t _mxml_io_cb_file(FILE *fp, void *buffer, size_t bytes);
+
+/**
+ * @brief 加载元素延迟的内容，出错时元素没有子节点
+ *
+ * @param node 元素
+ */
+extern void _mxml_node_expand(mxml_node_t *node);
+
+/**
+ * @brief 复制节点的元素或属性名称，驻留名称的文档使用名称的原子
+ *
+ * @param node 节点
+ * @param s 名称
+ * @return 返回节点使用的名称
+ */
+extern char *_mxml_node_namecopy(mxml_node_t *node, const char *s);
+
+/**
+ * @brief 释放节点的元素或属性名称，原子不会被释放
+ *
+ * @param node 节点
+ * @param s 名称
+ */
+extern void _mxml_node_namefree(mxml_node_t *node, char *s);
+
+/**
+ * @brief 比较节点的元素或属性名称和原子
+ *
+ * @param node 节点
+ * @param s 节点的名称
+ * @param atom 通过mxmlGetAtom获取的原子
+ * @return 相同时返回true
+ */
+extern bool _mxml_node_nameeq(mxml_node_t *node, const char *s, const char *atom);
+
+/**
+ * @brief 复制节点的字符串，原位解析的字符串直接使用而不复制
+ *
+ * @param node 节点
+ * @param s 要复制的字符串
+ * @return 返回节点使用的字符串
+ */
+extern char *_mxml_node_strcopy(mxml_node_t *node, const char *s);
+
+/**
+ * @brief 释放节点的字符串
+ *
+ * @param node 节点
+ * @param s 要释放的字符串
+ */
+extern void _mxml_node_strfree(mxml_node_t *node, char *s);
+
+/**
+ * @brief 将字符编码为UTF-8
+ *
+ * @param s 输出位置，至少4个字节
+ * @param ch 字符
+ * @return 返回编码后的位置
+ */
+extern char *_mxml_put_utf8(char *s, int ch);
+
+/**
+ * @brief 为内存中的数据初始化输入缓冲区
+ *
+ * @param r 输入缓冲区
+ * @param s 数据
+ * @param bytes 数据的字节数
+ */
+extern void _mxml_read_init_string(_mxml_read_t *r, const char *s, size_t bytes);
+
+/**
+ * @brief 查找第一个不是普通字符的字节，跳过有效的多字节UTF-8字符
+ *
+ * @param s 开始位置
+ * @param end 数据的结尾
+ * @param d1 第一个终止字符
+ * @param d2 第二个终止字符
+ * @param d3 第三个终止字符
+ * @return 返回普通字符的字节数
+ */
+extern size_t _mxml_scan_utf8(const unsigned char *s, const unsigned char *end, int d1, int d2, int d3);
+
 /**
  * @brief 复制字符串
  *
@@ -177,5 +459,77 @@ extern char *_mxml_strcopy(const char *s);
  */
 extern void _mxml_strfree(char *s);
 
+/**
+ * @brief 将UTF-16数据转换为UTF-8
+ *
+ * @param dst 输出缓冲区
+ * @param dstsize 输出缓冲区的大小
+ * @param src UTF-16数据中的当前位置，返回时指向第一个没有转换的代码单元
+ * @param srcend UTF-16数据的结尾
+ * @param encoding UTF-16字节顺序
+ * @return 返回输出的字节数
+ */
+extern size_t _mxml_utf16_convert(unsigned char *dst, size_t dstsize, unsigned char **src, unsigned char *srcend, _mxml_encoding_t encoding);
+
+/**
+ * @brief 写入输出缓冲区中的数据
+ *
+ * @param w 输出缓冲区
+ * @return 成功时返回true
+ */
+extern bool _mxml_write_flush(_mxml_write_t *w);
+
+/**
+ * @brief 释放输出缓冲区
+ *
+ * @param w 输出缓冲区
+ */
+extern void _mxml_write_free(_mxml_write_t *w);
+
+/**
+ * @brief 换行并写入指定级别的缩进
+ *
+ * @param options mxml_options_t 结构体指针
+ * @param w 输出缓冲区
+ * @param depth 缩进级别
+ * @param col 当前列数
+ * @return 返回新的列数，错误时返回-1
+ */
+extern int _mxml_write_indent(mxml_options_t *options, _mxml_write_t *w, int depth, int col);
+
+/**
+ * @brief 初始化输出缓冲区
+ *
+ * @param w 输出缓冲区
+ * @param options mxml_options_t 结构体指针
+ * @param io_cb 写入回调函数
+ * @param io_cbdata 写入回调数据
+ * @return 成功时返回true
+ */
+extern bool _mxml_write_init(_mxml_write_t *w, mxml_options_t *options, mxml_io_cb_t io_cb, void *io_cbdata);
+
+/**
+ * @brief 写入字符串的前bytes个字节，根据需要转义&和<
+ *
+ * @param s 要写入的字符串
+ * @param bytes 字节数
+ * @param w 输出缓冲区
+ * @param use_entities 是否转义特殊字符
+ * @param col 当前列数
+ * @return 返回新的列数，错误时返回-1
+ */
+extern int _mxml_write_nstring(const char *s, size_t bytes, _mxml_write_t *w, bool use_entities, int col);
+
+/**
+ * @brief 写入字符串，根据需要转义&和<
+ *
+ * @param s 要写入的字符串
+ * @param w 输出缓冲区
+ * @param use_entities 是否转义特殊字符
+ * @param col 当前列数
+ * @return 返回新的列数，错误时返回-1
+ */
+extern int _mxml_write_string(const char *s, _mxml_write_t *w, bool use_entities, int col);
+
 
 #endif // !MXML_PRIVATE_H
@@ -0,0 +1,780 @@
+//
+// Mini-XML的拉取式读取器代码，一个小型的XML文件解析库。
+//
+// https://www.msweet.org/mxml
+//
+// 版权所有 © 2003-2024 Michael R Sweet。
+//
+// 根据Apache许可证v2.0进行许可。更多信息请参见文件“LICENSE”。
+//
+
+#include "mxml-private.h"
+
+
+//
+// 本地类型...
+//
+
+struct _mxml_reader_s			// 拉取式读取器
+{
+  mxml_options_t	*options,	// 选项
+			*defoptions;	// 默认选项或`NULL`
+  _mxml_read_t		r;		// 输入缓冲区
+  char			*utf8;		// 从UTF-16转换的数据或`NULL`
+  int			line;		// 当前行号
+  bool			error,		// 是否遇到错误？
+			markup,		// 是否已读取下一个标记的"<"？
+			empty,		// 当前元素是否为空元素（"<name/>"）？
+			root;		// 是否已读取根元素？
+  mxml_sax_event_t	event;		// 当前事件
+  char			*name,		// 当前元素名
+			*text;		// 当前文本
+  size_t		num_attrs,	// 属性数
+			alloc_attrs;	// 分配的属性数
+  char			**attrs;	// 属性名和值
+  size_t		depth,		// 打开的元素数
+			alloc_depth;	// 分配的元素数
+  char			**stack;	// 打开的元素名
+};
+
+
+//
+// 本地函数...
+//
+
+static int		mxml_reader_getc(mxml_reader_t *reader);
+static int		mxml_reader_name(mxml_reader_t *reader, char **s);
+static int		mxml_reader_skip(mxml_reader_t *reader);
+static int		mxml_reader_string(mxml_reader_t *reader, int delim, char **s);
+static bool		mxml_reader_until(mxml_reader_t *reader, const char *term, char **s);
+
+
+//
+// 'mxmlReaderAttr()' - 获取当前元素的属性值。
+//
+// 只在`MXML_SAX_EVENT_ELEMENT_OPEN`事件之后有效，其他事件返回`NULL`。
+//
+
+const char *				// O - 属性值或`NULL`
+mxmlReaderAttr(mxml_reader_t *reader,	// I - 拉取式读取器
+               const char    *name)	// I - 属性名
+{
+  size_t	i;			// 循环变量
+
+
+  if (!reader || !name)
+    return (NULL);
+
+  for (i = 0; i < reader->num_attrs; i ++)
+  {
+    if (!strcmp(reader->attrs[2 * i], name))
+      return (reader->attrs[2 * i + 1]);
+  }
+
+  return (NULL);
+}
+
+
+//
+// 'mxmlReaderDelete()' - 释放拉取式读取器。
+//
+
+void
+mxmlReaderDelete(mxml_reader_t *reader)	// I - 拉取式读取器
+{
+  if (!reader)
+    return;
+
+  mxmlOptionsDelete(reader->defoptions);
+
+  free(reader->utf8);
+  free(reader->attrs);
+  free(reader->stack);
+  free(reader);
+}
+
+
+//
+// 'mxmlReaderName()' - 获取当前元素的名称。
+//
+// 只在`MXML_SAX_EVENT_ELEMENT_OPEN`和`MXML_SAX_EVENT_ELEMENT_CLOSE`事件之后有效，其他事件返回`NULL`。
+//
+
+const char *				// O - 元素名或`NULL`
+mxmlReaderName(mxml_reader_t *reader)	// I - 拉取式读取器
+{
+  return (reader ? reader->name : NULL);
+}
+
+
+//
+// 'mxmlReaderNew()' - 创建拉取式读取器。
+//
+// 读取器不创建节点树，而是逐个返回缓冲区中的令牌。名称、属性值和文本原位解码并以空字符结束，
+// 直接指向缓冲区（UTF-16数据则先转换为读取器中的UTF-8副本），在删除读取器并释放缓冲区之前有效。
+//
+
+mxml_reader_t *				// O - 拉取式读取器，如果内存不足或数据有错误则为`NULL`
+mxmlReaderNew(mxml_options_t *options,	// I - 选项或`NULL`表示默认选项
+              char           *buffer,	// I - 要读取的缓冲区，读取时会被修改
+              size_t         bytes)	// I - 缓冲区的长度（字节）
+{
+  mxml_reader_t	*reader;		// 拉取式读取器
+  unsigned char	*src,			// UTF-16数据中的当前位置
+		*srcend;		// UTF-16数据的结尾
+  size_t	utf8size;		// UTF-8副本的大小
+
+
+  if (!buffer)
+    return (NULL);
+
+  if ((reader = calloc(1, sizeof(mxml_reader_t))) == NULL)
+    return (NULL);
+
+  if (!options && (options = reader->defoptions = mxmlOptionsNew()) == NULL)
+  {
+    free(reader);
+    return (NULL);
+  }
+
+  reader->options = options;
+  reader->line    = 1;
+
+  if (bytes >= 2 && (((buffer[0] & 255) == 0xfe && (buffer[1] & 255) == 0xff) || ((buffer[0] & 255) == 0xff && (buffer[1] & 255) == 0xfe)))
+  {
+    // UTF-16数据一次性转换为UTF-8，每个代码单元最多3个字节...
+    utf8size = bytes / 2 * 3 + 4;
+
+    if ((reader->utf8 = malloc(utf8size)) == NULL)
+    {
+      _mxml_error(options, "无法分配%lu字节的UTF-8缓冲区。", (unsigned long)utf8size);
+      mxmlReaderDelete(reader);
+      return (NULL);
+    }
+
+    src    = (unsigned char *)buffer + 2;
+    srcend = (unsigned char *)buffer + bytes;
+    bytes  = _mxml_utf16_convert((unsigned char *)reader->utf8, utf8size, &src, srcend, (buffer[0] & 255) == 0xfe ? _MXML_ENCODING_UTF16BE : _MXML_ENCODING_UTF16LE);
+
+    if (src < srcend)
+    {
+      _mxml_error(options, "无效的UTF-16数据。");
+      mxmlReaderDelete(reader);
+      return (NULL);
+    }
+
+    buffer = reader->utf8;
+  }
+  else if (bytes >= 3 && !memcmp(buffer, "\357\273\277", 3))
+  {
+    // 跳过UTF-8字节顺序标记...
+    buffer += 3;
+    bytes  -= 3;
+  }
+
+  _mxml_read_init_string(&reader->r, buffer, bytes);
+
+  return (reader);
+}
+
+
+//
+// 'mxmlReaderNext()' - 读取下一个令牌。
+//
+// 事件与SAX回调函数的事件相同，空元素"<name/>"返回打开和关闭两个事件。根元素之外的空白字符被忽略。
+// 在数据结尾或遇到错误时返回`false`，错误通过选项的错误回调函数报告。
+//
+
+bool					// O - `true`表示读取了令牌，`false`表示数据结尾或错误
+mxmlReaderNext(mxml_reader_t    *reader,// I - 拉取式读取器
+               mxml_sax_event_t *event)	// O - 事件类型
+{
+  _mxml_read_t	*r;			// 输入缓冲区
+  int		ch;			// 当前字符
+  char		*name,			// 属性名
+		*value,			// 属性值
+		**temp;			// 新数组
+
+
+  if (!reader || reader->error)
+    return (false);
+
+  r = &reader->r;
+
+  reader->name      = NULL;
+  reader->text      = NULL;
+  reader->num_attrs = 0;
+
+  if (reader->empty)
+  {
+    // 空元素的关闭事件...
+    reader->empty = false;
+    reader->event = MXML_SAX_EVENT_ELEMENT_CLOSE;
+    reader->name  = reader->stack[-- reader->depth];
+
+    goto done;
+  }
+
+  if (!reader->markup)
+  {
+    if (reader->depth == 0)
+    {
+      // 根元素之外只允许空白字符和标记...
+      if ((ch = mxml_reader_skip(reader)) == EOF)
+        return (false);
+
+      if (ch != '<')
+      {
+        _mxml_error(reader->options, "根元素之外的字符数据，位于第 %d 行。", reader->line);
+        reader->error = true;
+        return (false);
+      }
+
+      r->bufptr ++;
+    }
+    else if (r->bufptr < r->bufend && *(r->bufptr) == '<')
+    {
+      r->bufptr ++;
+    }
+    else
+    {
+      // 字符数据，终止的空字符可能覆盖下一个标记的"<"...
+      if (mxml_reader_string(reader, '<', &reader->text) == EOF)
+      {
+        if (!reader->error)
+        {
+          _mxml_error(reader->options, "缺少闭合标签 </%s>，在第 %d 行。", reader->stack[reader->depth - 1], reader->line);
+          reader->error = true;
+        }
+
+        return (false);
+      }
+
+      reader->markup = true;
+      reader->event  = MXML_SAX_EVENT_DATA;
+
+      goto done;
+    }
+  }
+
+  reader->markup = false;
+
+  if (r->bufptr >= r->bufend)
+  {
+    _mxml_error(reader->options, "标记在第 %d 行遇到早期的 EOF。", reader->line);
+    reader->error = true;
+    return (false);
+  }
+
+  if (*(r->bufptr) == '?')
+  {
+    // 处理指令...
+    r->bufptr ++;
+
+    if (!mxml_reader_until(reader, "?>", &reader->text))
+      return (false);
+
+    reader->event = MXML_SAX_EVENT_DIRECTIVE;
+  }
+  else if ((size_t)(r->bufend - r->bufptr) >= 3 && !memcmp(r->bufptr, "!--", 3))
+  {
+    // 注释...
+    r->bufptr += 3;
+
+    if (!mxml_reader_until(reader, "-->", &reader->text))
+      return (false);
+
+    reader->event = MXML_SAX_EVENT_COMMENT;
+  }
+  else if ((size_t)(r->bufend - r->bufptr) >= 8 && !memcmp(r->bufptr, "![CDATA[", 8))
+  {
+    // CDATA...
+    r->bufptr += 8;
+
+    if (!mxml_reader_until(reader, "]]>", &reader->text))
+      return (false);
+
+    reader->event = MXML_SAX_EVENT_CDATA;
+  }
+  else if (*(r->bufptr) == '!')
+  {
+    // 声明...
+    r->bufptr ++;
+
+    if (mxml_reader_string(reader, '>', &reader->text) == EOF)
+    {
+      if (!reader->error)
+      {
+        _mxml_error(reader->options, "声明在第 %d 行遇到早期的 EOF。", reader->line);
+        reader->error = true;
+      }
+
+      return (false);
+    }
+
+    reader->event = MXML_SAX_EVENT_DECLARATION;
+  }
+  else if (*(r->bufptr) == '/')
+  {
+    // 闭合标签...
+    r->bufptr ++;
+
+    if ((ch = mxml_reader_name(reader, &name)) == EOF)
+      return (false);
+
+    if (MXML_ISSPACE(ch) && (ch = mxml_reader_skip(reader)) == '>')
+      r->bufptr ++;
+
+    if (ch != '>')
+    {
+      if (!reader->error)
+      {
+        _mxml_error(reader->options, "闭合标签 </%s> 预期为 >，在第 %d 行。", name, reader->line);
+        reader->error = true;
+      }
+
+      return (false);
+    }
+
+    if (reader->depth == 0 || strcmp(name, reader->stack[reader->depth - 1]))
+    {
+      _mxml_error(reader->options, "不匹配的闭合标签 </%s>，在父节点 <%s> 下，在第 %d 行。", name, reader->depth ? reader->stack[reader->depth - 1] : "(null)", reader->line);
+      reader->error = true;
+      return (false);
+    }
+
+    reader->event = MXML_SAX_EVENT_ELEMENT_CLOSE;
+    reader->name  = reader->stack[-- reader->depth];
+  }
+  else
+  {
+    // 开放标签...
+    if (reader->depth == 0 && reader->root)
+    {
+      _mxml_error(reader->options, "只能有一个根元素，在第 %d 行。", reader->line);
+      reader->error = true;
+      return (false);
+    }
+
+    if ((ch = mxml_reader_name(reader, &reader->name)) == EOF)
+      return (false);
+
+    if (reader->depth >= reader->alloc_depth)
+    {
+      if ((temp = realloc(reader->stack, (reader->alloc_depth + 16) * sizeof(char *))) == NULL)
+      {
+        _mxml_error(reader->options, "无法为元素 <%s> 分配内存，在第 %d 行。", reader->name, reader->line);
+        reader->error = true;
+        return (false);
+      }
+
+      reader->stack       = temp;
+      reader->alloc_depth += 16;
+    }
+
+    reader->stack[reader->depth ++] = reader->name;
+    reader->root                    = true;
+
+    while (ch != '>')
+    {
+      if (ch == '/' || ch == '?')
+      {
+        // 空元素...
+        if (r->bufptr >= r->bufend || *(r->bufptr) != '>')
+        {
+          _mxml_error(reader->options, "在元素 %s 的 '%c' 后期望 '>'，在第 %d 行。", reader->name, ch, reader->line);
+          reader->error = true;
+          return (false);
+        }
+
+        r->bufptr ++;
+        reader->empty = true;
+        break;
+      }
+      else if (!MXML_ISSPACE(ch))
+      {
+        _mxml_error(reader->options, "元素 %s 中意外的 '%c'，在第 %d 行。", reader->name, ch, reader->line);
+        reader->error = true;
+        return (false);
+      }
+
+      // 跳过空白字符，查找下一个属性或标签的结尾...
+      if ((ch = mxml_reader_skip(reader)) == '>' || ch == '/' || ch == '?')
+      {
+        r->bufptr ++;
+        continue;
+      }
+      else if (ch == EOF)
+      {
+        _mxml_error(reader->options, "元素 %s 在第 %d 行遇到早期的 EOF。", reader->name, reader->line);
+        reader->error = true;
+        return (false);
+      }
+
+      // 读取属性名...
+      if ((ch = mxml_reader_name(reader, &name)) == EOF)
+        return (false);
+
+      if (MXML_ISSPACE(ch) && (ch = mxml_reader_skip(reader)) == '=')
+        r->bufptr ++;
+
+      if (ch != '=')
+      {
+        _mxml_error(reader->options, "在元素 %s 的属性 '%s' 中缺少值，位于第 %d 行。", reader->name, name, reader->line);
+        reader->error = true;
+        return (false);
+      }
+
+      // 读取属性值...
+      if ((ch = mxml_reader_skip(reader)) == '\"' || ch == '\'')
+      {
+        r->bufptr ++;
+
+        if (mxml_reader_string(reader, ch, &value) == EOF)
+        {
+          if (!reader->error)
+          {
+            _mxml_error(reader->options, "元素 %s 的属性 '%s' 在第 %d 行遇到早期的 EOF。", reader->name, name, reader->line);
+            reader->error = true;
+          }
+
+          return (false);
+        }
+
+        // 引号之后继续查找下一个属性...
+        ch = ' ';
+      }
+      else if (ch == EOF || (ch = mxml_reader_name(reader, &value)) == EOF)
+      {
+        if (!reader->error)
+        {
+          _mxml_error(reader->options, "在元素 %s 的属性 '%s' 中缺少值，位于第 %d 行。", reader->name, name, reader->line);
+          reader->error = true;
+        }
+
+        return (false);
+      }
+
+      // 添加属性...
+      for (temp = reader->attrs; temp < (reader->attrs + 2 * reader->num_attrs); temp += 2)
+      {
+        if (!strcmp(*temp, name))
+        {
+          _mxml_error(reader->options, "在元素 %s 中重复的属性 '%s'，位于第 %d 行。", reader->name, name, reader->line);
+          reader->error = true;
+          return (false);
+        }
+      }
+
+      if (reader->num_attrs >= reader->alloc_attrs)
+      {
+        if ((temp = realloc(reader->attrs, 2 * (reader->alloc_attrs + 8) * sizeof(char *))) == NULL)
+        {
+          _mxml_error(reader->options, "无法为元素 %s 的属性分配内存，在第 %d 行。", reader->name, reader->line);
+          reader->error = true;
+          return (false);
+        }
+
+        reader->attrs       = temp;
+        reader->alloc_attrs += 8;
+      }
+
+      reader->attrs[2 * reader->num_attrs]     = name;
+      reader->attrs[2 * reader->num_attrs + 1] = value;
+      reader->num_attrs ++;
+    }
+
+    reader->event = MXML_SAX_EVENT_ELEMENT_OPEN;
+  }
+
+  done:
+
+  if (event)
+    *event = reader->event;
+
+  return (true);
+}
+
+
+//
+// 'mxmlReaderSkipSubtree()' - 跳过当前元素的其余部分。
+//
+// 在`MXML_SAX_EVENT_ELEMENT_OPEN`事件之后调用，跳过元素的子节点和闭合标签，下一个令牌是元素之后的令牌。
+//
+
+bool					// O - `true`表示成功，`false`表示数据有错误或当前令牌不是开放标签
+mxmlReaderSkipSubtree(
+    mxml_reader_t *reader)		// I - 拉取式读取器
+{
+  size_t	depth;			// 元素的深度
+
+
+  if (!reader || !reader->name || reader->event != MXML_SAX_EVENT_ELEMENT_OPEN)
+    return (false);
+
+  for (depth = reader->depth; reader->depth >= depth;)
+  {
+    if (!mxmlReaderNext(reader, /*event*/NULL))
+      return (false);
+  }
+
+  return (true);
+}
+
+
+//
+// 'mxmlReaderText()' - 获取当前令牌的文本。
+//
+// 返回字符数据、CDATA、注释、处理指令或声明的内容，元素事件返回`NULL`。
+//
+
+const char *				// O - 文本或`NULL`
+mxmlReaderText(mxml_reader_t *reader)	// I - 拉取式读取器
+{
+  return (reader ? reader->text : NULL);
+}
+
+//
+// 'mxml_reader_getc()' - 读取并检查拉取式读取器中的下一个字符。
+//
+
+static int				// O - 字符或`EOF`
+mxml_reader_getc(mxml_reader_t *reader)	// I - 拉取式读取器
+{
+  _mxml_read_t	*r = &reader->r;	// 输入缓冲区
+  int		ch;			// 当前字符
+
+
+  if (r->bufptr >= r->bufend)
+    return (EOF);
+
+  if (*(r->bufptr) < 0x80)
+  {
+    // ASCII...
+    ch = *(r->bufptr)++;
+
+    if (ch == '\n')
+    {
+      reader->line ++;
+    }
+    else if (MXML_BAD_CHAR(ch))
+    {
+      _mxml_error(reader->options, "XML 标准不允许使用的控制字符 0x%02x，位于第 %d 行。", ch, reader->line);
+      reader->error = true;
+      return (EOF);
+    }
+
+    return (ch);
+  }
+
+  // 多字节UTF-8序列...
+  if ((ch = _mxml_getc(reader->options, r)) == EOF)
+  {
+    _mxml_error(reader->options, "在第 %d 行遇到无效的数据。", reader->line);
+    reader->error = true;
+    return (EOF);
+  }
+
+  return (ch);
+}
+
+
+//
+// 'mxml_reader_name()' - 读取元素名、属性名或不带引号的属性值。
+//
+// 名称在终止字符（空白字符、"="、"/"、">"或"?"）处以空字符结束，返回被覆盖的终止字符。
+//
+
+static int				// O - 终止字符或`EOF`表示错误
+mxml_reader_name(mxml_reader_t *reader,	// I - 拉取式读取器
+                 char          **s)	// O - 名称
+{
+  _mxml_read_t	*r = &reader->r;	// 输入缓冲区
+  int		ch;			// 当前字符
+
+
+  *s = (char *)r->bufptr;
+
+  for (;;)
+  {
+    // 跳过普通的ASCII字符...
+    while (r->bufptr < r->bufend && (ch = *(r->bufptr)) < 0x80 && ((ch >= '0' && ch != '<' && ch != '=' && ch != '>' && ch != '?') || ch == '-' || ch == '.'))
+      r->bufptr ++;
+
+    if (r->bufptr >= r->bufend)
+    {
+      _mxml_error(reader->options, "名称在第 %d 行遇到早期的 EOF。", reader->line);
+      reader->error = true;
+      return (EOF);
+    }
+
+    if ((ch = *(r->bufptr)) >= 0x80)
+    {
+      if (mxml_reader_getc(reader) == EOF)
+        return (EOF);
+    }
+    else if (MXML_ISSPACE(ch) || ch == '=' || ch == '/' || ch == '>' || ch == '?')
+    {
+      if ((char *)r->bufptr == *s)
+        break;
+
+      if (ch == '\n')
+        reader->line ++;
+
+      *(r->bufptr)++ = '\0';
+
+      return (ch);
+    }
+    else
+    {
+      break;
+    }
+  }
+
+  _mxml_error(reader->options, "名称中意外的 '%c'，在第 %d 行。", ch, reader->line);
+  reader->error = true;
+
+  return (EOF);
+}
+
+
+//
+// 'mxml_reader_skip()' - 跳过空白字符。
+//
+
+static int				// O - 下一个字符（尚未读取）或`EOF`
+mxml_reader_skip(mxml_reader_t *reader)	// I - 拉取式读取器
+{
+  _mxml_read_t	*r = &reader->r;	// 输入缓冲区
+
+
+  for (; r->bufptr < r->bufend && MXML_ISSPACE(*(r->bufptr)); r->bufptr ++)
+  {
+    if (*(r->bufptr) == '\n')
+      reader->line ++;
+  }
+
+  return (r->bufptr < r->bufend ? *(r->bufptr) : EOF);
+}
+
+
+//
+// 'mxml_reader_string()' - 读取字符数据或属性值，原位解码实体。
+//
+// 字符串在终止字符之前以空字符结束，解码后的字符串可能比原始数据短，因此空字符可能不在终止字符的位置。
+//
+
+static int				// O - 终止字符或`EOF`表示数据结尾或错误
+mxml_reader_string(
+    mxml_reader_t *reader,		// I - 拉取式读取器
+    int           delim,		// I - 终止字符
+    char          **s)			// O - 字符串
+{
+  _mxml_read_t	*r = &reader->r;	// 输入缓冲区
+  unsigned char	*start;			// 普通字符的开头
+  char		*out,			// 解码的位置
+		temp[4],		// 编码后的字符
+		*tempptr;		// 编码后的字符的结尾
+  int		ch;			// 当前字符
+
+
+  *s  = (char *)r->bufptr;
+  out = *s;
+
+  for (;;)
+  {
+    // 复制普通字符，没有实体时不需要移动数据...
+    start     = r->bufptr;
+    r->bufptr += _mxml_scan_utf8(r->bufptr, r->bufend, delim, '&', '&');
+
+    if (out != (char *)start)
+      memmove(out, start, (size_t)(r->bufptr - start));
+
+    out += r->bufptr - start;
+
+    if (r->bufptr >= r->bufend)
+      return (EOF);
+
+    if ((ch = *(r->bufptr)) == delim)
+    {
+      r->bufptr ++;
+      *out = '\0';
+
+      return (ch);
+    }
+    else if (ch == '&')
+    {
+      r->bufptr ++;
+
+      if ((ch = _mxml_get_entity(reader->options, r, /*parent*/NULL, &reader->line)) == EOF)
+      {
+        reader->error = true;
+        return (EOF);
+      }
+    }
+    else if ((ch = mxml_reader_getc(reader)) == EOF)
+    {
+      return (EOF);
+    }
+
+    // 写入解码后的字符，不能超过读取位置...
+    tempptr = _mxml_put_utf8(temp, ch);
+
+    if ((out + (tempptr - temp)) > (char *)r->bufptr)
+    {
+      _mxml_error(reader->options, "字符 0x%x 无法原位解码，位于第 %d 行。", ch, reader->line);
+      reader->error = true;
+      return (EOF);
+    }
+
+    memcpy(out, temp, (size_t)(tempptr - temp));
+    out += tempptr - temp;
+  }
+}
+
+
+//
+// 'mxml_reader_until()' - 读取注释、CDATA或处理指令直到终止字符串。
+//
+
+static bool				// O - `true`表示成功，`false`表示错误
+mxml_reader_until(mxml_reader_t *reader,// I - 拉取式读取器
+                  const char    *term,	// I - 终止字符串
+                  char          **s)	// O - 内容
+{
+  _mxml_read_t	*r = &reader->r;	// 输入缓冲区
+  size_t	termlen = strlen(term);	// 终止字符串的长度
+
+
+  *s = (char *)r->bufptr;
+
+  for (;;)
+  {
+    // 跳过普通字符...
+    r->bufptr += _mxml_scan_utf8(r->bufptr, r->bufend, *term, *term, *term);
+
+    if (r->bufptr >= r->bufend)
+    {
+      _mxml_error(reader->options, "<%s 在第 %d 行遇到早期的 EOF。", term[0] == '?' ? "?" : term[0] == '-' ? "!--" : "![CDATA[", reader->line);
+      reader->error = true;
+      return (false);
+    }
+
+    if (*(r->bufptr) == *term)
+    {
+      if ((size_t)(r->bufend - r->bufptr) >= termlen && !memcmp(r->bufptr, term, termlen))
+      {
+        *(r->bufptr) = '\0';
+        r->bufptr    += termlen;
+
+        return (true);
+      }
+
+      r->bufptr ++;
+    }
+    else if (mxml_reader_getc(reader) == EOF)
+    {
+      return (false);
+    }
+  }
+}
@@ -67,6 +67,61 @@ mxmlFindElement(mxml_node_t    *node,	// 输入 - 当前节点
 }
 
 
+//
+// 'mxmlFindElementAtom()' - 通过原子查找指定的元素。
+//
+// 此函数与@link mxmlFindElement@相同，但元素名称`element`和属性名称`attr`必须是@link mxmlGetAtom@返回的原子。对于使用@link mxmlOptionsSetInternNames@加载的节点，只比较名称的指针而不比较字符串。属性值`value`仍然使用`strcmp`比较。
+//
+
+mxml_node_t *				// 输出 - 元素节点或`NULL`
+mxmlFindElementAtom(
+    mxml_node_t    *node,		// 输入 - 当前节点
+    mxml_node_t    *top,		// 输入 - 顶级节点
+    const char     *element,		// 输入 - 元素名称原子或`NULL`表示任意元素
+    const char     *attr,		// 输入 - 属性名称原子或`NULL`表示无属性
+    const char     *value,		// 输入 - 属性值或`NULL`表示任意值
+    mxml_descend_t descend)		// 输入 - 遍历树的方式 - `MXML_DESCEND_ALL`、`MXML_DESCEND_NONE`或`MXML_DESCEND_FIRST`
+{
+  const char	*temp;			// 当前属性值
+
+
+  // 输入范围检查...
+  if (!node || !top || (!attr && value))
+    return (NULL);
+
+  // 从下一个节点开始...
+  node = mxmlWalkNext(node, top, descend);
+
+  // 循环直到找到匹配的元素...
+  while (node != NULL)
+  {
+    // 检查此节点是否匹配...
+    if (node->type == MXML_TYPE_ELEMENT && node->value.element.name && (!element || _mxml_node_nameeq(node, node->value.element.name, element)))
+    {
+      // 检查是否需要检查属性...
+      if (!attr)
+        return (node);			// 无属性搜索，返回该节点...
+
+      // 检查属性...
+      if ((temp = mxmlElementGetAttrAtom(node, attr)) != NULL)
+      {
+        // 属性匹配，返回该节点...
+	if (!value || !strcmp(value, temp))
+	  return (node);
+      }
+    }
+
+    // 无匹配，继续下一个节点...
+    if (descend == MXML_DESCEND_ALL)
+      node = mxmlWalkNext(node, top, MXML_DESCEND_ALL);
+    else
+      node = node->next;
+  }
+
+  return (NULL);
+}
+
+
 //
 // 'mxmlFindPath()' - 根据给定的路径查找节点。
 //
@@ -125,6 +180,8 @@ mxmlFindPath(mxml_node_t *top,		// 输入 - 顶级节点
   }
 
   // 如果执行到这里，返回节点或其第一个子节点...
+  MXML_EXPAND(node);
+
   if (node->child && node->child->type != MXML_TYPE_ELEMENT)
     return (node->child);
   else
@@ -144,10 +201,13 @@ mxmlWalkNext(mxml_node_t    *node,	// 输入 - 当前节点
              mxml_descend_t descend)	// 输入 - 遍历树的方式 - `MXML_DESCEND_ALL`、`MXML_DESCEND_NONE`或`MXML_DESCEND_FIRST`
 {
   if (!node)
-  {
     return (NULL);
-  }
-  else if (node->child && descend != MXML_DESCEND_NONE)
+
+  // 进入子节点之前加载延迟的内容...
+  if (descend != MXML_DESCEND_NONE)
+    MXML_EXPAND(node);
+
+  if (node->child && descend != MXML_DESCEND_NONE)
   {
     return (node->child);
   }
@@ -197,13 +257,21 @@ mxmlWalkPrev(mxml_node_t    *node,	// 输入 - 当前节点
   }
   else if (node->prev)
   {
+    // 进入子节点之前加载延迟的内容...
+    if (descend != MXML_DESCEND_NONE)
+      MXML_EXPAND(node->prev);
+
     if (node->prev->last_child && descend != MXML_DESCEND_NONE)
     {
       // 查找上一个节点下的最后一个子节点...
       node = node->prev->last_child;
+      MXML_EXPAND(node);
 
       while (node->last_child)
+      {
         node = node->last_child;
+        MXML_EXPAND(node);
+      }
 
       return (node);
     }
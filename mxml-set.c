@@ -23,6 +23,9 @@ mxmlSetCDATA（mxml_node_t *node，		// 要设置的节点
   char	*s;				// 新元素名称
 
 
+  // 加载元素延迟的内容...
+  MXML_EXPAND(node);
+
   // 输入范围检查...
   if (node && node->type == MXML_TYPE_ELEMENT && node->child && node->child->type == MXML_TYPE_CDATA)
     node = node->child;
@@ -39,10 +42,10 @@ mxmlSetCDATA（mxml_node_t *node，		// 要设置的节点
   }
 
   // 分配新值，释放任何旧元素值，并设置新值...
-  if ((s = _mxml_strcopy（data）) == NULL)
+  if ((s = _mxml_node_strcopy(node, data)) == NULL)
     return (false);
 
-  _mxml_strfree（node->value.cdata）;
+  _mxml_node_strfree(node, node->value.cdata);
   node->value.cdata = s;
 
   return (true);
@@ -64,6 +67,9 @@ mxmlSetCDATAf（mxml_node_t *node，	// 节点
   char		*s;			// 临时字符串
 
 
+  // 加载元素延迟的内容...
+  MXML_EXPAND(node);
+
   // 输入范围检查...
   if (node && node->type == MXML_TYPE_ELEMENT && node->child && node->child->type == MXML_TYPE_CDATA)
     node = node->child;
@@ -78,10 +84,10 @@ mxmlSetCDATAf（mxml_node_t *node，	// 节点
   vsnprintf(buffer, sizeof(buffer), format, ap);
   va_end(ap);
 
-  if ((s = _mxml_strcopy（buffer）) == NULL)
+  if ((s = _mxml_node_strcopy(node, buffer)) == NULL)
     return (false);
 
-  _mxml_strfree（node->value.cdata）;
+  _mxml_node_strfree(node, node->value.cdata);
   node->value.cdata = s;
 
   return (true);
@@ -100,6 +106,9 @@ mxmlSetComment（mxml_node_t *node，	// 节点
   char *s;				// 新字符串
 
 
+  // 加载元素延迟的内容...
+  MXML_EXPAND(node);
+
   // 输入范围检查...
   if (node && node->type == MXML_TYPE_ELEMENT && node->child && node->child->type == MXML_TYPE_COMMENT)
     node = node->child;
@@ -113,10 +122,10 @@ mxmlSetComment（mxml_node_t *node，	// 节点
     return (true);
 
   // 释放任何旧字符串值并设置新值...
-  if ((s = _mxml_strcopy（comment）) == NULL)
+  if ((s = _mxml_node_strcopy(node, comment)) == NULL)
     return (false);
 
-  _mxml_strfree（node->value.comment）;
+  _mxml_node_strfree(node, node->value.comment);
   node->value.comment = s;
 
   return (true);
@@ -138,6 +147,9 @@ mxmlSetCommentf（mxml_node_t *node，	// 节点
   char		*s;			// 临时字符串
 
 
+  // 加载元素延迟的内容...
+  MXML_EXPAND(node);
+
   // 输入范围检查...
   if (node && node->type == MXML_TYPE_ELEMENT && node->child && node->child->type == MXML_TYPE_COMMENT)
     node = node->child;
@@ -152,10 +164,10 @@ mxmlSetCommentf（mxml_node_t *node，	// 节点
   vsnprintf(buffer, sizeof(buffer), format, ap);
   va_end(ap);
 
-  if ((s = _mxml_strcopy（buffer）) == NULL)
+  if ((s = _mxml_node_strcopy(node, buffer)) == NULL)
     return (false);
 
-  _mxml_strfree（node->value.comment）;
+  _mxml_node_strfree(node, node->value.comment);
   node->value.comment = s;
 
   return (true);
@@ -174,6 +186,9 @@ mxmlSetCustom(
     mxml_custfree_cb_t free_cb,		// 释放回调函数
     void               *free_cbdata)	// 释放回调数据
 {
+  // 加载元素延迟的内容...
+  MXML_EXPAND(node);
+
   // 输入范围检查...
   if (node && node->type == MXML_TYPE_ELEMENT && node->child && node->child->type == MXML_TYPE_CUSTOM)
     node = node->child;
@@ -212,6 +227,9 @@ mxmlSetDeclaration(
   char *s;				// 新字符串
 
 
+  // 加载元素延迟的内容...
+  MXML_EXPAND(node);
+
   // 输入范围检查...
   if (node && node->type == MXML_TYPE_ELEMENT && node->child && node->child->type == MXML_TYPE_DECLARATION)
     node = node->child;
@@ -225,10 +243,10 @@ mxmlSetDeclaration(
     return (true);
 
   // 释放任何旧字符串值并设置新值...
-  if ((s = _mxml_strcopy（declaration）) == NULL)
+  if ((s = _mxml_node_strcopy(node, declaration)) == NULL)
     return (false);
 
-  _mxml_strfree（node->value.declaration）;
+  _mxml_node_strfree(node, node->value.declaration);
   node->value.declaration = s;
 
   return (true);
@@ -250,6 +268,9 @@ mxmlSetDeclarationf(mxml_node_t *node,	// 节点
   char		*s;			// 临时字符串
 
 
+  // 加载元素延迟的内容...
+  MXML_EXPAND(node);
+
   // 输入范围检查...
   if (node && node->type == MXML_TYPE_ELEMENT && node->child && node->child->type == MXML_TYPE_COMMENT)
     node = node->child;
@@ -264,10 +285,10 @@ mxmlSetDeclarationf(mxml_node_t *node,	// 节点
   vsnprintf(buffer, sizeof(buffer), format, ap);
   va_end(ap);
 
-  if ((s = _mxml_strcopy（buffer）) == NULL)
+  if ((s = _mxml_node_strcopy(node, buffer)) == NULL)
     return (false);
 
-  _mxml_strfree（node->value.declaration）;
+  _mxml_node_strfree(node, node->value.declaration);
   node->value.declaration = s;
 
   return (true);
@@ -286,6 +307,9 @@ mxmlSetDirective(mxml_node_t *node,	// 节点
   char *s;				// 新字符串
 
 
+  // 加载元素延迟的内容...
+  MXML_EXPAND(node);
+
   // 输入范围检查...
   if (node && node->type == MXML_TYPE_ELEMENT && node->child && node->child->type == MXML_TYPE_DIRECTIVE)
     node = node->child;
@@ -299,10 +323,10 @@ mxmlSetDirective(mxml_node_t *node,	// 节点
     return (true);
 
   // 释放任何旧字符串值并设置新值...
-  if ((s = _mxml_strcopy（directive）) == NULL)
+  if ((s = _mxml_node_strcopy(node, directive)) == NULL)
     return (false);
 
-  _mxml_strfree（node->value.directive）;
+  _mxml_node_strfree(node, node->value.directive);
   node->value.directive = s;
 
   return (true);
@@ -324,6 +348,9 @@ mxmlSetDirectivef(mxml_node_t *node,	// 节点
   char		*s;			// 临时字符串
 
 
+  // 加载元素延迟的内容...
+  MXML_EXPAND(node);
+
   // 输入范围检查...
   if (node && node->type == MXML_TYPE_ELEMENT && node->child && node->child->type == MXML_TYPE_DIRECTIVE)
     node = node->child;
@@ -338,10 +365,10 @@ mxmlSetDirectivef(mxml_node_t *node,	// 节点
   vsnprintf(buffer, sizeof(buffer), format, ap);
   va_end(ap);
 
-  if ((s = _mxml_strcopy（buffer）) == NULL)
+  if ((s = _mxml_node_strcopy(node, buffer)) == NULL)
     return (false);
 
-  _mxml_strfree（node->value.directive）;
+  _mxml_node_strfree(node, node->value.directive);
   node->value.directive = s;
 
   return (true);
@@ -370,10 +397,10 @@ mxmlSetElement(mxml_node_t *node,	// 要设置的节点
     return (true);
 
   // 释放任何旧元素值并设置新值...
-  if ((s = _mxml_strcopy（name）) == NULL)
+  if ((s = _mxml_node_namecopy(node, name)) == NULL)
     return (false);
 
-  _mxml_strfree（node->value.element.name）;
+  _mxml_node_namefree(node, node->value.element.name);
   node->value.element.name = s;
 
   return (true);
@@ -389,6 +416,9 @@ bool					// 成功返回true，失败返回false
 mxmlSetInteger(mxml_node_t *node,	// 要设置的节点
                long        integer)	// 整数值
 {
+  // 加载元素延迟的内容...
+  MXML_EXPAND(node);
+
   // 输入范围检查...
   if (node && node->type == MXML_TYPE_ELEMENT && node->child && node->child->type == MXML_TYPE_INTEGER)
     node = node->child;
@@ -415,6 +445,9 @@ mxmlSetOpaque(mxml_node_t *node,	// 要设置的节点
   char *s;				// 新不透明字符串
 
 
+  // 加载元素延迟的内容...
+  MXML_EXPAND(node);
+
   // 输入范围检查...
   if (node && node->type == MXML_TYPE_ELEMENT && node->child && node->child->type == MXML_TYPE_OPAQUE)
     node = node->child;
@@ -428,10 +461,10 @@ mxmlSetOpaque(mxml_node_t *node,	// 要设置的节点
     return (true);
 
   // 释放任何旧不透明值并设置新值...
-  if ((s = _mxml_strcopy（opaque）) == NULL)
+  if ((s = _mxml_node_strcopy(node, opaque)) == NULL)
     return (false);
 
-  _mxml_strfree（node->value.opaque）;
+  _mxml_node_strfree(node, node->value.opaque);
   node->value.opaque = s;
 
   return (true);
@@ -453,6 +486,9 @@ mxmlSetOpaquef(mxml_node_t *node,	// 要设置的节点
   char		*s;			// 临时字符串
 
 
+  // 加载元素延迟的内容...
+  MXML_EXPAND(node);
+
   // 输入范围检查...
   if (node && node->type == MXML_TYPE_ELEMENT && node->child && node->child->type == MXML_TYPE_OPAQUE)
     node = node->child;
@@ -467,10 +503,10 @@ mxmlSetOpaquef(mxml_node_t *node,	// 要设置的节点
   vsnprintf(buffer, sizeof(buffer), format, ap);
   va_end(ap);
 
-  if ((s = _mxml_strcopy（buffer）) == NULL)
+  if ((s = _mxml_node_strcopy(node, buffer)) == NULL)
     return (false);
 
-  _mxml_strfree（node->value.opaque）;
+  _mxml_node_strfree(node, node->value.opaque);
   node->value.opaque = s;
 
   return (true);
@@ -486,6 +522,9 @@ bool					// 成功返回true，失败返回false
 mxmlSetReal(mxml_node_t *node,		// 要设置的节点
             double      real)		// 实数值
 {
+  // 加载元素延迟的内容...
+  MXML_EXPAND(node);
+
   // 输入范围检查...
   if (node && node->type == MXML_TYPE_ELEMENT && node->child && node->child->type == MXML_TYPE_REAL)
     node = node->child;
@@ -513,6 +552,9 @@ mxmlSetText(mxml_node_t *node,		// 要设置的节点
   char *s;				// 新字符串
 
 
+  // 加载元素延迟的内容...
+  MXML_EXPAND(node);
+
   // 输入范围检查...
   if (node && node->type == MXML_TYPE_ELEMENT && node->child && node->child->type == MXML_TYPE_TEXT)
     node = node->child;
@@ -529,10 +571,10 @@ mxmlSetText(mxml_node_t *node,		// 要设置的节点
   }
 
   // 释放任何旧字符串值并设置新值...
-  if ((s = _mxml_strcopy（string）) == NULL)
+  if ((s = _mxml_node_strcopy(node, string)) == NULL)
     return (false);
 
-  _mxml_strfree（node->value.text.string）;
+  _mxml_node_strfree(node, node->value.text.string);
 
   node->value.text.whitespace = whitespace;
   node->value.text.string     = s;
@@ -557,6 +599,9 @@ mxmlSetTextf(mxml_node_t *node,		// 要设置的节点
   char		*s;			// 临时字符串
 
 
+  // 加载元素延迟的内容...
+  MXML_EXPAND(node);
+
   // 输入范围检查...
   if (node && node->type == MXML_TYPE_ELEMENT && node->child && node->child->type == MXML_TYPE_TEXT)
     node = node->child;
@@ -571,10 +616,10 @@ mxmlSetTextf(mxml_node_t *node,		// 要设置的节点
   vsnprintf(buffer, sizeof(buffer), format, ap);
   va_end(ap);
 
-  if ((s = _mxml_strcopy（buffer）) == NULL)
+  if ((s = _mxml_node_strcopy(node, buffer)) == NULL)
     return (false);
 
-  _mxml_strfree（node->value.text.string）;
+  _mxml_node_strfree(node, node->value.text.string);
 
   node->value.text.whitespace = whitespace;
   node->value.text.string     = s;
@@ -0,0 +1,475 @@
+//
+// Mini-XML的流式写入器代码，一个小型的XML文件解析库。
+//
+// https://www.msweet.org/mxml
+//
+// 版权所有 © 2003-2024 Michael R Sweet。
+//
+// 根据Apache许可证v2.0进行许可。更多信息请参见文件“LICENSE”。
+//
+
+#include "mxml-private.h"
+
+
+//
+// 本地类型...
+//
+
+struct _mxml_writer_s			// 流式写入器
+{
+  mxml_options_t	*options,	// 选项
+			*defoptions;	// 默认选项或`NULL`
+  _mxml_write_t		w;		// 输出缓冲区
+  int			fd,		// 文件描述符（写入文件描述符时）
+			col;		// 当前列数，错误时为`-1`
+  bool			open,		// 开始标记（"<name"）是否还没有结束？
+			data;		// 最后写入的是否为数据？
+  size_t		depth,		// 打开的元素数
+			inline_depth;	// 内容保持在一行的元素的级别，0表示没有
+  char			*names;		// 打开的元素名（以空字符分隔）
+  size_t		num_names,	// 元素名使用的字节数
+			alloc_names;	// 元素名分配的字节数
+};
+
+
+//
+// 本地函数...
+//
+
+static bool		mxml_writer_begin(mxml_writer_t *writer, bool data);
+
+
+//
+// 'mxmlWriterAttr（）' - 向当前的开始标记添加属性。
+//
+// 只能在@link mxmlWriterStartElement@之后、写入元素的内容之前调用。属性名和值中的特殊字符被转义，
+// `value`为`NULL`时只写入属性名。
+//
+
+bool					// O - `true`表示成功，`false`表示错误
+mxmlWriterAttr(mxml_writer_t *writer,	// I - 流式写入器
+               const char    *name,	// I - 属性名
+               const char    *value)	// I - 属性值或`NULL`
+{
+  size_t	width;			// 属性+值的宽度
+
+
+  // 范围检查输入...
+  if (!writer || !name || !writer->open || writer->col < 0)
+    return (false);
+
+  width = strlen(name);
+
+  if (value)
+    width += strlen(value) + 3;
+
+  if (writer->options->wrap > 0 && (writer->col + (int)width) > writer->options->wrap)
+    writer->col = _mxml_write_string("\n", &writer->w, /*use_entities*/false, writer->col);
+  else
+    writer->col = _mxml_write_string(" ", &writer->w, /*use_entities*/false, writer->col);
+
+  writer->col = _mxml_write_string(name, &writer->w, /*use_entities*/true, writer->col);
+
+  if (value)
+  {
+    writer->col = _mxml_write_string("=\"", &writer->w, /*use_entities*/false, writer->col);
+    writer->col = _mxml_write_string(value, &writer->w, /*use_entities*/true, writer->col);
+    writer->col = _mxml_write_string("\"", &writer->w, /*use_entities*/false, writer->col);
+  }
+
+  return (writer->col >= 0);
+}
+
+
+//
+// 'mxmlWriterCDATA（）' - 写入CDATA节。
+//
+// CDATA节不能包含"]]>"，因此内容在每个"]]>"的"]]"之后拆分为多个CDATA节，例如"x]]>y"写入为
+// "<![CDATA[x]]]]><![CDATA[>y]]>"，重新加载时得到相同的字符。
+//
+
+bool					// O - `true`表示成功，`false`表示错误
+mxmlWriterCDATA(mxml_writer_t *writer,	// I - 流式写入器
+                const char    *data)	// I - CDATA的内容
+{
+  const char	*end;			// 内容中的"]]>"
+
+
+  // 范围检查输入...
+  if (!writer || !data || !mxml_writer_begin(writer, /*data*/true))
+    return (false);
+
+  writer->col = _mxml_write_string("<![CDATA[", &writer->w, /*use_entities*/false, writer->col);
+
+  while ((end = strstr(data, "]]>")) != NULL && writer->col >= 0)
+  {
+    // 写入"]]"并开始新的CDATA节...
+    writer->col = _mxml_write_nstring(data, (size_t)(end - data) + 2, &writer->w, /*use_entities*/false, writer->col);
+    writer->col = _mxml_write_string("]]><![CDATA[", &writer->w, /*use_entities*/false, writer->col);
+    data        = end + 2;
+  }
+
+  writer->col = _mxml_write_string(data, &writer->w, /*use_entities*/false, writer->col);
+  writer->col = _mxml_write_string("]]>", &writer->w, /*use_entities*/false, writer->col);
+
+  return (writer->col >= 0);
+}
+
+
+//
+// 'mxmlWriterComment（）' - 写入注释。
+//
+
+bool					// O - `true`表示成功，`false`表示错误
+mxmlWriterComment(
+    mxml_writer_t *writer,		// I - 流式写入器
+    const char    *comment)		// I - 注释的内容
+{
+  // 范围检查输入...
+  if (!writer || !comment || !mxml_writer_begin(writer, /*data*/false))
+    return (false);
+
+  writer->col = _mxml_write_string("<!--", &writer->w, /*use_entities*/false, writer->col);
+  writer->col = _mxml_write_string(comment, &writer->w, /*use_entities*/false, writer->col);
+  writer->col = _mxml_write_string("-->", &writer->w, /*use_entities*/false, writer->col);
+
+  return (writer->col >= 0);
+}
+
+
+//
+// 'mxmlWriterDelete（）' - 释放流式写入器。
+//
+// 此函数不写入缓冲的数据，删除写入器之前请使用@link mxmlWriterFlush@写入剩余的输出。
+//
+
+void
+mxmlWriterDelete(mxml_writer_t *writer)	// I - 流式写入器
+{
+  if (!writer)
+    return;
+
+  _mxml_write_free(&writer->w);
+  mxmlOptionsDelete(writer->defoptions);
+
+  free(writer->names);
+  free(writer);
+}
+
+
+//
+// 'mxmlWriterDirective（）' - 写入处理指令。
+//
+// 指令`directive`写入"<?"和"?>"之间，例如`mxmlWriterDirective(writer, "xml version=\"1.0\"")`
+// 写入XML声明。
+//
+
+bool					// O - `true`表示成功，`false`表示错误
+mxmlWriterDirective(
+    mxml_writer_t *writer,		// I - 流式写入器
+    const char    *directive)		// I - 处理指令
+{
+  // 范围检查输入...
+  if (!writer || !directive || !mxml_writer_begin(writer, /*data*/false))
+    return (false);
+
+  writer->col = _mxml_write_string("<?", &writer->w, /*use_entities*/false, writer->col);
+  writer->col = _mxml_write_string(directive, &writer->w, /*use_entities*/false, writer->col);
+  writer->col = _mxml_write_string("?>", &writer->w, /*use_entities*/false, writer->col);
+
+  return (writer->col >= 0);
+}
+
+
+//
+// 'mxmlWriterEndElement（）' - 结束当前元素。
+//
+// 没有内容的元素写入为"<name/>"。
+//
+
+bool					// O - `true`表示成功，`false`表示错误
+mxmlWriterEndElement(
+    mxml_writer_t *writer)		// I - 流式写入器
+{
+  char		*name;			// 当前元素名
+
+
+  // 范围检查输入...
+  if (!writer || !writer->depth || writer->col < 0)
+    return (false);
+
+  // 当前元素名是最后一个以空字符结尾的字符串...
+  for (name = writer->names + writer->num_names - 1; name > writer->names && name[-1]; name --);
+
+  if (writer->open)
+  {
+    writer->col  = _mxml_write_string("/>", &writer->w, /*use_entities*/false, writer->col);
+    writer->open = false;
+  }
+  else
+  {
+    // 缩进时在结束标记之前换行，除非元素的内容保持在一行...
+    if (writer->inline_depth == writer->depth)
+      writer->inline_depth = 0;
+    else if (writer->options->indent != MXML_INDENT_NONE && !writer->inline_depth)
+      writer->col = _mxml_write_indent(writer->options, &writer->w, (int)writer->depth - 1, writer->col);
+
+    writer->col = _mxml_write_string("</", &writer->w, /*use_entities*/false, writer->col);
+    writer->col = _mxml_write_string(name, &writer->w, /*use_entities*/true, writer->col);
+    writer->col = _mxml_write_string(">", &writer->w, /*use_entities*/false, writer->col);
+  }
+
+  writer->num_names = (size_t)(name - writer->names);
+  writer->depth --;
+  writer->data = false;
+
+  return (writer->col >= 0);
+}
+
+
+//
+// 'mxmlWriterFlush（）' - 写入缓冲的输出。
+//
+// 此函数将写入器缓冲的所有数据传递给写回调函数。未结束的开始标记（"<name"和属性）也会写入，
+// 之后的调用继续写入同一个标记。
+//
+
+bool					// O - `true`表示成功，`false`表示错误
+mxmlWriterFlush(mxml_writer_t *writer)	// I - 流式写入器
+{
+  if (!writer || writer->col < 0)
+    return (false);
+
+  if (!_mxml_write_flush(&writer->w))
+    writer->col = -1;
+
+  return (writer->col >= 0);
+}
+
+
+//
+// 'mxmlWriterNew（）' - 创建使用写回调函数的流式写入器。
+//
+// 流式写入器不需要节点树，而是直接将元素、属性和文本写入输出，使用的内存只取决于打开的元素的
+// 名称，与文档的大小无关：
+//
+// ```c
+// mxml_writer_t *writer = mxmlWriterNewFile(options, fp);
+//
+// mxmlWriterDirective(writer, "xml version=\"1.0\" encoding=\"utf-8\"");
+// mxmlWriterStartElement(writer, "report");
+//
+// while (next_row(&row))
+// {
+//   mxmlWriterStartElement(writer, "row");
+//   mxmlWriterAttr(writer, "id", row.id);
+//   mxmlWriterText(writer, false, row.value);
+//   mxmlWriterEndElement(writer);
+// }
+//
+// mxmlWriterEndElement(writer);
+// mxmlWriterFlush(writer);
+// mxmlWriterDelete(writer);
+// ```
+//
+// 转义和换行边距与保存节点树时相同，但是不使用空白回调函数。写入器不能预知元素以后的内容，因此按照
+// `MXML_INDENT_ELEMENTS`缩进（@link mxmlOptionsSetIndent@）时，元素从写入第一个数据开始保持在一行，
+// 之前写入的子元素和注释已经换行缩进：例如"<root><c/>text</root>"的"<c/>"之前有换行和缩进，而保存
+// 节点树时整个"root"元素保持在一行。如果元素在标记之后包含数据，重新加载时缩进的空白字符成为内容的
+// 一部分。只有数据或只有标记的元素的输出与保存节点树时相同。写回调函数与
+// @link mxmlSaveIO@相同，输出先收集到@link mxmlOptionsSetBufferSize@设置的大小的缓冲区中。
+// 写入失败后所有函数都返回`false`。
+//
+// 选项在删除写入器之前必须保持有效。如果为`NULL`，使用默认选项（在列72处换行）。
+//
+
+mxml_writer_t *				// O - 流式写入器或`NULL`（如果内存不足）
+mxmlWriterNew(mxml_options_t *options,	// I - 选项或`NULL`表示默认选项
+              mxml_io_cb_t   io_cb,	// I - 写回调函数
+              void           *io_cbdata)// I - 写回调数据
+{
+  mxml_writer_t	*writer;		// 流式写入器
+
+
+  // 范围检查输入...
+  if (!io_cb)
+    return (NULL);
+
+  if ((writer = calloc(1, sizeof(mxml_writer_t))) == NULL)
+    return (NULL);
+
+  if (!options && (options = writer->defoptions = mxmlOptionsNew()) == NULL)
+  {
+    free(writer);
+    return (NULL);
+  }
+
+  writer->options = options;
+
+  if (!_mxml_write_init(&writer->w, options, io_cb, io_cbdata))
+  {
+    mxmlOptionsDelete(writer->defoptions);
+    free(writer);
+    return (NULL);
+  }
+
+  return (writer);
+}
+
+
+//
+// 'mxmlWriterNewFd（）' - 创建写入文件描述符的流式写入器。
+//
+
+mxml_writer_t *				// O - 流式写入器或`NULL`（如果内存不足）
+mxmlWriterNewFd(mxml_options_t *options,// I - 选项或`NULL`表示默认选项
+                int            fd)	// I - 要写入的文件描述符
+{
+  mxml_writer_t	*writer;		// 流式写入器
+
+
+  if ((writer = mxmlWriterNew(options, (mxml_io_cb_t)_mxml_io_cb_fd, NULL)) != NULL)
+  {
+    writer->fd           = fd;
+    writer->w.io_cbdata  = &writer->fd;
+  }
+
+  return (writer);
+}
+
+
+//
+// 'mxmlWriterNewFile（）' - 创建写入文件指针的流式写入器。
+//
+
+mxml_writer_t *				// O - 流式写入器或`NULL`（如果内存不足）
+mxmlWriterNewFile(
+    mxml_options_t *options,		// I - 选项或`NULL`表示默认选项
+    FILE           *fp)			// I - 要写入的文件
+{
+  // 范围检查输入...
+  if (!fp)
+    return (NULL);
+
+  return (mxmlWriterNew(options, (mxml_io_cb_t)_mxml_io_cb_file, fp));
+}
+
+
+//
+// 'mxmlWriterStartElement（）' - 开始一个元素。
+//
+// 开始标记在写入元素的内容或结束元素之前保持打开，可以使用@link mxmlWriterAttr@添加属性。
+//
+
+bool					// O - `true`表示成功，`false`表示错误
+mxmlWriterStartElement(
+    mxml_writer_t *writer,		// I - 流式写入器
+    const char    *name)		// I - 元素名
+{
+  size_t	namelen;		// 元素名的长度（包括空字符）
+
+
+  // 范围检查输入...
+  if (!writer || !name || !*name || !mxml_writer_begin(writer, /*data*/false))
+    return (false);
+
+  // 保存元素名以便写入结束标记...
+  namelen = strlen(name) + 1;
+
+  if ((writer->num_names + namelen) > writer->alloc_names)
+  {
+    char	*temp;			// 新的元素名缓冲区
+    size_t	alloc = writer->alloc_names ? 2 * writer->alloc_names : 256;
+					// 新的大小
+
+    while (alloc < (writer->num_names + namelen))
+      alloc *= 2;
+
+    if ((temp = realloc(writer->names, alloc)) == NULL)
+    {
+      _mxml_error(writer->options, "无法分配%lu字节的元素名缓冲区。", (unsigned long)alloc);
+      return (false);
+    }
+
+    writer->names       = temp;
+    writer->alloc_names = alloc;
+  }
+
+  memcpy(writer->names + writer->num_names, name, namelen);
+  writer->num_names += namelen;
+  writer->depth ++;
+
+  writer->col  = _mxml_write_string("<", &writer->w, /*use_entities*/false, writer->col);
+  writer->col  = _mxml_write_string(name, &writer->w, /*use_entities*/true, writer->col);
+  writer->open = true;
+
+  return (writer->col >= 0);
+}
+
+
+//
+// 'mxmlWriterText（）' - 写入文本。
+//
+// 文本中的特殊字符被转义。与@link mxmlNewText@相同，`whitespace`为`true`时在文本之前添加空格
+// 分隔符（超过换行边距时为换行符）。
+//
+
+bool					// O - `true`表示成功，`false`表示错误
+mxmlWriterText(mxml_writer_t *writer,	// I - 流式写入器
+               bool          whitespace,// I - 是否在文本之前添加空白字符？
+               const char    *text)	// I - 文本
+{
+  // 范围检查输入...
+  if (!writer || !text || !mxml_writer_begin(writer, /*data*/true))
+    return (false);
+
+  if (whitespace && writer->col > 0)
+  {
+    // 添加空格分隔符...
+    if (writer->options->wrap > 0 && writer->col > writer->options->wrap)
+      writer->col = _mxml_write_string("\n", &writer->w, /*use_entities*/false, writer->col);
+    else
+      writer->col = _mxml_write_string(" ", &writer->w, /*use_entities*/false, writer->col);
+  }
+
+  writer->col = _mxml_write_string(text, &writer->w, /*use_entities*/true, writer->col);
+
+  return (writer->col >= 0);
+}
+
+//
+// 'mxml_writer_begin()' - 准备写入下一个标记或数据。
+//
+// 结束打开的开始标记，并根据缩进方式换行缩进。按照`MXML_INDENT_ELEMENTS`缩进时，写入数据的元素的
+// 其余内容保持在一行。
+//
+
+static bool				// O - `true`表示成功，`false`表示错误
+mxml_writer_begin(mxml_writer_t *writer,// I - 流式写入器
+                  bool          data)	// I - 是否写入数据（而不是标记）？
+{
+  mxml_indent_t	indent = writer->options->indent;
+					// 缩进方式
+
+
+  if (writer->col < 0)
+    return (false);
+
+  if (writer->open)
+  {
+    writer->col  = _mxml_write_string(">", &writer->w, /*use_entities*/false, writer->col);
+    writer->open = false;
+  }
+
+  if (indent != MXML_INDENT_NONE && !writer->inline_depth)
+  {
+    if (!data || (indent == MXML_INDENT_ALL && !writer->data))
+      writer->col = _mxml_write_indent(writer->options, &writer->w, (int)writer->depth, writer->col);
+    else if (indent == MXML_INDENT_ELEMENTS && writer->depth > 0)
+      writer->inline_depth = writer->depth;
+  }
+
+  writer->data = data;
+
+  return (writer->col >= 0);
+}
@@ -53,6 +53,13 @@ typedef enum mxml_descend_e		// @link mxmlFindElement@、@link mxmlWalkNext@ 和
   MXML_DESCEND_ALL = 1			// 查找/遍历时下降到子节点
 } mxml_descend_t;
 
+typedef enum mxml_indent_e		// 保存时的缩进方式
+{
+  MXML_INDENT_NONE,			// 不缩进（默认）
+  MXML_INDENT_ELEMENTS,			// 只在只包含元素的元素中换行缩进，包含文本的元素保持在一行
+  MXML_INDENT_ALL			// 每个子节点或连续的文本都换行缩进
+} mxml_indent_t;
+
 typedef enum mxml_sax_event_e		// SAX 事件类型
 {
   MXML_SAX_EVENT_CDATA,			// CDATA 节点
@@ -95,9 +102,21 @@ typedef struct _mxml_node_s mxml_node_t;// XML节点
 typedef struct _mxml_index_s mxml_index_t;
 					// XML节点索引
 
+typedef struct _mxml_context_s mxml_context_t;
+					// 可重复使用的加载上下文
+
 typedef struct _mxml_options_s mxml_options_t;
 					// XML选项
 
+typedef struct _mxml_parser_s mxml_parser_t;
+					// 推送解析器
+
+typedef struct _mxml_reader_s mxml_reader_t;
+					// 拉取式读取器
+
+typedef struct _mxml_writer_s mxml_writer_t;
+					// 流式写入器
+
 typedef void (*mxml_custfree_cb_t)(void *cbdata, void *custdata);
 					// 自定义数据析构函数
 
@@ -114,6 +133,9 @@ typedef int (*mxml_entity_cb_t)(void *cbdata, const char *name);
 typedef size_t (*mxml_io_cb_t)(void *cbdata, void *buffer, size_t bytes);
 					// 读/写回调函数
 
+typedef bool (*mxml_record_cb_t)(void *cbdata, mxml_node_t *record);
+					// 记录回调函数
+
 typedef bool (*mxml_sax_cb_t)(void *cbdata, mxml_node_t *node, mxml_sax_event_t event);
 					// SAX回调函数
 
@@ -145,6 +167,49 @@ typedef const char *(*mxml_ws_cb_t)(void *cbdata, mxml_node_t *node, mxml_ws_t w
  */
 extern void mxmlAdd(mxml_node_t *parent, mxml_add_t add, mxml_node_t *child, mxml_node_t *node);
 
+/**
+ * @brief 释放加载上下文。
+ *
+ * @param context 加载上下文指针。
+ */
+extern void mxmlContextDelete(mxml_context_t *context);
+
+/**
+ * @brief 使用加载上下文将缓冲区中的数据加载到XML节点树中。
+ *
+ * @param context 加载上下文指针。
+ * @param top 顶级节点指针，如果为NULL，则创建新的顶级节点。
+ * @param buffer 数据缓冲区指针，不需要以空字符结尾。
+ * @param bytes 数据的字节数。
+ * @return 创建的节点树的根节点指针。
+ */
+extern mxml_node_t *mxmlContextLoadBuffer(mxml_context_t *context, mxml_node_t *top, const void *buffer, size_t bytes);
+
+/**
+ * @brief 使用加载上下文将字符串加载到XML节点树中。
+ *
+ * @param context 加载上下文指针。
+ * @param top 顶级节点指针，如果为NULL，则创建新的顶级节点。
+ * @param s 字符串指针。
+ * @return 创建的节点树的根节点指针。
+ */
+extern mxml_node_t *mxmlContextLoadString(mxml_context_t *context, mxml_node_t *top, const char *s);
+
+/**
+ * @brief 创建可重复使用的加载上下文。
+ *
+ * @param options 加载选项指针，如果为NULL，则使用默认选项。
+ * @return 新创建的加载上下文指针，内存不足时返回NULL。
+ */
+extern mxml_context_t *mxmlContextNew(mxml_options_t *options);
+
+/**
+ * @brief 释放加载上下文缓存的内存。
+ *
+ * @param context 加载上下文指针。
+ */
+extern void mxmlContextReset(mxml_context_t *context);
+
 /**
  * @brief 删除节点。
  *
@@ -160,6 +225,15 @@ extern void mxmlDelete(mxml_node_t *node);
  */
 extern void mxmlElementClearAttr(mxml_node_t *node, const char *name);
 
+/**
+ * @brief 加载元素延迟的内容并检查是否有错误。
+ *
+ * @param node 元素指针。
+ * @param descend 是否加载后代元素的内容。
+ * @return 所有的内容都已加载返回true，内容中有错误返回false。
+ */
+extern bool mxmlElementExpand(mxml_node_t *node, mxml_descend_t descend);
+
 /**
  * @brief 获取节点的属性值。
  *
@@ -169,6 +243,15 @@ extern void mxmlElementClearAttr(mxml_node_t *node, const char *name);
  */
 extern const char *mxmlElementGetAttr(mxml_node_t *node, const char *name);
 
+/**
+ * @brief 通过原子获取节点的属性值。
+ *
+ * @param node 节点指针。
+ * @param name 通过mxmlGetAtom获取的属性名称原子。
+ * @return 属性值的指针。
+ */
+extern const char *mxmlElementGetAttrAtom(mxml_node_t *node, const char *name);
+
 /**
  * @brief 通过索引获取节点的属性名称和值。
  *
@@ -220,6 +303,19 @@ extern void mxmlElementSetAttrf(mxml_node_t *node, const char *name, const char
  */
 extern mxml_node_t *mxmlFindElement(mxml_node_t *node, mxml_node_t *top, const char *element, const char *attr, const char *value, mxml_descend_t descend);
 
+/**
+ * @brief 通过原子在给定节点及其子节点中查找具有指定元素、属性和值的节点。
+ *
+ * @param node 起始节点指针。
+ * @param top 顶层节点指针。
+ * @param element 通过mxmlGetAtom获取的元素名称原子。
+ * @param attr 通过mxmlGetAtom获取的属性名称原子。
+ * @param value 要匹配的属性值。
+ * @param descend 是否向下搜索子节点。
+ * @return 找到的节点指针，如果未找到则返回NULL。
+ */
+extern mxml_node_t *mxmlFindElementAtom(mxml_node_t *node, mxml_node_t *top, const char *element, const char *attr, const char *value, mxml_descend_t descend);
+
 /**
  * @brief 在给定节点及其子节点中查找具有指定路径的节点。
  *
@@ -230,6 +326,14 @@ extern mxml_node_t *mxmlFindElement(mxml_node_t *node, mxml_node_t *top, const c
 extern mxml_node_t *mxmlFindPath(mxml_node_t *node, const char *path);
 
 
+/**
+ * @brief 获取名称的原子。
+ *
+ * @param name 元素或属性名称。
+ * @return 名称的原子，相同的名称返回相同的指针，失败或原子表已满时返回NULL。
+ */
+extern const char *mxmlGetAtom(const char *name);
+
 /**
  * @brief 获取节点的CDATA内容。
  *
@@ -429,6 +533,17 @@ extern mxml_node_t *mxmlIndexReset(mxml_index_t *ind);
 
 
 /*****************************************************/
+/**
+ * @brief 原位解析可修改的缓冲区，字符串直接指向缓冲区而不复制。
+ *
+ * @param top 顶级节点。
+ * @param options 选项。
+ * @param buf 要加载的缓冲区，解析时会被修改，在删除节点树之前必须保持有效。
+ * @param len 缓冲区的长度（字节）。
+ * @return 第一个节点，如果数据有错误，则为NULL。
+ */
+extern mxml_node_t *mxmlLoadBufferInSitu(mxml_node_t *top, mxml_options_t *options, char *buf, size_t len);
+
 /**
  * @brief 从文件描述符加载XML数据并创建节点树。
  *
@@ -459,6 +574,17 @@ extern mxml_node_t *mxmlLoadFile(mxml_node_t *top, mxml_options_t *options, FILE
  */
 extern mxml_node_t *mxmlLoadFilename(mxml_node_t *top, mxml_options_t *options, const char *filename);
 
+/**
+ * @brief 使用多个线程从文件名加载XML数据并创建节点树。
+ *
+ * @param top 最顶层节点的指针，如果为NULL，则创建一个新的节点树。
+ * @param options 加载选项指针，如果为NULL，则使用默认选项。
+ * @param filename 文件名。
+ * @param nthreads 线程数，0表示使用处理器的数量。
+ * @return 创建的节点树的根节点指针。
+ */
+extern mxml_node_t *mxmlLoadFilenameParallel(mxml_node_t *top, mxml_options_t *options, const char *filename, int nthreads);
+
 /**
  * @brief 从自定义输入/输出回调函数加载XML数据并创建节点树。
  *
@@ -470,6 +596,19 @@ extern mxml_node_t *mxmlLoadFilename(mxml_node_t *top, mxml_options_t *options,
  */
 extern mxml_node_t *mxmlLoadIO(mxml_node_t *top, mxml_options_t *options, mxml_io_cb_t io_cb, void *io_cbdata);
 
+/**
+ * @brief 使用读取回调函数加载XML数据，并将每个记录元素作为独立的节点树传递给回调函数。
+ *
+ * @param options 加载选项指针，如果为NULL，则使用默认选项。
+ * @param io_cb 读取回调函数。
+ * @param io_cbdata 读取回调函数的数据指针。
+ * @param name 记录元素的名称，NULL表示根元素的每个子元素。
+ * @param record_cb 记录回调函数，返回false时停止加载。
+ * @param record_cbdata 记录回调函数的数据指针。
+ * @return 成功时返回true，出错时返回false。
+ */
+extern bool mxmlLoadRecords(mxml_options_t *options, mxml_io_cb_t io_cb, void *io_cbdata, const char *name, mxml_record_cb_t record_cb, void *record_cbdata);
+
 /**
  * @brief 从字符串加载XML数据并创建节点树。
  *
@@ -481,6 +620,22 @@ extern mxml_node_t *mxmlLoadIO(mxml_node_t *top, mxml_options_t *options, mxml_i
 extern mxml_node_t *mxmlLoadString(mxml_node_t *top, mxml_options_t *options, const char *s);
 
 /*****************************************************/
+/**
+ * @brief 添加加载时保留的元素路径（投影）。
+ *
+ * @param options 选项指针。
+ * @param path 与mxmlFindPath相同语法的元素路径。
+ * @return 成功时返回true，路径无效或内存不足时返回false。
+ */
+extern bool mxmlOptionsAddProjection(mxml_options_t *options, const char *path);
+
+/**
+ * @brief 删除所有的投影路径。
+ *
+ * @param options 选项指针。
+ */
+extern void mxmlOptionsClearProjection(mxml_options_t *options);
+
 /**
  * @brief 删除选项。
  *
@@ -495,6 +650,22 @@ extern void mxmlOptionsDelete(mxml_options_t *options);
  */
 extern mxml_options_t *mxmlOptionsNew(void);
 
+/**
+ * @brief 设置是否从文档内存池中分配节点和字符串。
+ *
+ * @param options 选项指针。
+ * @param arena true表示使用内存池，false表示单独分配。
+ */
+extern void mxmlOptionsSetArena(mxml_options_t *options, bool arena);
+
+/**
+ * @brief 设置读取和写入XML数据时使用的缓冲区大小。
+ *
+ * @param options 选项指针。
+ * @param bytes 缓冲区大小（字节），0表示默认的64k字节。
+ */
+extern void mxmlOptionsSetBufferSize(mxml_options_t *options, size_t bytes);
+
 /**
  * @brief 设置自定义回调函数。
  *
@@ -523,6 +694,39 @@ extern void mxmlOptionsSetEntityCallback(mxml_options_t *options, mxml_entity_cb
  */
 extern void mxmlOptionsSetErrorCallback(mxml_options_t *options, mxml_error_cb_t cb, void *cbdata);
 
+/**
+ * @brief 设置保存时的缩进方式。
+ *
+ * @param options 选项指针。
+ * @param indent 缩进方式。
+ * @param width 每一级缩进的空格数，0表示使用制表符。
+ */
+extern void mxmlOptionsSetIndent(mxml_options_t *options, mxml_indent_t indent, int width);
+
+/**
+ * @brief 设置是否驻留元素和属性名称。
+ *
+ * @param options 选项指针。
+ * @param intern true表示驻留名称，false表示单独复制。
+ */
+extern void mxmlOptionsSetInternNames(mxml_options_t *options, bool intern);
+
+/**
+ * @brief 设置延迟加载内容的元素深度。
+ *
+ * @param options 选项指针。
+ * @param depth 元素深度（根元素为1），0表示加载所有内容。
+ */
+extern void mxmlOptionsSetLazyDepth(mxml_options_t *options, int depth);
+
+/**
+ * @brief 设置每次调用读取回调函数时请求的最大字节数。
+ *
+ * @param options 选项指针。
+ * @param bytes 最大字节数，0表示填满缓冲区，1表示不预读数据。
+ */
+extern void mxmlOptionsSetReadSize(mxml_options_t *options, size_t bytes);
+
 /**
  * @brief 设置SAX回调函数。
  *
@@ -532,6 +736,22 @@ extern void mxmlOptionsSetErrorCallback(mxml_options_t *options, mxml_error_cb_t
  */
 extern void mxmlOptionsSetSAXCallback(mxml_options_t *options, mxml_sax_cb_t cb, void *cbdata);
 
+/**
+ * @brief 设置SAX回调函数是否只接收临时节点，只复制保留的节点。
+ *
+ * @param options 选项指针。
+ * @param transient true表示临时节点，false表示普通节点。
+ */
+extern void mxmlOptionsSetSAXTransient(mxml_options_t *options, bool transient);
+
+/**
+ * @brief 设置文本节点是否包含整段字符数据。
+ *
+ * @param options 选项指针。
+ * @param text_runs true表示每段字符数据一个文本节点，false表示每个单词一个文本节点。
+ */
+extern void mxmlOptionsSetTextRuns(mxml_options_t *options, bool text_runs);
+
 /**
  * @brief 设置类型回调函数。
  *
@@ -566,6 +786,40 @@ extern void mxmlOptionsSetWhitespaceCallback(mxml_options_t *options, mxml_ws_cb
  */
 extern void mxmlOptionsSetWrapMargin(mxml_options_t *options, int column);
 
+/**
+ * @brief 释放推送解析器。
+ *
+ * @param parser 推送解析器指针。
+ */
+extern void mxmlParserDelete(mxml_parser_t *parser);
+
+/**
+ * @brief 向推送解析器提供更多的XML数据。
+ *
+ * @param parser 推送解析器指针。
+ * @param data 数据指针，可以在任意位置拆分。
+ * @param bytes 数据的字节数。
+ * @return 成功返回true，数据有错误返回false。
+ */
+extern bool mxmlParserFeed(mxml_parser_t *parser, const void *data, size_t bytes);
+
+/**
+ * @brief 完成推送解析器的加载。
+ *
+ * @param parser 推送解析器指针。
+ * @return 第一个节点的指针，如果数据有错误则返回NULL。
+ */
+extern mxml_node_t *mxmlParserFinish(mxml_parser_t *parser);
+
+/**
+ * @brief 创建推送解析器。
+ *
+ * @param top 顶级节点指针。
+ * @param options 选项指针。
+ * @return 推送解析器的指针，如果内存不足则返回NULL。
+ */
+extern mxml_parser_t *mxmlParserNew(mxml_node_t *top, mxml_options_t *options);
+
 /*****************************************************/
 /**
  * @brief 在父节点下创建一个包含CDATA的节点。
@@ -730,6 +984,65 @@ extern mxml_node_t *mxmlNewTextf(mxml_node_t *parent, bool whitespace, const cha
 extern mxml_node_t *mxmlNewXML(const char *version);
 
 /*****************************************************/
+/**
+ * @brief 获取拉取式读取器当前元素的属性值。
+ *
+ * @param reader 拉取式读取器指针。
+ * @param name 属性名。
+ * @return 属性值，如果当前令牌不是开放标签或没有该属性则返回NULL。
+ */
+extern const char *mxmlReaderAttr(mxml_reader_t *reader, const char *name);
+
+/**
+ * @brief 释放拉取式读取器。
+ *
+ * @param reader 拉取式读取器指针。
+ */
+extern void mxmlReaderDelete(mxml_reader_t *reader);
+
+/**
+ * @brief 获取拉取式读取器当前元素的名称。
+ *
+ * @param reader 拉取式读取器指针。
+ * @return 元素名，如果当前令牌不是开放或闭合标签则返回NULL。
+ */
+extern const char *mxmlReaderName(mxml_reader_t *reader);
+
+/**
+ * @brief 创建不构建节点树的拉取式读取器。
+ *
+ * @param options 选项指针，如果为NULL，则使用默认选项。
+ * @param buffer 要读取的缓冲区，读取时会被修改，返回的字符串直接指向缓冲区。
+ * @param bytes 缓冲区的长度（字节）。
+ * @return 拉取式读取器的指针，如果内存不足或数据有错误则返回NULL。
+ */
+extern mxml_reader_t *mxmlReaderNew(mxml_options_t *options, char *buffer, size_t bytes);
+
+/**
+ * @brief 读取下一个令牌。
+ *
+ * @param reader 拉取式读取器指针。
+ * @param event 返回令牌的事件类型，可以为NULL。
+ * @return 读取了令牌返回true，数据结尾或有错误返回false。
+ */
+extern bool mxmlReaderNext(mxml_reader_t *reader, mxml_sax_event_t *event);
+
+/**
+ * @brief 跳过当前元素的子节点和闭合标签。
+ *
+ * @param reader 拉取式读取器指针。
+ * @return 成功返回true，数据有错误或当前令牌不是开放标签返回false。
+ */
+extern bool mxmlReaderSkipSubtree(mxml_reader_t *reader);
+
+/**
+ * @brief 获取拉取式读取器当前令牌的文本。
+ *
+ * @param reader 拉取式读取器指针。
+ * @return 字符数据、CDATA、注释、处理指令或声明的内容，元素事件返回NULL。
+ */
+extern const char *mxmlReaderText(mxml_reader_t *reader);
+
 /**
  * @brief 释放节点的内存。
  *
@@ -745,6 +1058,11 @@ extern int mxmlRelease(mxml_node_t *node);
  */
 extern void mxmlRemove(mxml_node_t *node);
 
+/**
+ * @brief 释放所有原子（不能存在驻留名称的节点）。
+ */
+extern void mxmlResetAtoms(void);
+
 /**
  * @brief 增加节点的引用计数。
  *
@@ -763,6 +1081,16 @@ extern int mxmlRetain(mxml_node_t *node);
  */
 extern char *mxmlSaveAllocString(mxml_node_t *node, mxml_options_t *options);
 
+/**
+ * @brief 将节点保存为预先分配了指定容量的动态分配字符串。
+ *
+ * @param node 节点指针。
+ * @param options 保存选项指针。
+ * @param bytes 预先分配的字节数，0表示默认值。
+ * @return 分配的字符串指针，保存失败返回NULL。
+ */
+extern char *mxmlSaveAllocStringReserve(mxml_node_t *node, mxml_options_t *options, size_t bytes);
+
 /**
  * @brief 将节点保存到文件描述符。
  *
@@ -804,14 +1132,35 @@ extern bool mxmlSaveFilename(mxml_node_t *node, mxml_options_t *options, const c
  */
 extern bool mxmlSaveIO(mxml_node_t *node, mxml_options_t *options, mxml_io_cb_t io_cb, void *io_cbdata);
 
+/**
+ * @brief 计算保存节点需要的字节数。
+ *
+ * @param node 节点指针。
+ * @param options 保存选项指针。
+ * @return 输出的字节数（不包括结尾的空字符），保存失败返回0。
+ */
+extern size_t mxmlSaveMeasure(mxml_node_t *node, mxml_options_t *options);
+
+/**
+ * @brief 使用多个线程保存节点，按照顺序调用写回调函数。
+ *
+ * @param node 节点指针。
+ * @param options 保存选项指针。
+ * @param io_cb 写回调函数（只在调用者的线程中调用）。
+ * @param io_cbdata 写回调函数的数据指针。
+ * @param nthreads 线程数，0表示处理器的数量。
+ * @return 保存成功返回true，否则返回false。
+ */
+extern bool mxmlSaveParallel(mxml_node_t *node, mxml_options_t *options, mxml_io_cb_t io_cb, void *io_cbdata, int nthreads);
+
 /**
  * @brief 将节点保存到指定的字符串缓冲区。
  *
  * @param node 节点指针。
  * @param options 保存选项指针。
- * @param buffer 字符串缓冲区。
+ * @param buffer 字符串缓冲区，bufsize为0时可以为NULL。
  * @param bufsize 缓冲区大小。
- * @return 实际保存的字符数，保存失败返回0。
+ * @return 完整的输出的字符数（与snprintf相同，大于或等于bufsize表示输出被截断），保存失败返回0。
  */
 extern size_t mxmlSaveString(mxml_node_t *node, mxml_options_t *options, char *buffer, size_t bufsize);
 
@@ -1000,6 +1349,113 @@ extern mxml_node_t *mxmlWalkNext(mxml_node_t *node, mxml_node_t *top, mxml_desce
  */
 extern mxml_node_t *mxmlWalkPrev(mxml_node_t *node, mxml_node_t *top, mxml_descend_t descend);
 
+/**
+ * @brief 向当前的开始标记添加属性。
+ *
+ * @param writer 流式写入器。
+ * @param name 属性名。
+ * @param value 属性值，NULL表示只写入属性名。
+ * @return 成功返回true，否则返回false。
+ */
+extern bool mxmlWriterAttr(mxml_writer_t *writer, const char *name, const char *value);
+
+/**
+ * @brief 写入CDATA节（包含"]]>"的内容拆分为多个CDATA节）。
+ *
+ * @param writer 流式写入器。
+ * @param data CDATA的内容。
+ * @return 成功返回true，否则返回false。
+ */
+extern bool mxmlWriterCDATA(mxml_writer_t *writer, const char *data);
+
+/**
+ * @brief 写入注释。
+ *
+ * @param writer 流式写入器。
+ * @param comment 注释的内容。
+ * @return 成功返回true，否则返回false。
+ */
+extern bool mxmlWriterComment(mxml_writer_t *writer, const char *comment);
+
+/**
+ * @brief 释放流式写入器（不写入缓冲的数据）。
+ *
+ * @param writer 流式写入器。
+ */
+extern void mxmlWriterDelete(mxml_writer_t *writer);
+
+/**
+ * @brief 写入处理指令。
+ *
+ * @param writer 流式写入器。
+ * @param directive 处理指令，不包括"<?"和"?>"。
+ * @return 成功返回true，否则返回false。
+ */
+extern bool mxmlWriterDirective(mxml_writer_t *writer, const char *directive);
+
+/**
+ * @brief 结束当前元素。
+ *
+ * @param writer 流式写入器。
+ * @return 成功返回true，否则返回false。
+ */
+extern bool mxmlWriterEndElement(mxml_writer_t *writer);
+
+/**
+ * @brief 写入缓冲的输出。
+ *
+ * @param writer 流式写入器。
+ * @return 成功返回true，否则返回false。
+ */
+extern bool mxmlWriterFlush(mxml_writer_t *writer);
+
+/**
+ * @brief 创建使用写回调函数的流式写入器。
+ *
+ * @param options 选项，NULL表示默认选项。
+ * @param io_cb 写回调函数。
+ * @param io_cbdata 写回调数据。
+ * @return 流式写入器，如果内存不足则返回NULL。
+ */
+extern mxml_writer_t *mxmlWriterNew(mxml_options_t *options, mxml_io_cb_t io_cb, void *io_cbdata);
+
+/**
+ * @brief 创建写入文件描述符的流式写入器。
+ *
+ * @param options 选项，NULL表示默认选项。
+ * @param fd 文件描述符。
+ * @return 流式写入器，如果内存不足则返回NULL。
+ */
+extern mxml_writer_t *mxmlWriterNewFd(mxml_options_t *options, int fd);
+
+/**
+ * @brief 创建写入文件指针的流式写入器。
+ *
+ * @param options 选项，NULL表示默认选项。
+ * @param fp 文件指针。
+ * @return 流式写入器，如果内存不足则返回NULL。
+ */
+extern mxml_writer_t *mxmlWriterNewFile(mxml_options_t *options, FILE *fp);
+
+/**
+ * @brief 开始一个元素。
+ *
+ * @param writer 流式写入器。
+ * @param name 元素名。
+ * @return 成功返回true，否则返回false。
+ */
+extern bool mxmlWriterStartElement(mxml_writer_t *writer, const char *name);
+
+/**
+ * @brief 写入文本。
+ *
+ * @param writer 流式写入器。
+ * @param whitespace 是否在文本之前添加空白字符。
+ * @param text 文本。
+ * @return 成功返回true，否则返回false。
+ */
+extern bool mxmlWriterText(mxml_writer_t *writer, bool whitespace, const char *text);
+
 
 
 #  ifdef __cplusplus
@@ -19,6 +19,9 @@
 #ifndef _WIN32
 #  include <unistd.h>
 #endif // !_WIN32
+#ifdef __GLIBC__
+#  include <malloc.h>
+#endif // __GLIBC__
 #include <fcntl.h>
 #ifndef O_BINARY
 #  define O_BINARY 0
@@ -36,9 +39,14 @@ int		event_counts[7];
 // Local functions...
 //
 
+size_t		read_cb(void *cbdata, void *buffer, size_t bytes);
+bool		record_cb(void *cbdata, mxml_node_t *record);
 bool		sax_cb(void *cbdata, mxml_node_t *node, mxml_sax_event_t event);
+bool		sax_keep_cb(void *cbdata, mxml_node_t *node, mxml_sax_event_t event);
 mxml_type_t	type_cb(void *cbdata, mxml_node_t *node);
+char		*utf16_copy(const char *s, bool big_endian, size_t *bytes);
 const char	*whitespace_cb(void *cbdata, mxml_node_t *node, mxml_ws_t where);
+size_t		write_cb(void *cbdata, void *buffer, size_t bytes);
 
 
 //
@@ -52,13 +60,25 @@ main(int  argc,				// I - Number of command-line args
   int			i;		// Looping var
   FILE			*fp;		// File to read
   int			fd;		// File descriptor
+  int			count;		// Number of records
+  size_t		bytes;		// Number of bytes
   mxml_options_t	*options;	// Load/save options
   mxml_node_t		*xml,		// <?xml ...?> node
 			*tree,		// Element tree
 			*node;		// Node which should be in test.xml
   mxml_index_t		*ind;		// XML index
+  mxml_context_t	*context;	// Load context
+  mxml_parser_t		*parser;	// Push parser
+  mxml_reader_t		*reader;	// Pull reader
+  mxml_writer_t		*writer;	// Streaming writer
+  mxml_sax_event_t	event;		// Pull reader event
   char			buffer[16384];	// Save string
+  char			*data,		// Large CDATA value
+			*saved,		// Allocated save string
+			*output;	// Write callback position
+  char			trace[1024];	// Pull reader events
   const char		*text;		// Text string
+  const char		*ptr;		// Pointer into string
   bool			whitespace;	// Whitespace before text string
   static const char	*types[] =	// Strings for node types
 			{
@@ -73,6 +93,12 @@ main(int  argc,				// I - Number of command-line args
 			  "MXML_TYPE_TEXT",
 			  "MXML_TYPE_CUSTOM"
 			};
+  static const char	*lazy_bad[] =	// Malformed deferred content
+			{
+			  "<a><b>&bogus;</b></a>",
+			  "<a><b><d c=\"1\" c=\"2\"/></b></a>",
+			  "<a><b><c></d></b></a>"
+			};
 
 
   // Check arguments...
@@ -435,207 +461,1614 @@ main(int  argc,				// I - Number of command-line args
 
   mxmlDelete(xml);
 
-  // Open the file/string using the default callback...
+  // Test in-situ parsing of a mutable buffer...
+  snprintf(buffer, sizeof(buffer), "<group type=\"a&amp;b\">one &lt;two&gt;</group>");
+  mxmlOptionsSetTypeValue(options, MXML_TYPE_OPAQUE);
+
+  if ((tree = mxmlLoadBufferInSitu(/*top*/NULL, options, buffer, strlen(buffer))) == NULL)
+  {
+    fputs("ERROR: Unable to load in-situ buffer.\n", stderr);
+    return (1);
+  }
+
+  if ((text = mxmlElementGetAttr(tree, "type")) == NULL || strcmp(text, "a&b") || text < buffer || text >= (buffer + sizeof(buffer)))
+  {
+    fprintf(stderr, "ERROR: In-situ attribute value is \"%s\", expected \"a&b\" in the buffer.\n", text ? text : "(null)");
+    return (1);
+  }
+
+  if ((text = mxmlGetOpaque(mxmlGetFirstChild(tree))) == NULL || strcmp(text, "one <two>") || text < buffer || text >= (buffer + sizeof(buffer)))
+  {
+    fprintf(stderr, "ERROR: In-situ value is \"%s\", expected \"one <two>\" in the buffer.\n", text ? text : "(null)");
+    return (1);
+  }
+
+  mxmlDelete(tree);
+
+  // Test loading into a document arena...
+  mxmlOptionsSetArena(options, true);
+
+  if ((tree = mxmlLoadString(/*top*/NULL, options, "<group type=\"a&amp;b\">one &lt;two&gt;</group>")) == NULL)
+  {
+    fputs("ERROR: Unable to load string into arena.\n", stderr);
+    return (1);
+  }
+
+  mxmlOptionsSetArena(options, false);
+
+  for (i = 0; i < 9; i ++)
+  {
+    snprintf(buffer, sizeof(buffer), "attr%d", i);
+    mxmlElementSetAttrf(tree, buffer, "%d", i);
+  }
+
+  for (i = 0; i < 9; i ++)
+  {
+    snprintf(buffer, sizeof(buffer), "attr%d", i);
+    mxmlElementClearAttr(tree, buffer);
+  }
+
+  mxmlElementSetAttr(tree, "last", "yes");
+  mxmlNewOpaque(tree, " three");
+
+  mxmlSaveString(tree, options, buffer, sizeof(buffer));
+
+  if (strcmp(buffer, "<group type=\"a&amp;b\" last=\"yes\">one &lt;two&gt; three</group>"))
+  {
+    fprintf(stderr, "ERROR: Arena tree is \"%s\", expected \"<group type=\"a&amp;b\" last=\"yes\">one &lt;two&gt; three</group>\".\n", buffer);
+    return (1);
+  }
+
+  mxmlDelete(tree);
+
+  // Test interned element and attribute names...
+  mxmlOptionsSetInternNames(options, true);
+
+  if ((tree = mxmlLoadString(/*top*/NULL, options, "<group><item id=\"1\"/><item id=\"2\"/></group>")) == NULL)
+  {
+    fputs("ERROR: Unable to load string with interned names.\n", stderr);
+    return (1);
+  }
+
+  mxmlOptionsSetInternNames(options, false);
+
+  if ((node = mxmlFindElementAtom(tree, tree, mxmlGetAtom("item"), mxmlGetAtom("id"), "2", MXML_DESCEND_FIRST)) == NULL)
+  {
+    fputs("ERROR: Unable to find interned item element.\n", stderr);
+    return (1);
+  }
+
+  if (mxmlGetElement(node) != mxmlGetAtom("item") || mxmlGetElement(mxmlGetFirstChild(tree)) != mxmlGetElement(node))
+  {
+    fputs("ERROR: Element names are not interned.\n", stderr);
+    return (1);
+  }
+
+  if ((text = mxmlElementGetAttrAtom(node, mxmlGetAtom("id"))) == NULL || strcmp(text, "2"))
+  {
+    fprintf(stderr, "ERROR: Interned id attribute is \"%s\", expected \"2\".\n", text ? text : "(null)");
+    return (1);
+  }
+
+  mxmlDelete(tree);
+
+  // Test filling the atom table, loading new names into a full table and resetting it...
+  mxmlResetAtoms();
+
+  for (i = 0; i < 1000000; i ++)
+  {
+    snprintf(buffer, sizeof(buffer), "name%d", i);
+    if (!mxmlGetAtom(buffer))
+      break;
+  }
+
+  if (i == 0 || i >= 1000000 || !mxmlGetAtom("name0"))
+  {
+    fprintf(stderr, "ERROR: Atom table stopped growing after %d names.\n", i);
+    return (1);
+  }
+
+  mxmlOptionsSetInternNames(options, true);
+
+  if ((tree = mxmlLoadString(/*top*/NULL, options, "<group><item id=\"1\"/><name1 id=\"2\"/></group>")) == NULL)
+  {
+    fputs("ERROR: Unable to load string with interned names into a full atom table.\n", stderr);
+    return (1);
+  }
+
+  mxmlOptionsSetInternNames(options, false);
+
+  if (!mxmlFindElement(tree, tree, "item", "id", "1", MXML_DESCEND_FIRST) || (node = mxmlFindElementAtom(tree, tree, mxmlGetAtom("name1"), NULL, NULL, MXML_DESCEND_FIRST)) == NULL || mxmlGetElement(node) != mxmlGetAtom("name1") || (text = mxmlElementGetAttr(node, "id")) == NULL || strcmp(text, "2"))
+  {
+    fputs("ERROR: Unable to find elements in a full atom table.\n", stderr);
+    return (1);
+  }
+
+  mxmlSetElement(node, "renamed");
+  mxmlDelete(tree);
+  mxmlResetAtoms();
+
+  if (!mxmlGetAtom("item") || mxmlGetAtom("item") != mxmlGetAtom("item"))
+  {
+    fputs("ERROR: Unable to get atoms after resetting the atom table.\n", stderr);
+    return (1);
+  }
+
+  // Test loading whole runs of text...
   mxmlOptionsSetTypeValue(options, MXML_TYPE_TEXT);
+  mxmlOptionsSetTextRuns(options, true);
 
-  if (argv[1][0] == '<')
-    xml = mxmlLoadString(/*top*/NULL, options, argv[1]);
-  else
-    xml = mxmlLoadFilename(/*top*/NULL, options, argv[1]);
+  if ((tree = mxmlLoadString(/*top*/NULL, options, "<p> one  two\n three &amp; four <b>five</b></p>")) == NULL)
+  {
+    fputs("ERROR: Unable to load string with text runs.\n", stderr);
+    return (1);
+  }
 
-  if (!xml)
+  mxmlOptionsSetTextRuns(options, false);
+
+  if ((text = mxmlGetText(mxmlGetFirstChild(tree), &whitespace)) == NULL || strcmp(text, " one  two\n three & four ") || whitespace || mxmlGetType(mxmlGetNextSibling(mxmlGetFirstChild(tree))) != MXML_TYPE_ELEMENT)
   {
-    fputs("Unable to read XML file with default callback.\n", stderr);
+    fprintf(stderr, "ERROR: Text run is \"%s\", expected \" one  two\\n three & four \".\n", text ? text : "(null)");
     return (1);
   }
 
-  if (!strcmp(argv[1], "test.xml"))
+  mxmlSaveString(tree, options, buffer, sizeof(buffer));
+
+  if (strcmp(buffer, "<p> one  two\n three &amp; four <b>five</b></p>"))
   {
-    // Verify that mxmlFindElement() and indirectly mxmlWalkNext() work properly...
-    if ((node = mxmlFindPath(xml, "group/option/keyword")) == NULL)
-    {
-      fputs("Unable to find group/option/keyword element in XML tree.\n", stderr);
-      mxmlDelete(tree);
-      return (1);
-    }
+    fprintf(stderr, "ERROR: Text run tree is \"%s\", expected \"<p> one  two\\n three &amp; four <b>five</b></p>\".\n", buffer);
+    return (1);
+  }
 
-    if (mxmlGetType(node) != MXML_TYPE_TEXT)
-    {
-      fputs("No child node of group/option/keyword.\n", stderr);
-      mxmlSaveFile(xml, options, stderr);
-      mxmlDelete(xml);
-      return (1);
-    }
+  mxmlDelete(tree);
 
-    if ((text = mxmlGetText(node, NULL)) == NULL || strcmp(text, "InputSlot"))
+  // Test feeding the push parser one byte at a time...
+  if ((parser = mxmlParserNew(/*top*/NULL, options)) == NULL)
+  {
+    fputs("ERROR: Unable to create push parser.\n", stderr);
+    return (1);
+  }
+
+  for (text = "<?xml version=\"1.0\"?><group a=\"x>y\"><!-- c -> --><![CDATA[<]]]]><v>caf\xc3\xa9 &amp; more</v></group>"; *text; text ++)
+  {
+    if (!mxmlParserFeed(parser, text, 1))
     {
-      fprintf(stderr, "Child node of group/option/value has value \"%s\" instead of \"InputSlot\".\n", text ? text : "(null)");
-      mxmlDelete(xml);
+      fprintf(stderr, "ERROR: Push parser failed before \"%s\".\n", text);
       return (1);
     }
   }
 
-  mxmlDelete(xml);
+  if ((tree = mxmlParserFinish(parser)) == NULL)
+  {
+    fputs("ERROR: Unable to finish push parser.\n", stderr);
+    return (1);
+  }
 
-  // Open the file...
-  mxmlOptionsSetTypeCallback(options, type_cb, /*cbdata*/NULL);
+  mxmlParserDelete(parser);
 
-  if (argv[1][0] == '<')
-    xml = mxmlLoadString(/*top*/NULL, options, argv[1]);
-  else
-    xml = mxmlLoadFilename(/*top*/NULL, options, argv[1]);
+  mxmlSaveString(tree, options, buffer, sizeof(buffer));
 
-  if (!xml)
+  if (strcmp(buffer, "<?xml version=\"1.0\"?><group a=\"x&gt;y\"><!-- c -> --><![CDATA[<]]]]><v>caf\xc3\xa9 &amp;\nmore</v></group>"))
   {
-    fputs("Unable to read XML file.\n", stderr);
+    fprintf(stderr, "ERROR: Push parser tree is \"%s\".\n", buffer);
     return (1);
   }
 
-  if (!strcmp(argv[1], "test.xml"))
+  mxmlDelete(tree);
+
+  // Test closing one element and opening another after a chunk boundary...
+  if ((parser = mxmlParserNew(/*top*/NULL, options)) == NULL || !mxmlParserFeed(parser, "<a><b>", 6) || !mxmlParserFeed(parser, "</b><c>x</c></a>", 16) || (tree = mxmlParserFinish(parser)) == NULL)
   {
-    // Verify that mxmlFindElement() and indirectly mxmlWalkNext() work properly...
-    if ((node = mxmlFindElement(xml, xml, "choice", NULL, NULL, MXML_DESCEND_ALL)) == NULL)
-    {
-      fputs("Unable to find first <choice> element in XML tree.\n", stderr);
-      mxmlDelete(tree);
-      return (1);
-    }
+    fputs("ERROR: Unable to feed push parser in two chunks.\n", stderr);
+    return (1);
+  }
 
-    if (!mxmlFindElement(node, xml, "choice", NULL, NULL, MXML_DESCEND_NONE))
-    {
-      fputs("Unable to find second <choice> element in XML tree.\n", stderr);
-      mxmlDelete(tree);
-      return (1);
-    }
+  mxmlParserDelete(parser);
+
+  mxmlSaveString(tree, options, buffer, sizeof(buffer));
+
+  if (strcmp(buffer, "<a><b/><c>x</c></a>"))
+  {
+    fprintf(stderr, "ERROR: Two chunk push parser tree is \"%s\".\n", buffer);
+    return (1);
   }
 
-  // Print the XML tree...
-  mxmlOptionsSetWhitespaceCallback(options, whitespace_cb, /*cbdata*/NULL);
-  mxmlSaveFile(xml, options, stdout);
+  mxmlDelete(tree);
 
-  // Save the XML tree to a string and print it...
-  if (mxmlSaveString(xml, options, buffer, sizeof(buffer)) > 0)
+  // Test quotes inside unquoted attribute names and values in 1, 5 and 9 byte chunks...
+  text = "<a><code t\"pe=\"a>b\"/><v type=aque\"/>x</a>";
+
+  if ((tree = mxmlLoadString(/*top*/NULL, options, text)) == NULL)
   {
-    if (argc == 3)
-    {
-      fp = fopen(argv[2], "w");
-      fputs(buffer, fp);
-      fclose(fp);
-    }
+    fputs("ERROR: Unable to load string with quotes in unquoted attributes.\n", stderr);
+    return (1);
   }
 
-  // Delete the tree...
-  mxmlDelete(xml);
+  mxmlSaveString(tree, options, trace, sizeof(trace));
+  mxmlDelete(tree);
 
-  // Read from/write to file descriptors...
-  if (argv[1][0] != '<')
+  for (count = 1; count < 10; count += 4)
   {
-    // Open the file again...
-    if ((fd = open(argv[1], O_RDONLY | O_BINARY)) < 0)
+    if ((parser = mxmlParserNew(/*top*/NULL, options)) == NULL)
     {
-      perror(argv[1]);
+      fputs("ERROR: Unable to create push parser.\n", stderr);
       return (1);
     }
 
-    // Read the file...
-    xml = mxmlLoadFd(/*top*/NULL, options, fd);
-
-    close(fd);
-
-    // Create filename.xmlfd...
-    snprintf(buffer, sizeof(buffer), "%sfd", argv[1]);
+    for (ptr = text; *ptr; ptr += i)
+    {
+      if ((i = count) > (int)strlen(ptr))
+        i = (int)strlen(ptr);
+
+      if (!mxmlParserFeed(parser, ptr, (size_t)i))
+      {
+	fprintf(stderr, "ERROR: Push parser failed on quotes in unquoted attributes at offset %d with %d byte chunks.\n", (int)(ptr - text), count);
+	return (1);
+      }
+    }
 
-    if ((fd = open(buffer, O_WRONLY | O_CREAT | O_TRUNC | O_BINARY, 0666)) < 0)
+    if ((tree = mxmlParserFinish(parser)) == NULL)
     {
-      perror(buffer);
-      mxmlDelete(tree);
+      fprintf(stderr, "ERROR: Unable to finish push parser with %d byte chunks.\n", count);
       return (1);
     }
 
-    // Write the file...
-    mxmlSaveFd(xml, options, fd);
+    mxmlParserDelete(parser);
 
-    close(fd);
+    mxmlSaveString(tree, options, buffer, sizeof(buffer));
+    mxmlDelete(tree);
 
-    // Delete the tree...
-    mxmlDelete(xml);
+    if (strcmp(buffer, trace))
+    {
+      fprintf(stderr, "ERROR: Push parser with %d byte chunks saved \"%s\", expected \"%s\".\n", count, buffer, trace);
+      return (1);
+    }
   }
 
-  // Test SAX methods...
-  memset(event_counts, 0, sizeof(event_counts));
-
-  mxmlOptionsSetSAXCallback(options, sax_cb, /*cbdata*/NULL);
-
+  // Test feeding the push parser the test file in random chunks of 1 to 200 bytes...
   if (argv[1][0] == '<')
-    mxmlRelease(mxmlLoadString(/*top*/NULL, options, argv[1]));
+  {
+    snprintf(buffer, sizeof(buffer), "%s", argv[1]);
+  }
+  else if ((fp = fopen(argv[1], "rb")) != NULL)
+  {
+    buffer[fread(buffer, 1, sizeof(buffer) - 1, fp)] = '\0';
+    fclose(fp);
+  }
   else
-    mxmlRelease(mxmlLoadFilename(/*top*/NULL, options, argv[1]));
+  {
+    perror(argv[1]);
+    return (1);
+  }
 
-  if (!strcmp(argv[1], "test.xml"))
+  if ((tree = mxmlLoadString(/*top*/NULL, options, buffer)) == NULL || (saved = mxmlSaveAllocString(tree, options)) == NULL)
   {
-    if (event_counts[MXML_SAX_EVENT_CDATA] != 1)
+    fprintf(stderr, "ERROR: Unable to load \"%s\" for the push parser.\n", argv[1]);
+    return (1);
+  }
+
+  mxmlDelete(tree);
+
+  srand(1);
+
+  for (count = 0; count < 20; count ++)
+  {
+    if ((parser = mxmlParserNew(/*top*/NULL, options)) == NULL)
     {
-      fprintf(stderr, "MXML_SAX_EVENT_CDATA seen %d times, expected 1 times.\n", event_counts[MXML_SAX_EVENT_CDATA]);
+      fputs("ERROR: Unable to create push parser.\n", stderr);
       return (1);
     }
 
-    if (event_counts[MXML_SAX_EVENT_COMMENT] != 1)
+    for (ptr = buffer; *ptr; ptr += i)
     {
-      fprintf(stderr, "MXML_SAX_EVENT_COMMENT seen %d times, expected 1 times.\n", event_counts[MXML_SAX_EVENT_COMMENT]);
-      return (1);
+      if ((i = 1 + rand() % 200) > (int)strlen(ptr))
+        i = (int)strlen(ptr);
+
+      if (!mxmlParserFeed(parser, ptr, (size_t)i))
+      {
+	fprintf(stderr, "ERROR: Push parser failed at offset %d.\n", (int)(ptr - buffer));
+	return (1);
+      }
     }
 
-    if (event_counts[MXML_SAX_EVENT_DATA] != 61)
+    if ((tree = mxmlParserFinish(parser)) == NULL || (data = mxmlSaveAllocString(tree, options)) == NULL)
     {
-      fprintf(stderr, "MXML_SAX_EVENT_DATA seen %d times, expected 61 times.\n", event_counts[MXML_SAX_EVENT_DATA]);
+      fputs("ERROR: Unable to finish chunked push parser.\n", stderr);
       return (1);
     }
 
-    if (event_counts[MXML_SAX_EVENT_DECLARATION] != 0)
+    mxmlParserDelete(parser);
+
+    if (strcmp(data, saved))
     {
-      fprintf(stderr, "MXML_SAX_EVENT_DECLARATION seen %d times, expected 0 times.\n", event_counts[MXML_SAX_EVENT_DECLARATION]);
+      fprintf(stderr, "ERROR: Chunked push parser tree is \"%s\", expected \"%s\".\n", data, saved);
       return (1);
     }
 
-    if (event_counts[MXML_SAX_EVENT_DIRECTIVE] != 1)
+    free(data);
+    mxmlDelete(tree);
+  }
+
+  // Test loading UTF-16LE and UTF-16BE copies of the test file from a file with a 17 byte buffer, a mapped
+  // file, the push parser and memory...
+  for (i = 0; i < 4; i ++)
+  {
+    if ((data = utf16_copy(buffer, i > 1, &bytes)) == NULL)
     {
-      fprintf(stderr, "MXML_SAX_EVENT_DIRECTIVE seen %d times, expected 1 times.\n", event_counts[MXML_SAX_EVENT_DIRECTIVE]);
+      fputs("ERROR: Unable to convert test file to UTF-16.\n", stderr);
       return (1);
     }
 
-    if (event_counts[MXML_SAX_EVENT_ELEMENT_CLOSE] != 20)
+    if ((fp = fopen("temp5.xml", "wb")) == NULL || fwrite(data, 1, bytes, fp) != bytes)
     {
-      fprintf(stderr, "MXML_SAX_EVENT_ELEMENT_CLOSE seen %d times, expected 20 times.\n", event_counts[MXML_SAX_EVENT_ELEMENT_CLOSE]);
+      perror("Unable to create temp5.xml");
       return (1);
     }
 
-    if (event_counts[MXML_SAX_EVENT_ELEMENT_OPEN] != 20)
+    fclose(fp);
+
+    for (count = 0; count < 4; count ++)
     {
-      fprintf(stderr, "MXML_SAX_EVENT_ELEMENT_OPEN seen %d times, expected 20 times.\n", event_counts[MXML_SAX_EVENT_ELEMENT_OPEN]);
-      return (1);
+      if (count == 0)
+      {
+        // File with a 17 byte buffer, so characters straddle reads...
+	mxmlOptionsSetBufferSize(options, 17);
+	mxmlOptionsSetReadSize(options, (i & 1) ? 5 : 0);
+
+	if ((fp = fopen("temp5.xml", "rb")) == NULL)
+	{
+	  perror("temp5.xml");
+	  return (1);
+	}
+
+	tree = mxmlLoadFile(/*top*/NULL, options, fp);
+	fclose(fp);
+
+	mxmlOptionsSetBufferSize(options, 0);
+	mxmlOptionsSetReadSize(options, 0);
+      }
+      else if (count == 1)
+      {
+        // Mapped file...
+        tree = mxmlLoadFilename(/*top*/NULL, options, "temp5.xml");
+      }
+      else if (count == 2)
+      {
+        // Push parser with odd and even chunk sizes...
+        size_t	chunk;			// Chunk size
+
+	if ((parser = mxmlParserNew(/*top*/NULL, options)) == NULL)
+	{
+	  fputs("ERROR: Unable to create push parser.\n", stderr);
+	  return (1);
+	}
+
+	for (ptr = data; ptr < (data + bytes); ptr += chunk)
+	{
+	  if ((chunk = 1 + (size_t)(rand() % 200)) > (size_t)(data + bytes - ptr))
+	    chunk = (size_t)(data + bytes - ptr);
+
+	  if (!mxmlParserFeed(parser, ptr, chunk))
+	  {
+	    fprintf(stderr, "ERROR: Push parser failed on UTF-16 data at offset %d.\n", (int)(ptr - data));
+	    return (1);
+	  }
+	}
+
+	tree = mxmlParserFinish(parser);
+	mxmlParserDelete(parser);
+      }
+      else
+      {
+        // Memory...
+        tree = mxmlLoadBufferInSitu(/*top*/NULL, options, data, bytes);
+      }
+
+      if (!tree || (output = mxmlSaveAllocString(tree, options)) == NULL)
+      {
+	fprintf(stderr, "ERROR: Unable to load UTF-16%s test file (method %d).\n", i > 1 ? "BE" : "LE", count + 1);
+	return (1);
+      }
+
+      mxmlDelete(tree);
+
+      if (strcmp(output, saved))
+      {
+	fprintf(stderr, "ERROR: UTF-16%s test file (method %d) saved \"%s\", expected \"%s\".\n", i > 1 ? "BE" : "LE", count + 1, output, saved);
+	return (1);
+      }
+
+      free(output);
     }
+
+    free(data);
   }
 
-#ifndef _WIN32
-  // Debug hooks...
-  if (getenv("TEST_DELAY") != NULL)
-    sleep(atoi(getenv("TEST_DELAY")));
+  remove("temp5.xml");
+  free(saved);
 
-#  ifdef __APPLE__
-  if (getenv("TEST_LEAKS") != NULL)
+  // Test UTF-16 with multibyte characters, a low surrogate of 0xDFFF and a byte order mark in the middle...
+  for (i = 0; i < 2; i ++)
   {
-    char command[1024];
+    if ((data = utf16_copy("<?xml version=\"1.0\"?><a>caf\xc3\xa9 \xe4\xb8\xad \xf0\x9f\x9f\xbfx\xef\xbb\xbfy</a>", i == 1, &bytes)) == NULL)
+    {
+      fputs("ERROR: Unable to convert string to UTF-16.\n", stderr);
+      return (1);
+    }
 
-    snprintf(command, sizeof(command), "leaks %d", (int)getpid());
-    if (system(command))
-      puts("Unable to check for leaks.");
-  }
-#  endif // __APPLE__
-#endif // !_WIN32
+    tree = mxmlLoadBufferInSitu(/*top*/NULL, options, data, bytes);
+    free(data);
 
-  // Return...
-  return (0);
-}
+    if (!tree)
+    {
+      fprintf(stderr, "ERROR: Unable to load UTF-16%s string.\n", i ? "BE" : "LE");
+      return (1);
+    }
+
+    mxmlSaveString(tree, options, buffer, sizeof(buffer));
+    mxmlDelete(tree);
+
+    if (strcmp(buffer, "<?xml version=\"1.0\"?><a>caf\xc3\xa9 \xe4\xb8\xad \xf0\x9f\x9f\xbfxy</a>"))
+    {
+      fprintf(stderr, "ERROR: UTF-16%s string saved \"%s\".\n", i ? "BE" : "LE", buffer);
+      return (1);
+    }
+  }
+
+  // A UTF-16 byte order mark is only recognized at the start of the data...
+  memcpy(buffer, "<a><b>x\xff\xfey\0<\0/\0b\0>\0<\0/\0a\0>\0", 27);
+
+  if ((tree = mxmlLoadBufferInSitu(/*top*/NULL, options, buffer, 27)) != NULL)
+  {
+    fputs("ERROR: Loaded UTF-8 data with a UTF-16 byte order mark in the middle.\n", stderr);
+    return (1);
+  }
+
+  // Test the pull reader, skipping one subtree...
+  snprintf(buffer, sizeof(buffer), "<?xml version=\"1.0\"?>\n<!-- c --><feed><skip a=\"1\"><x/>text</skip><item id=\"a&amp;b\" n='2'>caf\xc3\xa9 &lt;1&gt;<![CDATA[<raw>]]></item><e/></feed>\n");
+
+  if ((reader = mxmlReaderNew(options, buffer, strlen(buffer))) == NULL)
+  {
+    fputs("ERROR: Unable to create pull reader.\n", stderr);
+    return (1);
+  }
+
+  for (trace[0] = '\0'; mxmlReaderNext(reader, &event);)
+  {
+    text = event == MXML_SAX_EVENT_ELEMENT_OPEN || event == MXML_SAX_EVENT_ELEMENT_CLOSE ? mxmlReaderName(reader) : mxmlReaderText(reader);
+
+    snprintf(trace + strlen(trace), sizeof(trace) - strlen(trace), "%d:%s|", (int)event, text ? text : "(null)");
+
+    if (event == MXML_SAX_EVENT_ELEMENT_OPEN && !strcmp(text, "skip") && !mxmlReaderSkipSubtree(reader))
+    {
+      fputs("ERROR: Unable to skip pull reader subtree.\n", stderr);
+      return (1);
+    }
+    else if (event == MXML_SAX_EVENT_ELEMENT_OPEN && !strcmp(text, "item"))
+    {
+      if ((text = mxmlReaderAttr(reader, "id")) == NULL || strcmp(text, "a&b") || text < buffer || text >= (buffer + sizeof(buffer)))
+      {
+        fprintf(stderr, "ERROR: Pull reader attribute is \"%s\", expected \"a&b\" in the buffer.\n", text ? text : "(null)");
+        return (1);
+      }
+
+      if ((text = mxmlReaderAttr(reader, "n")) == NULL || strcmp(text, "2"))
+      {
+        fprintf(stderr, "ERROR: Pull reader attribute is \"%s\", expected \"2\".\n", text ? text : "(null)");
+        return (1);
+      }
+    }
+  }
+
+  mxmlReaderDelete(reader);
+
+  if (strcmp(trace, "4:xml version=\"1.0\"|1: c |6:feed|6:skip|6:item|2:caf\xc3\xa9 <1>|0:<raw>|5:item|6:e|5:e|5:feed|"))
+  {
+    fprintf(stderr, "ERROR: Pull reader events are \"%s\".\n", trace);
+    return (1);
+  }
+
+  // Test loading a large file of records in parallel...
+  if ((fp = fopen("temp3.xml", "w")) == NULL)
+  {
+    perror("Unable to create temp3.xml");
+    return (1);
+  }
+
+  fputs("<?xml version=\"1.0\"?>\n<feed type=\"records\">\n", fp);
+  for (i = 0; i < 30000; i ++)
+    fprintf(fp, "  <item id=\"%d\">value %d &amp; more</item>\n", i, i);
+  fputs("</feed>\n", fp);
+  fclose(fp);
+
+  if ((tree = mxmlLoadFilenameParallel(/*top*/NULL, options, "temp3.xml", 4)) == NULL)
+  {
+    fputs("ERROR: Unable to load temp3.xml in parallel.\n", stderr);
+    return (1);
+  }
+
+  for (i = 0, node = mxmlFindElement(tree, tree, "item", NULL, NULL, MXML_DESCEND_ALL); node; i ++, node = mxmlFindElement(node, tree, "item", NULL, NULL, MXML_DESCEND_NONE))
+  {
+    snprintf(buffer, sizeof(buffer), "%d", i);
+
+    if ((text = mxmlElementGetAttr(node, "id")) == NULL || strcmp(text, buffer) || mxmlGetParent(node) != mxmlFindElement(tree, tree, "feed", "type", "records", MXML_DESCEND_ALL))
+    {
+      fprintf(stderr, "ERROR: Parallel item %d has id \"%s\".\n", i, text ? text : "(null)");
+      return (1);
+    }
+  }
+
+  if (i != 30000)
+  {
+    fprintf(stderr, "ERROR: Loaded %d items in parallel, expected 30000.\n", i);
+    return (1);
+  }
+
+  mxmlDelete(tree);
+  remove("temp3.xml");
+
+  // Open the file/string using the default callback...
+
+  if (argv[1][0] == '<')
+    xml = mxmlLoadString(/*top*/NULL, options, argv[1]);
+  else
+    xml = mxmlLoadFilename(/*top*/NULL, options, argv[1]);
+
+  if (!xml)
+  {
+    fputs("Unable to read XML file with default callback.\n", stderr);
+    return (1);
+  }
+
+  if (!strcmp(argv[1], "test.xml"))
+  {
+    // Verify that mxmlFindElement() and indirectly mxmlWalkNext() work properly...
+    if ((node = mxmlFindPath(xml, "group/option/keyword")) == NULL)
+    {
+      fputs("Unable to find group/option/keyword element in XML tree.\n", stderr);
+      mxmlDelete(tree);
+      return (1);
+    }
+
+    if (mxmlGetType(node) != MXML_TYPE_TEXT)
+    {
+      fputs("No child node of group/option/keyword.\n", stderr);
+      mxmlSaveFile(xml, options, stderr);
+      mxmlDelete(xml);
+      return (1);
+    }
+
+    if ((text = mxmlGetText(node, NULL)) == NULL || strcmp(text, "InputSlot"))
+    {
+      fprintf(stderr, "Child node of group/option/value has value \"%s\" instead of \"InputSlot\".\n", text ? text : "(null)");
+      mxmlDelete(xml);
+      return (1);
+    }
+  }
+
+  mxmlDelete(xml);
+
+  // Open the file using a tiny buffer to exercise buffer refills...
+  mxmlOptionsSetTypeCallback(options, type_cb, /*cbdata*/NULL);
+
+  if (argv[1][0] == '<')
+  {
+    xml = mxmlLoadString(/*top*/NULL, options, argv[1]);
+  }
+  else if ((fp = fopen(argv[1], "rb")) != NULL)
+  {
+    mxmlOptionsSetBufferSize(options, 17);
+    xml = mxmlLoadFile(/*top*/NULL, options, fp);
+    mxmlOptionsSetBufferSize(options, 0);
+
+    fclose(fp);
+  }
+  else
+  {
+    perror(argv[1]);
+    return (1);
+  }
+
+  if (!xml)
+  {
+    fputs("Unable to read XML file.\n", stderr);
+    return (1);
+  }
+
+  if (!strcmp(argv[1], "test.xml"))
+  {
+    // Verify that mxmlFindElement() and indirectly mxmlWalkNext() work properly...
+    if ((node = mxmlFindElement(xml, xml, "choice", NULL, NULL, MXML_DESCEND_ALL)) == NULL)
+    {
+      fputs("Unable to find first <choice> element in XML tree.\n", stderr);
+      mxmlDelete(tree);
+      return (1);
+    }
+
+    if (!mxmlFindElement(node, xml, "choice", NULL, NULL, MXML_DESCEND_NONE))
+    {
+      fputs("Unable to find second <choice> element in XML tree.\n", stderr);
+      mxmlDelete(tree);
+      return (1);
+    }
+  }
+
+  // Print the XML tree...
+  mxmlOptionsSetWhitespaceCallback(options, whitespace_cb, /*cbdata*/NULL);
+  mxmlSaveFile(xml, options, stdout);
+
+  // Save the XML tree to a string and print it...
+  if (mxmlSaveString(xml, options, buffer, sizeof(buffer)) > 0)
+  {
+    if (argc == 3)
+    {
+      fp = fopen(argv[2], "w");
+      fputs(buffer, fp);
+      fclose(fp);
+    }
+  }
+
+  // Delete the tree...
+  mxmlDelete(xml);
+
+  // Read from/write to file descriptors...
+  if (argv[1][0] != '<')
+  {
+    // Open the file again...
+    if ((fd = open(argv[1], O_RDONLY | O_BINARY)) < 0)
+    {
+      perror(argv[1]);
+      return (1);
+    }
+
+    // Read the file...
+    xml = mxmlLoadFd(/*top*/NULL, options, fd);
+
+    close(fd);
+
+    // Create filename.xmlfd...
+    snprintf(buffer, sizeof(buffer), "%sfd", argv[1]);
+
+    if ((fd = open(buffer, O_WRONLY | O_CREAT | O_TRUNC | O_BINARY, 0666)) < 0)
+    {
+      perror(buffer);
+      mxmlDelete(tree);
+      return (1);
+    }
+
+    // Write the file...
+    mxmlSaveFd(xml, options, fd);
+
+    close(fd);
+
+    // Delete the tree...
+    mxmlDelete(xml);
+  }
+
+  // Test SAX methods...
+  memset(event_counts, 0, sizeof(event_counts));
+
+  mxmlOptionsSetSAXCallback(options, sax_cb, /*cbdata*/NULL);
+
+  if (argv[1][0] == '<')
+    mxmlRelease(mxmlLoadString(/*top*/NULL, options, argv[1]));
+  else
+    mxmlRelease(mxmlLoadFilename(/*top*/NULL, options, argv[1]));
+
+  if (!strcmp(argv[1], "test.xml"))
+  {
+    if (event_counts[MXML_SAX_EVENT_CDATA] != 1)
+    {
+      fprintf(stderr, "MXML_SAX_EVENT_CDATA seen %d times, expected 1 times.\n", event_counts[MXML_SAX_EVENT_CDATA]);
+      return (1);
+    }
+
+    if (event_counts[MXML_SAX_EVENT_COMMENT] != 1)
+    {
+      fprintf(stderr, "MXML_SAX_EVENT_COMMENT seen %d times, expected 1 times.\n", event_counts[MXML_SAX_EVENT_COMMENT]);
+      return (1);
+    }
+
+    if (event_counts[MXML_SAX_EVENT_DATA] != 61)
+    {
+      fprintf(stderr, "MXML_SAX_EVENT_DATA seen %d times, expected 61 times.\n", event_counts[MXML_SAX_EVENT_DATA]);
+      return (1);
+    }
+
+    if (event_counts[MXML_SAX_EVENT_DECLARATION] != 0)
+    {
+      fprintf(stderr, "MXML_SAX_EVENT_DECLARATION seen %d times, expected 0 times.\n", event_counts[MXML_SAX_EVENT_DECLARATION]);
+      return (1);
+    }
+
+    if (event_counts[MXML_SAX_EVENT_DIRECTIVE] != 1)
+    {
+      fprintf(stderr, "MXML_SAX_EVENT_DIRECTIVE seen %d times, expected 1 times.\n", event_counts[MXML_SAX_EVENT_DIRECTIVE]);
+      return (1);
+    }
+
+    if (event_counts[MXML_SAX_EVENT_ELEMENT_CLOSE] != 20)
+    {
+      fprintf(stderr, "MXML_SAX_EVENT_ELEMENT_CLOSE seen %d times, expected 20 times.\n", event_counts[MXML_SAX_EVENT_ELEMENT_CLOSE]);
+      return (1);
+    }
+
+    if (event_counts[MXML_SAX_EVENT_ELEMENT_OPEN] != 20)
+    {
+      fprintf(stderr, "MXML_SAX_EVENT_ELEMENT_OPEN seen %d times, expected 20 times.\n", event_counts[MXML_SAX_EVENT_ELEMENT_OPEN]);
+      return (1);
+    }
+  }
+
+  // Test transient SAX, keeping everything except the <skip> elements...
+  options = mxmlOptionsNew();
+  mxmlOptionsSetSAXCallback(options, sax_keep_cb, /*cbdata*/NULL);
+  mxmlOptionsSetSAXTransient(options, true);
+
+  if ((xml = mxmlLoadString(/*top*/NULL, options, "<?xml version=\"1.0\"?><group><skip a=\"1\">text<skip/></skip><keep id=\"k\"><v>42</v> tail</keep><skip/></group>")) == NULL)
+  {
+    fputs("ERROR: Unable to load transient SAX string.\n", stderr);
+    return (1);
+  }
+
+  mxmlSaveString(xml, /*options*/NULL, buffer, sizeof(buffer));
+  mxmlDelete(xml);
+
+  if (strcmp(buffer, "<?xml version=\"1.0\"?><group><keep id=\"k\"><v>42</v> tail</keep></group>"))
+  {
+    fprintf(stderr, "ERROR: Transient SAX kept \"%s\".\n", buffer);
+    return (1);
+  }
+
+  if ((xml = mxmlLoadString(/*top*/NULL, options, "<?xml version=\"1.0\"?><group><keep>text</group>")) != NULL)
+  {
+    fputs("ERROR: Transient SAX loaded mismatched elements.\n", stderr);
+    mxmlDelete(xml);
+    return (1);
+  }
+
+  mxmlOptionsDelete(options);
+
+  // Test lazy loading, overwriting the string before the deferred content is loaded...
+  options = mxmlOptionsNew();
+  mxmlOptionsSetLazyDepth(options, 2);
+
+  snprintf(trace, sizeof(trace), "%s", "<?xml version=\"1.0\"?><catalog><item id=\"1\"><name>one</name><!-- </item> --></item><item id=\"2\" a=\"&gt;\"><name>two</name><![CDATA[</item>]]></item></catalog>");
+
+  if ((xml = mxmlLoadString(/*top*/NULL, options, trace)) == NULL)
+  {
+    fputs("ERROR: Unable to load lazy string.\n", stderr);
+    return (1);
+  }
+
+  snprintf(buffer, sizeof(buffer), "%s", trace);
+  memset(trace, ' ', strlen(trace));
+
+  if ((node = mxmlFindElement(xml, xml, "item", "id", "2", MXML_DESCEND_ALL)) == NULL || (text = mxmlGetText(mxmlFindPath(node, "name"), NULL)) == NULL || strcmp(text, "two"))
+  {
+    fputs("ERROR: Unable to find lazy item 2.\n", stderr);
+    return (1);
+  }
+
+  mxmlSaveString(xml, /*options*/NULL, trace, sizeof(trace));
+  mxmlDelete(xml);
+  mxmlOptionsDelete(options);
+
+  if (strcmp(buffer, trace))
+  {
+    fprintf(stderr, "ERROR: Lazy load saved \"%s\".\n", trace);
+    return (1);
+  }
+
+  // Test skipping quotes inside unquoted attribute names and values...
+  text = "<group><option><code t\"pe=\"a>b\"/><v type=aque\"/>x</option><item>i</item></group>";
+
+  if ((xml = mxmlLoadString(/*top*/NULL, /*options*/NULL, text)) == NULL)
+  {
+    fputs("ERROR: Unable to load string with quotes in unquoted attributes.\n", stderr);
+    return (1);
+  }
+
+  mxmlSaveString(xml, /*options*/NULL, buffer, sizeof(buffer));
+  mxmlDelete(xml);
+
+  options = mxmlOptionsNew();
+  mxmlOptionsSetLazyDepth(options, 2);
+
+  if ((xml = mxmlLoadString(/*top*/NULL, options, text)) == NULL)
+  {
+    fputs("ERROR: Unable to lazy load string with quotes in unquoted attributes.\n", stderr);
+    return (1);
+  }
+
+  mxmlSaveString(xml, /*options*/NULL, trace, sizeof(trace));
+  mxmlDelete(xml);
+  mxmlOptionsDelete(options);
+
+  if (strcmp(buffer, trace))
+  {
+    fprintf(stderr, "ERROR: Lazy load with quotes in unquoted attributes saved \"%s\", expected \"%s\".\n", trace, buffer);
+    return (1);
+  }
+
+  options = mxmlOptionsNew();
+
+  if (!mxmlOptionsAddProjection(options, "group/item") || (xml = mxmlLoadString(/*top*/NULL, options, text)) == NULL)
+  {
+    fputs("ERROR: Unable to project string with quotes in unquoted attributes.\n", stderr);
+    return (1);
+  }
+
+  mxmlSaveString(xml, /*options*/NULL, trace, sizeof(trace));
+  mxmlDelete(xml);
+  mxmlOptionsDelete(options);
+
+  if (strcmp(trace, "<group><item>i</item></group>"))
+  {
+    fprintf(stderr, "ERROR: Projected load with quotes in unquoted attributes saved \"%s\".\n", trace);
+    return (1);
+  }
+
+  // Test that errors in deferred content are reported by mxmlElementExpand and saves...
+  options = mxmlOptionsNew();
+
+  for (i = 0; i < 6; i ++)
+  {
+    mxmlOptionsSetLazyDepth(options, 1 + i / 3);
+
+    if ((xml = mxmlLoadString(/*top*/NULL, options, lazy_bad[i % 3])) == NULL)
+    {
+      fprintf(stderr, "ERROR: Unable to lazy load \"%s\" at depth %d.\n", lazy_bad[i % 3], 1 + i / 3);
+      return (1);
+    }
+
+    if (mxmlElementExpand(xml, MXML_DESCEND_ALL) || mxmlElementExpand(xml, MXML_DESCEND_ALL) || (saved = mxmlSaveAllocString(xml, /*options*/NULL)) != NULL)
+    {
+      fprintf(stderr, "ERROR: Malformed deferred content \"%s\" at depth %d was not reported.\n", lazy_bad[i % 3], 1 + i / 3);
+      return (1);
+    }
+
+    mxmlDelete(xml);
+  }
+
+  // An empty comment does not end at "-->", as with mxmlLoadString...
+  if ((xml = mxmlLoadString(/*top*/NULL, options, "<a><b><!----></b><c/></a>")) != NULL)
+  {
+    fputs("ERROR: Lazy load accepted an unterminated comment.\n", stderr);
+    return (1);
+  }
+
+  // Comments ending in "--->" and "<?>" directives are skipped like mxmlLoadString...
+  text = "<a><b><!-- x --->--><?><c/></b><d/></a>";
+
+  if ((xml = mxmlLoadString(/*top*/NULL, /*options*/NULL, text)) == NULL)
+  {
+    fputs("ERROR: Unable to load string with comments and directives.\n", stderr);
+    return (1);
+  }
+
+  mxmlSaveString(xml, /*options*/NULL, buffer, sizeof(buffer));
+  mxmlDelete(xml);
+
+  if ((xml = mxmlLoadString(/*top*/NULL, options, text)) == NULL || !mxmlElementExpand(xml, MXML_DESCEND_ALL))
+  {
+    fputs("ERROR: Unable to lazy load string with comments and directives.\n", stderr);
+    return (1);
+  }
+
+  mxmlSaveString(xml, /*options*/NULL, trace, sizeof(trace));
+  mxmlDelete(xml);
+  mxmlOptionsDelete(options);
+
+  if (strcmp(buffer, trace))
+  {
+    fprintf(stderr, "ERROR: Lazy load with comments and directives saved \"%s\", expected \"%s\".\n", trace, buffer);
+    return (1);
+  }
+
+  // Test record loading, reading a few bytes at a time...
+  ptr   = "<?xml version=\"1.0\"?><list><rec id=\"1\"><v>a</v></rec><wrap><rec id=\"2\"/></wrap> text <rec id=\"3\">b<rec id=\"4\"/></rec></list>";
+  count = 0;
+
+  if (!mxmlLoadRecords(/*options*/NULL, read_cb, &ptr, "rec", record_cb, &count) || count != 3)
+  {
+    fprintf(stderr, "ERROR: Loaded %d records, expected 3.\n", count);
+    return (1);
+  }
+
+  ptr   = "<list><rec id=\"1\"/><rec id=\"2\" stop=\"1\"/><rec id=\"3\"/></list>";
+  count = 0;
+
+  if (!mxmlLoadRecords(/*options*/NULL, read_cb, &ptr, /*name*/NULL, record_cb, &count) || count != 2)
+  {
+    fprintf(stderr, "ERROR: Loaded %d records before stopping, expected 2.\n", count);
+    return (1);
+  }
+
+  options = mxmlOptionsNew();
+  mxmlOptionsSetArena(options, true);
+
+  ptr   = "<list><rec id=\"1\"><v>a</v></rec><rec id=\"2\"><v>b</list>";
+  count = 0;
+
+  if (mxmlLoadRecords(options, read_cb, &ptr, "rec", record_cb, &count) || count != 1)
+  {
+    fprintf(stderr, "ERROR: Loaded %d records from bad XML, expected 1 and an error.\n", count);
+    return (1);
+  }
+
+  mxmlOptionsDelete(options);
+
+  // Test projection, reading a few bytes at a time...
+  options = mxmlOptionsNew();
+  mxmlOptionsSetTypeValue(options, MXML_TYPE_OPAQUE);
+
+  if (mxmlOptionsAddProjection(options, "catalog//price") || !mxmlOptionsAddProjection(options, "catalog/item/price") || !mxmlOptionsAddProjection(options, "catalog/*/note"))
+  {
+    fputs("ERROR: Unable to add projection paths.\n", stderr);
+    return (1);
+  }
+
+  ptr = "<?xml version=\"1.0\"?><catalog><item id=\"1\"><name>A &amp; B</name><price>1.50</price></item> text <!-- <item> --><item id=\"2\" a='>'><price>2</price><![CDATA[</item>]]><x><note>n</note></x></item><other><price>9</price></other></catalog>";
+
+  if ((xml = mxmlLoadIO(/*top*/NULL, options, read_cb, &ptr)) == NULL)
+  {
+    fputs("ERROR: Unable to load projected XML.\n", stderr);
+    return (1);
+  }
+
+  mxmlSaveString(xml, /*options*/NULL, buffer, sizeof(buffer));
+  mxmlDelete(xml);
+  mxmlOptionsDelete(options);
+
+  if (strcmp(buffer, "<?xml version=\"1.0\"?><catalog><item id=\"1\"><name/><price>1.50</price></item><item id=\"2\" a=\"&gt;\"><price>2</price><x><note>n</note></x></item><other><price/></other></catalog>"))
+  {
+    fprintf(stderr, "ERROR: Projected load saved \"%s\".\n", buffer);
+    return (1);
+  }
+
+  // Test loading several documents with one load context...
+  options = mxmlOptionsNew();
+  mxmlOptionsSetTypeValue(options, MXML_TYPE_OPAQUE);
+
+  if ((context = mxmlContextNew(options)) == NULL)
+  {
+    fputs("ERROR: Unable to create load context.\n", stderr);
+    return (1);
+  }
+
+  if ((tree = mxmlContextLoadString(context, /*top*/NULL, "<kept a=\"1\">first</kept>")) == NULL)
+  {
+    fputs("ERROR: Unable to load first message with context.\n", stderr);
+    return (1);
+  }
+
+  for (i = 0; i < 10; i ++)
+  {
+    snprintf(buffer, sizeof(buffer), "<msg id=\"%d\"><body>text %d</body></msg>", i, i);
+
+    if ((xml = mxmlContextLoadString(context, /*top*/NULL, buffer)) == NULL)
+    {
+      fprintf(stderr, "ERROR: Unable to load message %d with context.\n", i);
+      return (1);
+    }
+
+    mxmlSaveString(xml, /*options*/NULL, buffer + 1024, sizeof(buffer) - 1024);
+    mxmlDelete(xml);
+
+    if (strcmp(buffer, buffer + 1024))
+    {
+      fprintf(stderr, "ERROR: Context load of message %d saved \"%s\".\n", i, buffer + 1024);
+      return (1);
+    }
+  }
+
+  if (mxmlContextLoadString(context, /*top*/NULL, "<msg><body></msg>") != NULL)
+  {
+    fputs("ERROR: Context load of bad message succeeded.\n", stderr);
+    return (1);
+  }
+
+  mxmlContextDelete(context);
+  mxmlOptionsDelete(options);
+
+  mxmlSaveString(tree, /*options*/NULL, buffer, sizeof(buffer));
+  mxmlDelete(tree);
+
+  if (strcmp(buffer, "<kept a=\"1\">first</kept>"))
+  {
+    fprintf(stderr, "ERROR: Tree loaded with context saved \"%s\".\n", buffer);
+    return (1);
+  }
+
+  // Test saving and loading a large CDATA value...
+  if ((data = malloc(1000001)) == NULL)
+  {
+    fputs("ERROR: Unable to allocate CDATA value.\n", stderr);
+    return (1);
+  }
+
+  for (i = 0; i < 1000000; i ++)
+    data[i] = "ABCDEFGHIJKLMNOPQRSTUVWXYZabcdefghijklmnopqrstuvwxyz0123456789+/"[(i * 7) & 63];
+  data[i] = '\0';
+
+  tree = mxmlNewElement(/*parent*/NULL, "blob");
+  mxmlNewCDATA(tree, data);
+
+  saved = mxmlSaveAllocStringReserve(tree, /*options*/NULL, 16);
+  mxmlDelete(tree);
+
+  if (!saved || strlen(saved) != 1000025)
+  {
+    fprintf(stderr, "ERROR: Saved large CDATA to %u bytes, expected 1000025.\n", saved ? (unsigned)strlen(saved) : 0);
+    return (1);
+  }
+
+  ptr = saved;
+
+  if ((tree = mxmlLoadIO(/*top*/NULL, /*options*/NULL, read_cb, &ptr)) == NULL)
+  {
+    fputs("ERROR: Unable to load large CDATA.\n", stderr);
+    return (1);
+  }
+
+  if ((text = mxmlGetCDATA(mxmlGetFirstChild(tree))) == NULL || strcmp(text, data))
+  {
+    fputs("ERROR: Large CDATA value does not match.\n", stderr);
+    return (1);
+  }
+
+  mxmlDelete(tree);
+  free(saved);
+  free(data);
+
+  // Test measuring and truncated saves...
+  if ((tree = mxmlLoadString(/*top*/NULL, /*options*/NULL, "<group a=\"&quot;x&quot;\"><item>A &amp; B &lt; C</item><item/></group>")) == NULL)
+  {
+    fputs("ERROR: Unable to load measure test string.\n", stderr);
+    return (1);
+  }
+
+  count = (int)mxmlSaveMeasure(tree, /*options*/NULL);
+
+  if ((size_t)count != mxmlSaveString(tree, /*options*/NULL, buffer, sizeof(buffer)) || (size_t)count != strlen(buffer))
+  {
+    fprintf(stderr, "ERROR: mxmlSaveMeasure returned %d, expected %u.\n", count, (unsigned)strlen(buffer));
+    return (1);
+  }
+
+  if (mxmlSaveString(tree, /*options*/NULL, trace, 10) != (size_t)count || strncmp(trace, buffer, 9) || trace[9])
+  {
+    fprintf(stderr, "ERROR: Truncated save returned \"%s\".\n", trace);
+    return (1);
+  }
+
+  if ((saved = mxmlSaveAllocStringReserve(tree, /*options*/NULL, (size_t)count + 1)) == NULL || strcmp(saved, buffer))
+  {
+    fprintf(stderr, "ERROR: Exact size save returned \"%s\".\n", saved ? saved : "(null)");
+    return (1);
+  }
+
+  free(saved);
+
+  // Test buffered saves with partial and failed writes...
+  options = mxmlOptionsNew();
+  mxmlOptionsSetBufferSize(options, 16);
+
+  saved = trace;
+
+  if (!mxmlSaveIO(tree, options, write_cb, &saved))
+  {
+    fputs("ERROR: Unable to save with partial writes.\n", stderr);
+    return (1);
+  }
+
+  *saved = '\0';
+
+  if (strncmp(trace, buffer, (size_t)count) || strcmp(trace + count, "\n"))
+  {
+    fprintf(stderr, "ERROR: Save with partial writes returned \"%s\".\n", trace);
+    return (1);
+  }
+
+  saved = NULL;
+
+  if (mxmlSaveIO(tree, options, write_cb, &saved))
+  {
+    fputs("ERROR: Save with failed writes succeeded.\n", stderr);
+    return (1);
+  }
+
+  mxmlOptionsDelete(options);
+  mxmlDelete(tree);
+
+  // Test an exact size save larger than the 1024 byte minimum reserved by mxmlSaveAllocStringReserve...
+  tree = mxmlNewElement(/*parent*/NULL, "group");
+
+  for (i = 0; i < 100; i ++)
+    mxmlNewText(mxmlNewElement(tree, "item"), false, "A & B < C");
+
+  count = (int)mxmlSaveMeasure(tree, /*options*/NULL);
+
+  mxmlSaveString(tree, /*options*/NULL, buffer, sizeof(buffer));
+
+  if (count <= 1024 || (saved = mxmlSaveAllocStringReserve(tree, /*options*/NULL, (size_t)count + 1)) == NULL || strcmp(saved, buffer))
+  {
+    fprintf(stderr, "ERROR: Large exact size save of %d bytes failed.\n", count);
+    return (1);
+  }
+
+#ifdef __GLIBC__
+  // Growing the buffer at least doubles it, so the exact size reservation must not have grown...
+  if (malloc_usable_size(saved) >= 2 * ((size_t)count + 1))
+  {
+    fprintf(stderr, "ERROR: Exact size save of %d bytes grew the buffer to %u bytes.\n", count, (unsigned)malloc_usable_size(saved));
+    return (1);
+  }
+#endif // __GLIBC__
+
+  free(saved);
+  mxmlDelete(tree);
+
+  // Test escaping with and without column tracking...
+  tree = mxmlNewElement(/*parent*/NULL, "escape");
+  mxmlElementSetAttr(tree, "value", "\"quoted\" & <tagged>");
+  mxmlNewOpaque(tree, "tab\there, a long enough run of plain text, <b>bold</b> & \"quotes\"\n");
+
+  options = mxmlOptionsNew();
+
+  for (i = 0; i < 2; i ++)
+  {
+    mxmlOptionsSetWrapMargin(options, i ? 0 : 72);
+    mxmlSaveString(tree, options, buffer, sizeof(buffer));
+
+    if (strcmp(buffer, "<escape value=\"&quot;quoted&quot; &amp; &lt;tagged&gt;\">tab\there, a long enough run of plain text, &lt;b&gt;bold&lt;/b&gt; &amp; &quot;quotes&quot;\n</escape>"))
+    {
+      fprintf(stderr, "ERROR: Escaped save with wrap margin %d returned \"%s\".\n", i ? 0 : 72, buffer);
+      return (1);
+    }
+  }
+
+  mxmlOptionsDelete(options);
+  mxmlDelete(tree);
+
+  // Test built-in indentation...
+  options = mxmlOptionsNew();
+  mxmlOptionsSetTypeValue(options, MXML_TYPE_OPAQUE);
+
+  if ((tree = mxmlLoadString(/*top*/NULL, options, "<?xml version=\"1.0\"?><root><!-- c --><group><item>one</item><item>two <b>2</b></item><empty/></group><mixed>a<b/>c</mixed></root>")) == NULL)
+  {
+    fputs("ERROR: Unable to load indentation test string.\n", stderr);
+    return (1);
+  }
+
+  mxmlOptionsSetIndent(options, MXML_INDENT_ELEMENTS, 2);
+  mxmlSaveString(tree, options, buffer, sizeof(buffer));
+
+  if (strcmp(buffer, "<?xml version=\"1.0\"?>\n<root>\n  <!-- c -->\n  <group>\n    <item>one</item>\n    <item>two <b>2</b></item>\n    <empty/>\n  </group>\n  <mixed>a<b/>c</mixed>\n</root>"))
+  {
+    fprintf(stderr, "ERROR: Indented save returned \"%s\".\n", buffer);
+    return (1);
+  }
+
+  mxmlOptionsSetIndent(options, MXML_INDENT_ALL, 0);
+  mxmlSaveString(mxmlFindElement(tree, tree, "mixed", NULL, NULL, MXML_DESCEND_ALL), options, buffer, sizeof(buffer));
+
+  if (strcmp(buffer, "<mixed>\n\ta\n\t<b/>\n\tc\n</mixed>"))
+  {
+    fprintf(stderr, "ERROR: Fully indented save returned \"%s\".\n", buffer);
+    return (1);
+  }
+
+  mxmlOptionsDelete(options);
+  mxmlDelete(tree);
+
+  // Test plain runs with a delimiter at every offset modulo 16 and 32 in each kind of scanned data...
+  options = mxmlOptionsNew();
+  mxmlOptionsSetTypeValue(options, MXML_TYPE_OPAQUE);
+
+  for (i = 0; i < 80; i ++)
+  {
+    char	x[81],			// Run before the delimiter
+		y[81];			// Run after the delimiter
+
+    memset(x, 'x', (size_t)i);
+    x[i] = '\0';
+    memset(y, 'y', (size_t)(80 - i));
+    y[80 - i] = '\0';
+
+    snprintf(buffer, sizeof(buffer), "<a v=\"%s&lt;%s\" w='%s\"%s'>%s&amp;%s<b>%s\xc3\xa9%s</b><c>%s\t%s</c><!--%s-%s--><![CDATA[%s]]%s]]><?p %s?%s?></a>", x, y, x, y, x, y, x, y, x, y, x, y, x, y, x, y);
+
+    if ((tree = mxmlLoadString(/*top*/NULL, options, buffer)) == NULL)
+    {
+      fprintf(stderr, "ERROR: Unable to load runs with a delimiter at offset %d.\n", i);
+      return (1);
+    }
+
+    node = mxmlGetFirstChild(tree);
+
+    snprintf(trace, sizeof(trace), "%s<%s|%s\"%s|%s&%s|%s\xc3\xa9%s|%s\t%s|%s-%s|%s]]%s|p %s?%s", x, y, x, y, x, y, x, y, x, y, x, y, x, y, x, y);
+    snprintf(buffer, sizeof(buffer), "%s|%s|%s|%s|%s|%s|%s|%s", mxmlElementGetAttr(tree, "v"), mxmlElementGetAttr(tree, "w"), mxmlGetOpaque(node), mxmlGetOpaque(mxmlGetFirstChild(mxmlGetNextSibling(node))), mxmlGetOpaque(mxmlGetFirstChild(mxmlGetNextSibling(mxmlGetNextSibling(node)))), mxmlGetComment(mxmlGetPrevSibling(mxmlGetPrevSibling(mxmlGetLastChild(tree)))), mxmlGetCDATA(mxmlGetPrevSibling(mxmlGetLastChild(tree))), mxmlGetDirective(mxmlGetLastChild(tree)));
+    mxmlDelete(tree);
+
+    if (strcmp(buffer, trace))
+    {
+      fprintf(stderr, "ERROR: Runs with a delimiter at offset %d loaded as \"%s\", expected \"%s\".\n", i, buffer, trace);
+      return (1);
+    }
+  }
+
+  mxmlOptionsDelete(options);
+
+  // Test the streaming writer against saving the equivalent tree...
+  options = mxmlOptionsNew();
+  mxmlOptionsSetTypeValue(options, MXML_TYPE_OPAQUE);
+
+  if ((tree = mxmlLoadString(/*top*/NULL, options, "<?xml version=\"1.0\"?><root><!-- c --><group id=\"a&amp;b\" name=\"&lt;g&gt;\"><item>one</item><item>two <b>2</b></item><empty/><data><![CDATA[x<y]]></data></group><mixed>a &lt; b<b/>c</mixed></root>")) == NULL)
+  {
+    fputs("ERROR: Unable to load streaming writer test string.\n", stderr);
+    return (1);
+  }
+
+  for (i = 0; i < 4; i ++)
+  {
+    mxmlOptionsSetWrapMargin(options, i == 3 ? 0 : 72);
+    mxmlOptionsSetIndent(options, i == 1 ? MXML_INDENT_ELEMENTS : i == 2 ? MXML_INDENT_ALL : MXML_INDENT_NONE, i == 1 ? 2 : 0);
+    mxmlSaveString(tree, options, buffer, sizeof(buffer));
+
+    saved = trace;
+
+    if ((writer = mxmlWriterNew(options, write_cb, &saved)) == NULL)
+    {
+      fputs("ERROR: Unable to create streaming writer.\n", stderr);
+      return (1);
+    }
+
+    mxmlWriterDirective(writer, "xml version=\"1.0\"");
+    mxmlWriterStartElement(writer, "root");
+    mxmlWriterComment(writer, " c ");
+    mxmlWriterStartElement(writer, "group");
+    mxmlWriterAttr(writer, "id", "a&b");
+    mxmlWriterAttr(writer, "name", "<g>");
+    mxmlWriterStartElement(writer, "item");
+    mxmlWriterText(writer, false, "one");
+    mxmlWriterEndElement(writer);
+    mxmlWriterStartElement(writer, "item");
+    mxmlWriterText(writer, false, "two ");
+    mxmlWriterStartElement(writer, "b");
+    mxmlWriterText(writer, false, "2");
+    mxmlWriterEndElement(writer);
+    mxmlWriterEndElement(writer);
+    mxmlWriterStartElement(writer, "empty");
+    mxmlWriterEndElement(writer);
+    mxmlWriterStartElement(writer, "data");
+    mxmlWriterCDATA(writer, "x<y");
+    mxmlWriterEndElement(writer);
+    mxmlWriterEndElement(writer);
+    mxmlWriterStartElement(writer, "mixed");
+    mxmlWriterText(writer, false, "a < b");
+    mxmlWriterStartElement(writer, "b");
+    mxmlWriterEndElement(writer);
+    mxmlWriterText(writer, false, "c");
+    mxmlWriterEndElement(writer);
+
+    if (!mxmlWriterEndElement(writer) || mxmlWriterEndElement(writer) || !mxmlWriterFlush(writer))
+    {
+      fprintf(stderr, "ERROR: Streaming writer failed for test %d.\n", i + 1);
+      return (1);
+    }
+
+    *saved = '\0';
+    mxmlWriterDelete(writer);
+
+    if (strcmp(trace, buffer))
+    {
+      fprintf(stderr, "ERROR: Streaming writer test %d returned \"%s\", expected \"%s\".\n", i + 1, trace, buffer);
+      return (1);
+    }
+  }
+
+  saved  = NULL;
+  writer = mxmlWriterNew(options, write_cb, &saved);
+
+  if (!mxmlWriterStartElement(writer, "root") || mxmlWriterFlush(writer) || mxmlWriterEndElement(writer))
+  {
+    fputs("ERROR: Streaming writer with failed writes succeeded.\n", stderr);
+    return (1);
+  }
+
+  mxmlWriterDelete(writer);
+
+  // Test splitting CDATA sections and indenting elements that become mixed...
+  mxmlOptionsSetWrapMargin(options, 72);
+  mxmlOptionsSetIndent(options, MXML_INDENT_ELEMENTS, 2);
+
+  saved  = trace;
+  writer = mxmlWriterNew(options, write_cb, &saved);
+
+  mxmlWriterStartElement(writer, "root");
+  mxmlWriterStartElement(writer, "c");
+  mxmlWriterEndElement(writer);
+  mxmlWriterCDATA(writer, "x]]>y]]>]]>");
+  mxmlWriterEndElement(writer);
+
+  if (!mxmlWriterFlush(writer))
+  {
+    fputs("ERROR: Streaming writer failed to write CDATA.\n", stderr);
+    return (1);
+  }
+
+  *saved = '\0';
+  mxmlWriterDelete(writer);
+
+  if (strcmp(trace, "<root>\n  <c/><![CDATA[x]]]]><![CDATA[>y]]]]><![CDATA[>]]]]><![CDATA[>]]></root>"))
+  {
+    fprintf(stderr, "ERROR: Streaming writer CDATA returned \"%s\".\n", trace);
+    return (1);
+  }
+
+  if ((xml = mxmlLoadString(/*top*/NULL, options, trace)) == NULL)
+  {
+    fputs("ERROR: Unable to load streaming writer CDATA.\n", stderr);
+    return (1);
+  }
+
+  for (buffer[0] = '\0', node = mxmlGetNextSibling(mxmlFindElement(xml, xml, "c", NULL, NULL, MXML_DESCEND_ALL)); node; node = mxmlGetNextSibling(node))
+    strncat(buffer, mxmlGetCDATA(node), sizeof(buffer) - strlen(buffer) - 1);
+
+  mxmlDelete(xml);
+
+  if (strcmp(buffer, "x]]>y]]>]]>"))
+  {
+    fprintf(stderr, "ERROR: Streaming writer CDATA loaded as \"%s\".\n", buffer);
+    return (1);
+  }
+
+  mxmlOptionsDelete(options);
+  mxmlDelete(tree);
+
+  // Test parallel saves against serial saves...
+  tree = mxmlNewXML("1.0");
+  node = mxmlNewElement(tree, "root");
+
+  for (i = 0; i < 200; i ++)
+  {
+    if ((i % 17) == 0)
+    {
+      mxmlNewCommentf(node, " comment %d ", i);
+    }
+    else if ((i % 23) == 0)
+    {
+      mxml_node_t *mixed = mxmlNewElement(node, "mixed");
+					// Mixed content element
+
+      mxmlNewText(mixed, false, "loose");
+      mxmlNewText(mxmlNewElement(mixed, "b"), true, "bold");
+      mxmlNewText(mixed, true, "text");
+    }
+    else
+    {
+      mxml_node_t *item = mxmlNewElement(node, "item");
+					// Item element
+
+      mxmlElementSetAttrf(item, "id", "%d", i);
+      mxmlElementSetAttr(item, "name", "a \"quoted\" & long attribute value that wraps");
+
+      if (i & 1)
+        mxmlNewText(mxmlNewElement(item, "value"), false, "one < two");
+      else
+        mxmlNewCDATA(mxmlNewElement(item, "data"), "raw <data>");
+    }
+  }
+
+  options = mxmlOptionsNew();
+
+  for (i = 0; i < 5; i ++)
+  {
+    mxmlOptionsSetWrapMargin(options, (i & 1) ? 0 : 72);
+    mxmlOptionsSetIndent(options, i < 2 ? MXML_INDENT_NONE : i < 4 ? MXML_INDENT_ELEMENTS : MXML_INDENT_ALL, i == 3 ? 0 : 2);
+
+    if ((saved = mxmlSaveAllocString(tree, options)) == NULL || (data = calloc(1, strlen(saved) + 2)) == NULL)
+    {
+      fputs("ERROR: Unable to save parallel test tree.\n", stderr);
+      return (1);
+    }
+
+    output = data;
+
+    if (!mxmlSaveParallel(tree, options, write_cb, &output, 4) || strncmp(data, saved, strlen(saved)) || strcmp(data + strlen(saved), "\n"))
+    {
+      fprintf(stderr, "ERROR: Parallel save %d returned \"%s\".\n", i + 1, data);
+      return (1);
+    }
+
+    free(data);
+    free(saved);
+  }
+
+  output = NULL;
+
+  if (mxmlSaveParallel(tree, options, write_cb, &output, 4))
+  {
+    fputs("ERROR: Parallel save with failed writes succeeded.\n", stderr);
+    return (1);
+  }
+
+  mxmlOptionsDelete(options);
+  mxmlDelete(tree);
+
+  // Test saving large strings to a file descriptor...
+  if ((data = malloc(20001)) == NULL)
+  {
+    perror("Unable to allocate payload");
+    return (1);
+  }
+
+  for (i = 0; i < 20000; i ++)
+    data[i] = (i % 4999) == 0 ? '&' : (char)('a' + i % 26);
+  data[i] = '\0';
+
+  tree = mxmlNewElement(/*parent*/NULL, "payloads");
+  node = mxmlNewElement(tree, "text");
+  mxmlElementSetAttr(node, "value", data);
+  mxmlNewOpaque(node, data);
+  mxmlNewCDATA(mxmlNewElement(tree, "cdata"), data);
+  mxmlNewOpaque(mxmlNewElement(tree, "short"), "short & sweet");
+
+  free(data);
+
+  options = mxmlOptionsNew();
+  mxmlOptionsSetWrapMargin(options, 0);
+
+  if ((saved = mxmlSaveAllocString(tree, options)) == NULL || (output = calloc(1, strlen(saved) + 2)) == NULL)
+  {
+    fputs("ERROR: Unable to save payloads to a string.\n", stderr);
+    return (1);
+  }
+
+  if ((fd = open("temp4.xml", O_WRONLY | O_CREAT | O_TRUNC | O_BINARY, 0666)) < 0)
+  {
+    perror("Unable to create temp4.xml");
+    return (1);
+  }
+
+  if (!mxmlSaveFd(tree, options, fd))
+  {
+    fputs("ERROR: Unable to save payloads to temp4.xml.\n", stderr);
+    return (1);
+  }
+
+  close(fd);
+
+  if ((fp = fopen("temp4.xml", "rb")) == NULL || fread(output, 1, strlen(saved) + 2, fp) != (strlen(saved) + 1) || strncmp(output, saved, strlen(saved)) || strcmp(output + strlen(saved), "\n"))
+  {
+    fputs("ERROR: Payloads saved to temp4.xml do not match the string save.\n", stderr);
+    return (1);
+  }
+
+  fclose(fp);
+  free(output);
+  free(saved);
+  mxmlOptionsDelete(options);
+  mxmlDelete(tree);
+
+#ifndef _WIN32
+  // Test that limiting the read size keeps the data after a failed load in a pipe...
+  options = mxmlOptionsNew();
+
+  for (i = 0; i < 2; i ++)
+  {
+    int	fds[2];				// Pipe
+
+    mxmlOptionsSetReadSize(options, i ? 1 : 0);
+
+    text = "<a><b></c></a><next/>";
+
+    if (pipe(fds) || write(fds[1], text, strlen(text)) != (ssize_t)strlen(text))
+    {
+      perror("Unable to write pipe");
+      return (1);
+    }
+
+    close(fds[1]);
+
+    if ((tree = mxmlLoadFd(/*top*/NULL, options, fds[0])) != NULL)
+    {
+      fputs("ERROR: Loaded mismatched close tag from a pipe.\n", stderr);
+      return (1);
+    }
+
+    count = (int)read(fds[0], buffer, sizeof(buffer) - 1);
+    buffer[count < 0 ? 0 : count] = '\0';
+    close(fds[0]);
+
+    if (strcmp(buffer, i ? "</a><next/>" : ""))
+    {
+      fprintf(stderr, "ERROR: Pipe with read size %d left \"%s\" after a failed load.\n", i, buffer);
+      return (1);
+    }
+  }
+
+  mxmlOptionsDelete(options);
+
+  // Debug hooks...
+  if (getenv("TEST_DELAY") != NULL)
+    sleep(atoi(getenv("TEST_DELAY")));
+
+#  ifdef __APPLE__
+  if (getenv("TEST_LEAKS") != NULL)
+  {
+    char command[1024];
+
+    snprintf(command, sizeof(command), "leaks %d", (int)getpid());
+    if (system(command))
+      puts("Unable to check for leaks.");
+  }
+#  endif // __APPLE__
+#endif // !_WIN32
+
+  // Return...
+  return (0);
+}
+
+
+//
+// 'read_cb()' - Read a few bytes at a time from a string.
+//
+
+size_t					// O - Number of bytes read
+read_cb(void   *cbdata,			// I - Pointer to string pointer
+        void   *buffer,			// I - Buffer
+        size_t bytes)			// I - Size of buffer
+{
+  const char	**s = (const char **)cbdata;
+					// String pointer
+  size_t	len = strlen(*s);	// Remaining bytes
+
+
+  if (len > 5)
+    len = 5;
+  if (len > bytes)
+    len = bytes;
+
+  memcpy(buffer, *s, len);
+  *s += len;
+
+  return (len);
+}
+
+
+//
+// 'record_cb()' - Check records in order, stopping at a record with a "stop" attribute.
+//
+
+bool					// O - `true` to continue, `false` to stop
+record_cb(void        *cbdata,		// I - Pointer to record count
+          mxml_node_t *record)		// I - Record element
+{
+  int		*count = (int *)cbdata;	// Record count
+  const char	*id = mxmlElementGetAttr(record, "id");
+					// Record ID
+
+
+  (*count) ++;
+
+  if (mxmlGetParent(record) || !id || atoi(id) != *count)
+  {
+    fprintf(stderr, "ERROR: Record %d has id=\"%s\" or a parent.\n", *count, id ? id : "(null)");
+    *count = -1000;
+    return (false);
+  }
+
+  if (*count == 3 && !mxmlFindElement(record, record, "rec", "id", "4", MXML_DESCEND_FIRST))
+  {
+    fputs("ERROR: Nested record missing from record 3.\n", stderr);
+    *count = -1000;
+    return (false);
+  }
+
+  return (mxmlElementGetAttr(record, "stop") == NULL);
+}
 
 
 //
@@ -671,6 +2104,32 @@ sax_cb(void             *cbdata,	// I - SAX callback data (not used)
 }
 
 
+//
+// 'sax_keep_cb()' - Keep nodes via SAX, except for <skip> elements.
+//
+
+bool					// O - `true` to continue, `false` to stop
+sax_keep_cb(void             *cbdata,	// I - SAX callback data (not used)
+            mxml_node_t      *node,	// I - Current node
+            mxml_sax_event_t event)	// I - SAX event
+{
+  mxml_node_t	*parent = mxmlGetParent(node);
+					// Parent node
+
+
+  (void)cbdata;
+
+  if (event == MXML_SAX_EVENT_DIRECTIVE)
+    mxmlRetain(node);
+  else if (event == MXML_SAX_EVENT_ELEMENT_OPEN && strcmp(mxmlGetElement(node), "skip") && (!parent || mxmlGetRefCount(parent) > 1))
+    mxmlRetain(node);
+  else if (event == MXML_SAX_EVENT_DATA && mxmlGetRefCount(parent) > 1)
+    mxmlRetain(node);
+
+  return (true);
+}
+
+
 //
 // 'type_cb()' - XML data type callback for mxmlLoadFile()...
 //
@@ -702,6 +2161,75 @@ type_cb(void        *cbdata,		// I - Callback data
 }
 
 
+//
+// 'utf16_copy()' - Convert a UTF-8 string to UTF-16 with a byte order mark.
+//
+
+char *					// O - UTF-16 data or `NULL` on error
+utf16_copy(const char *s,		// I - UTF-8 string
+           bool       big_endian,	// I - Big-endian byte order?
+           size_t     *bytes)		// O - Number of bytes
+{
+  const unsigned char	*ptr;		// Pointer into string
+  unsigned char		*data,		// UTF-16 data
+			*dataptr;	// Pointer into data
+  unsigned		ch,		// Current character
+			units[2];	// UTF-16 code units
+  int			i,		// Looping var
+			count;		// Number of code units
+
+
+  if ((data = malloc(4 * strlen(s) + 2)) == NULL)
+    return (NULL);
+
+  // Start with a byte order mark, then convert each character...
+  for (ptr = (const unsigned char *)s, dataptr = data, ch = 0xfeff; ch;)
+  {
+    if (ch >= 0x10000)
+    {
+      units[0] = 0xd800 | ((ch - 0x10000) >> 10);
+      units[1] = 0xdc00 | ((ch - 0x10000) & 0x3ff);
+      count    = 2;
+    }
+    else
+    {
+      units[0] = ch;
+      count    = 1;
+    }
+
+    for (i = 0; i < count; i ++)
+    {
+      *dataptr++ = (unsigned char)(big_endian ? units[i] >> 8 : units[i]);
+      *dataptr++ = (unsigned char)(big_endian ? units[i] : units[i] >> 8);
+    }
+
+    if ((ch = *ptr++) < 0x80)
+    {
+      // ASCII or nul...
+    }
+    else if ((ch & 0xe0) == 0xc0)
+    {
+      ch  = ((ch & 0x1f) << 6) | (ptr[0] & 0x3f);
+      ptr += 1;
+    }
+    else if ((ch & 0xf0) == 0xe0)
+    {
+      ch  = ((ch & 0x0f) << 12) | ((ptr[0] & 0x3f) << 6) | (ptr[1] & 0x3f);
+      ptr += 2;
+    }
+    else
+    {
+      ch  = ((ch & 0x07) << 18) | ((ptr[0] & 0x3f) << 12) | ((ptr[1] & 0x3f) << 6) | (ptr[2] & 0x3f);
+      ptr += 3;
+    }
+  }
+
+  *bytes = (size_t)(dataptr - data);
+
+  return ((char *)data);
+}
+
+
 //
 // 'whitespace_cb()' - Let the mxmlSaveFile() function know when to insert
 //                     newlines and tabs...
@@ -771,3 +2299,28 @@ whitespace_cb(void        *cbdata,	// I - Callback data
   // Return NULL for no added whitespace...
   return (NULL);
 }
+
+
+//
+// 'write_cb()' - Write at most 7 bytes at a time to a string.
+//
+
+size_t					// O - Number of bytes written or `0` on error
+write_cb(void   *cbdata,		// I - Pointer to string pointer or `NULL` to fail
+         void   *buffer,		// I - Buffer
+         size_t bytes)			// I - Number of bytes to write
+{
+  char	**s = (char **)cbdata;		// String pointer
+
+
+  if (!*s)
+    return (0);
+
+  if (bytes > 7)
+    bytes = 7;
+
+  memcpy(*s, buffer, bytes);
+  *s += bytes;
+
+  return (bytes);
+}
@@ -81,4 +81,11 @@
 //#  undef HAVE_PTHREAD_H
 
 
+//
+// Have <sys/mman.h>?
+//
+
+//#  undef HAVE_SYS_MMAN_H
+
+
 #endif // !MXML_CONFIG_H
@@ -46,4 +46,11 @@
 #  define HAVE_PTHREAD_H
 
 
+//
+// Have <sys/mman.h>?
+//
+
+#  define HAVE_SYS_MMAN_H 1
+
+
 #endif // !MXML_CONFIG_H